@@ -7,8 +7,8 @@ using namespace std;
 namespace flopoco
 {
 
-	Bit::Bit(BitHeap *bitheap_, string rhsAssignment_, int weight_, BitType type_) :
-		weight(weight_), type(type_), bitheap(bitheap_), colorCount(0), rhsAssignment(rhsAssignment_)
+	Bit::Bit(BitHeap *bitheap_, string rhsAssignment, int weight_, BitType type_) :
+		weight(weight_), type(type_), bitheap(bitheap_), colorCount(0)
 	{
 		std::ostringstream p;
 
@@ -23,6 +23,7 @@ namespace flopoco
 		
 		compressor = nullptr;
 
+		id = bitheap->storeBit(this, rhsAssignment);
 	}
 
 
@@ -36,8 +37,8 @@ namespace flopoco
 		string name = p.str();
 
 		p.str("");
-		p << signal->getName() << (signal->width()==1 ? "" : of(offset_));
-		rhsAssignment = p.str();
+		p << signal_->getName() << (signal_->width()==1 ? "" : of(offset_));
+		string rhsAssignment = p.str();
 
 		bitheap->getOp()->vhdl << tab
 			 << bitheap->getOp()->declare(name)
@@ -46,6 +47,8 @@ namespace flopoco
 		signal = bitheap->getOp()->getSignalByName(name);
 		
 		compressor = nullptr;
+
+		id = bitheap->storeBit(this, rhsAssignment);
 	}
 
 
@@ -54,7 +57,7 @@ namespace flopoco
 
 		weight = bit-> weight;
 		type = bit->type;
-		rhsAssignment = bit->rhsAssignment;
+		string rhsAssignment = bit->getRhsAssignment();
 
 		bitheap = bit->bitheap;
 		compressor = bit->compressor;
@@ -70,6 +73,8 @@ namespace flopoco
 		signal = bitheap->getOp()->getSignalByName(name);
 
 		colorCount = 0;
+
+		id = bitheap->storeBit(this, rhsAssignment);
 	}
 
 
@@ -83,8 +88,7 @@ namespace flopoco
 		signal = nullptr;
 
 		uid = -1;
-
-		rhsAssignment = "";
+		id = -1;
 
 		colorCount = 0;
 	}
@@ -102,8 +106,7 @@ namespace flopoco
 		newBit->signal = signal;
 
 		newBit->uid = uid;
-
-		newBit->rhsAssignment = rhsAssignment;
+		newBit->id = id;
 
 		newBit->colorCount = colorCount;
 
@@ -134,9 +137,17 @@ namespace flopoco
 	}
 
 
+	int Bit::getId()
+	{
+		return id;
+	}
+
+
 	string Bit::getRhsAssignment()
 	{
-		return rhsAssignment;
+		if(bitheap == nullptr || id < 0)
+			return "";
+		return bitheap->getRhsAssignment(id);
 	}
 
 
@@ -94,6 +94,11 @@ class BitHeap;
 		 */
 		int getUid();
 
+		/**
+		 * @brief Return the id of this bit in the bit store of its bitheap
+		 */
+		int getId();
+
 		/**
 		 * @brief Set the compressor that compressed this bit
 		 */
@@ -110,7 +115,7 @@ class BitHeap;
 		Compressor* getCompressor();
 
 		/**
-		 * @brief return the rhsAssignment
+		 * @brief return the rhsAssignment, rebuilt from the bit store of the bitheap
 		 */
 		string getRhsAssignment();
 
@@ -126,9 +131,9 @@ class BitHeap;
 
 	private:
 		int uid;
+		int id;                                     /**< The index of this bit in the bit store of the bitheap, which holds its rhsAssignment */
 
-		string rhsAssignment;
-
+		friend class BitHeap;
 	};
 
 }
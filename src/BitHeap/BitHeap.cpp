@@ -1,6 +1,7 @@
 
 #include "BitHeap.hpp"
 #include "BitHeap/FirstFittingCompressionStrategy.hpp"
+#include "BitHeap/TimingDrivenCompressionStrategy.hpp"
 #include "BitHeap/ParandehAfsharCompressionStrategy.hpp"
 #include "BitHeap/MaxEfficiencyCompressionStrategy.hpp"
 #include "BitHeap/OptimalCompressionStrategy.hpp"
@@ -39,11 +40,7 @@ namespace flopoco {
 		}
 		bits.clear();
 
-		for(unsigned i=0; i<bits.size(); i++)
-		{
-			history[i].clear();
-		}
-		history.clear();
+		storedBits.clear();
 	}
 
 
@@ -63,9 +60,8 @@ namespace flopoco {
 		for(unsigned i=0; i<width; i++)
 		{
 			bitUID.push_back(0);
-			vector<Bit*> t, t2;
+			vector<Bit*> t;
 			bits.push_back(t);
-			history.push_back(t2);
 		}
 
 		//initialize the constant bits
@@ -134,8 +130,24 @@ namespace flopoco {
 
 
 	void BitHeap::sortBitsInColumns(){
+		// Read the timing of each bit once, instead of twice per comparison
+		for(unsigned int c = 0; c < bits.size(); c++){
+			for(auto bit: bits[c]){
+				storedTiming[bit->id] = make_pair(bit->signal->getCycle(), bit->signal->getCriticalPath());
+			}
+		}
+		// Sort on the same key as lexicographicOrdering(): the comparisons are the same, so is the resulting order
+		vector<pair<int, Bit*> > column;
 		for(unsigned int c = 0; c < bits.size(); c++){
-			std::sort(bits[c].begin(), bits[c].end(), lexicographicOrdering);
+			column.clear();
+			for(auto bit: bits[c]){
+				column.push_back(make_pair(storedTiming[bit->id].first, bit));
+			}
+			std::sort(column.begin(), column.end(),
+								[](const pair<int, Bit*>& b1, const pair<int, Bit*>& b2) { return b1.first < b2.first; });
+			for(unsigned int i = 0; i < column.size(); i++){
+				bits[c][i] = column[i].second;
+			}
 		}
 	}
 
@@ -155,6 +167,8 @@ namespace flopoco {
 		vector<Bit*>::iterator it = bits[columnNumber].begin();
 		bool inserted = false;
 
+		storedColumn[bit->id] = columnNumber;
+
 		//if the column is empty, then just insert the bit
 		if(bits[columnNumber].size() == 0)
 		{
@@ -286,20 +300,16 @@ namespace flopoco {
 	{
 		for(unsigned i=0; i<width; i++)
 		{
-			vector<Bit*>::iterator it = bits[i].begin(), lastIt = it;
-
-			//search for the bits marked as compressed and erase them
-			while(it != bits[i].end())
+			//erase the bits marked as compressed, keeping the order of the others
+			unsigned kept = 0;
+			for(unsigned j=0; j<bits[i].size(); j++)
 			{
-				if((*it)->type == BitType::compressed)
-				{
-					bits[i].erase(it);
-					it = lastIt;
-				}else{
-					lastIt = it;
-					it++;
-				}
+				if(bits[i][j]->type == BitType::compressed)
+					storedColumn[bits[i][j]->id] = -1;
+				else
+					bits[i][kept++] = bits[i][j];
 			}
+			bits[i].resize(kept);
 		}
 	}
 
@@ -319,28 +329,13 @@ namespace flopoco {
 
 	void BitHeap::markBit(Bit* bit, BitType type)
 	{
-		bool bitFound = false;
-
-		for(unsigned i=0; i<=width; i++)
-		{
-			vector<Bit*>::iterator it = bits[i].begin();
-
-			//search for the bit
-			while(it != bits[i].end())
-			{
-				if(((*it)->getName() == bit->getName()) && ((*it)->getUid() == bit->getUid()))
-				{
-					(*it)->type = type;
-					bitFound = true;
-					return;
-				}else{
-					it++;
-				}
-			}
-		}
-		if(bitFound == false)
+		//the bit may be a clone: mark the one of the bit store
+		if((bit->bitheap != this) || (bit->id < 0) || (bit->id >= (int)storedBits.size())
+				|| (storedColumn[bit->id] < 0))
 			THROWERROR("Bit=" << bit->getName() << " with uid="
 					<< bit->getUid() << " not found in bitheap");
+
+		storedBits[bit->id]->type = type;
 	}
 
 
@@ -390,14 +385,16 @@ namespace flopoco {
 		else
 			startIndex = weight - lsb;
 
-		for(int i=startIndex; (unsigned)i<bits.size(); i++)
+		//the bits of the signal are those that share its interned name
+		map<string,int>::iterator it = rhsNameIds.find(signal->getName());
+		if(it == rhsNameIds.end())
+			return;
+		for(auto range: rhsNameRanges[it->second])
 		{
-			for(unsigned int j=0; j<bits[i].size(); j++)
+			for(int id=range.first; id<=range.second; id++)
 			{
-				if(bits[i][j]->getRhsAssignment().find(signal->getName()) != string::npos)
-				{
-					bits[i][j]->type = type;
-				}
+				if(storedColumn[id] >= startIndex)
+					storedBits[id]->type = type;
 			}
 		}
 	}
@@ -617,13 +614,11 @@ namespace flopoco {
 			{
 				//remove lsb columns
 				bits.erase(bits.begin(), bits.begin()+(width-newWidth));
-				history.erase(history.begin(), history.begin()+(width-newWidth));
 				bitUID.erase(bitUID.begin(), bitUID.begin()+(width-newWidth));
 				lsb += width-newWidth;
 			}else{
 				//remove msb columns
 				bits.resize(newWidth);
-				history.resize(newWidth);
 				bitUID.resize(newWidth);
 				msb -= width-newWidth;
 			}
@@ -634,13 +629,11 @@ namespace flopoco {
 				//add lsb columns
 				vector<Bit*> newVal;
 				bits.insert(bits.begin(), newWidth-width, newVal);
-				history.insert(history.begin(), newWidth-width, newVal);
 				bitUID.insert(bitUID.begin(), newWidth-width, 0);
 				lsb -= width-newWidth;
 			}else{
 				//add msb columns
 				bits.resize(newWidth-width);
-				history.resize(newWidth-width);
 				bitUID.resize(newWidth-width);
 				msb += width-newWidth;
 			}
@@ -649,9 +642,13 @@ namespace flopoco {
 		//update the information inside the bitheap
 		width = newWidth;
 		height = getMaxHeight();
+		for(unsigned id=0; id<storedColumn.size(); id++)
+			storedColumn[id] = -1;
 		for(int i=lsb; i<=msb; i++)
-			for(unsigned j=0; j<bits[i-lsb].size(); j++)
+			for(unsigned j=0; j<bits[i-lsb].size(); j++) {
 				bits[i-lsb][j]->weight = i;
+				storedColumn[bits[i-lsb][j]->id] = i-lsb;
+			}
 
 		isCompressed = false;
 	}
@@ -699,8 +696,14 @@ namespace flopoco {
 		}
 		//add the bits
 		for(int i=bitheap->lsb; i<bitheap->msb; i++) {
-			for(unsigned j=0; j<bitheap->bits[i-bitheap->lsb].size(); j++)
-				insertBitInColumn(bitheap->bits[i-bitheap->lsb][j], i-bitheap->lsb + (lsb-bitheap->lsb));
+			for(unsigned j=0; j<bitheap->bits[i-bitheap->lsb].size(); j++) {
+				//move the bit to the bit store of this bitheap
+				Bit* bit = bitheap->bits[i-bitheap->lsb][j];
+				string rhsAssignment = bit->getRhsAssignment();
+				bit->bitheap = this;
+				bit->id = storeBit(bit, rhsAssignment);
+				insertBitInColumn(bit, i-bitheap->lsb + (lsb-bitheap->lsb));
+			}
 		}
 		//make the bit all point to this bitheap
 		for(unsigned i=0; i<width; i++)
@@ -763,6 +766,10 @@ namespace flopoco {
 		{
 			compressionStrategy = new FirstFittingCompressionStrategy(this);
 		}
+		else if(op->getTarget()->getCompressionMethod().compare("heuristicTimingDriven") == 0)
+		{
+			compressionStrategy = new TimingDrivenCompressionStrategy(this);
+		}
 		else if(op->getTarget()->getCompressionMethod().compare("optimal") == 0)
 		{
 			compressionStrategy = new OptimalCompressionStrategy(this,false);
@@ -883,6 +890,80 @@ namespace flopoco {
 	}
 
 
+	/* The rhsAssignment of a bit from its decomposition in the bit store */
+	static string rhsString(bool negated, const string& name, int index)
+	{
+		return (negated ? "not " : "") + name + (index >= 0 ? of(index) : "");
+	}
+
+
+	int BitHeap::storeBit(Bit* bit, string rhsAssignment)
+	{
+		int id = storedBits.size();
+
+		//split the rhsAssignment into [not ]name[(index)]
+		bool negated = false;
+		string name = rhsAssignment;
+		int index = -1;
+		if(name.compare(0, 4, "not ") == 0)
+		{
+			negated = true;
+			name = name.substr(4);
+		}
+		size_t open = name.rfind('(');
+		if((open != string::npos) && (open > 0) && (name.back() == ')'))
+		{
+			string digits = name.substr(open+1, name.size()-open-2);
+			if((digits.size() > 0) && (digits.size() < 9)
+					&& std::all_of(digits.begin(), digits.end(), [](char c) { return isdigit(c); }))
+			{
+				index = stoi(digits);
+				name = name.substr(0, open);
+			}
+		}
+		//anything that doesn't come back identical (leading zeros, etc) is kept as a whole
+		if(rhsString(negated, name, index) != rhsAssignment)
+		{
+			negated = false;
+			name = rhsAssignment;
+			index = -1;
+		}
+
+		//intern the name, and extend the range of its bits
+		int nameId;
+		map<string,int>::iterator it = rhsNameIds.find(name);
+		if(it == rhsNameIds.end())
+		{
+			nameId = rhsNames.size();
+			rhsNames.push_back(name);
+			rhsNameIds[name] = nameId;
+			rhsNameRanges.push_back(vector<pair<int,int> >());
+		}else{
+			nameId = it->second;
+		}
+		vector<pair<int,int> >& ranges = rhsNameRanges[nameId];
+		if(!ranges.empty() && (ranges.back().second == id-1))
+			ranges.back().second = id;
+		else
+			ranges.push_back(make_pair(id, id));
+
+		storedBits.push_back(bit);
+		storedColumn.push_back(-1);
+		storedRhsName.push_back(nameId);
+		storedRhsIndex.push_back(index);
+		storedRhsNegated.push_back(negated);
+		storedTiming.push_back(make_pair(0, 0.0));
+
+		return id;
+	}
+
+
+	string BitHeap::getRhsAssignment(int id)
+	{
+		return rhsString(storedRhsNegated[id], rhsNames[storedRhsName[id]], storedRhsIndex[id]);
+	}
+
+
 	void BitHeap::printColumnInfo(int weight)
 	{
 		if((weight < lsb) || (weight > msb))
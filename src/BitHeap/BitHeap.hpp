@@ -16,6 +16,7 @@
 
 
 #include <vector>
+#include <map>
 #include <sstream>
 
 #include "Operator.hpp"
@@ -51,6 +52,7 @@ enum BitType : unsigned;
 		//the compression strategy needs access to the bitheap
 		friend class CompressionStrategy;
 		friend class FirstFittingCompressionStrategy;
+		friend class TimingDrivenCompressionStrategy;
 		friend class ParandehAfsharCompressionStrategy;
 		friend class MaxEfficiencyCompressionStrategy;
 		friend class OptimalCompressionStrategy;
@@ -345,6 +347,20 @@ enum BitType : unsigned;
 		 */
 		int newBitUid(unsigned position);
 
+		/**
+		 * @brief add a bit to the bit store (called by the constructors of Bit)
+		 * @param bit the bit
+		 * @param rhsAssignment the code on the right-hand side of the assignment creating this bit
+		 * @return the id of the bit in the bit store
+		 */
+		int storeBit(Bit* bit, string rhsAssignment);
+
+		/**
+		 * @brief return the rhsAssignment of a bit, rebuilt from the bit store
+		 * @param id the id of the bit in the bit store
+		 */
+		string getRhsAssignment(int id);
+
 		/**
 		 * @brief print the informations regarding a column
 		 * @param position the position of the column
@@ -418,7 +434,19 @@ enum BitType : unsigned;
 
 		vector<vector<Bit*> > bits;                 /**< The bits currently contained in the bitheap, ordered into columns by position in the bitheap,
 		                                                 and by arrival time of the bits, i.e. lexicographic order on (cycle, cp), inside each column. */
-		vector<vector<Bit*> > history;              /**< All the bits that have been added (and possibly removed at some point) to the bitheap. */
+
+		// The bit store, a structure of arrays indexed by the id of the bits.
+		// The rhsAssignment of a bit is split into [not ]name[(index)], with interned names:
+		// the bits of a signal share one name, and their ids form a range (usually a single one).
+		vector<Bit*> storedBits;                    /**< All the bits that have been added (and possibly removed at some point) to the bitheap. */
+		vector<int> storedColumn;                   /**< The column of each bit, or -1 if it is not in the bitheap (any longer) */
+		vector<int> storedRhsName;                  /**< The interned name of the rhsAssignment of each bit */
+		vector<int> storedRhsIndex;                 /**< The index of each bit in this name, or -1 if the rhsAssignment is the name itself */
+		vector<bool> storedRhsNegated;              /**< True if the rhsAssignment of the bit is "not " followed by the name */
+		vector<pair<int,double> > storedTiming;     /**< The (cycle, critical path) of each bit, read from its signal by sortBitsInColumns() */
+		vector<string> rhsNames;                    /**< The interned names */
+		map<string,int> rhsNameIds;                 /**< The index of each name in rhsNames */
+		vector<vector<pair<int,int> > > rhsNameRanges; /**< For each interned name, the ranges [first, last] of the ids of the bits that use it */
 		mpz_class constantBits;						/**< The sum of all the constant bits that need to be added to the bit heap
 				                                                 (constants added to the bitheap, for rounding, two's complement etc) */
 
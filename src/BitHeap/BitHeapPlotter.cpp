@@ -101,6 +101,10 @@ namespace flopoco
 
 	void BitheapPlotter::takeSnapshot(Bit *soonestBit, Bit *soonestCompressibleBit)
 	{
+		//a snapshot clones all the bits of the bitheap: only take it if it may be drawn
+		if(!bitheap->getOp()->getTarget()->generateFigures())
+			return;
+
 		BitheapPlotter::Snapshot* s = new BitheapPlotter::Snapshot(bitheap->getBits(),
 											bitheap->getMaxHeight(), soonestBit, soonestCompressibleBit);
 
@@ -0,0 +1,332 @@
+#include "CompressionBranchAndBound.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+using namespace std;
+
+namespace flopoco{
+
+
+	CompressionBranchAndBound::CompressionBranchAndBound(vector<vector<int> > bitAmount_, vector<BasicCompressor*> compressors_, BasicCompressor* flipflop_) :
+		bitAmount(bitAmount_), flipflop(flipflop_), lastStage(0), exactStages(false),
+		best(numeric_limits<double>::infinity()), bestArea(numeric_limits<double>::infinity()), bestFinalStage(0), found(false), complete(false),
+		stop(false), hasDeadline(false)
+	{
+		columns = (bitAmount.size() > 0 ? bitAmount[0].size() : 0);
+		lastArrival = 0;
+		for(unsigned int s = 0; s < bitAmount.size(); s++){
+			for(unsigned int c = 0; c < bitAmount[s].size(); c++){
+				if(bitAmount[s][c] > 0){
+					lastArrival = s;
+				}
+			}
+		}
+
+		vector<vector<int> > in, out;
+		vector<BasicCompressor*> candidates;
+		for(auto bc : compressors_){
+			if(bc->type.compare("variable") == 0 || bc->getHeights() == 0 || bc->getHeightsAtColumn(0) == 0){
+				continue;
+			}
+			vector<int> i, o;
+			for(unsigned int j = 0; j < bc->getHeights(); j++){
+				i.push_back(bc->getHeightsAtColumn(j));
+			}
+			for(unsigned int j = 0; j < bc->getOutHeights(); j++){
+				o.push_back(bc->getOutHeightsAtColumn(j));
+			}
+			candidates.push_back(bc);
+			in.push_back(i);
+			out.push_back(o);
+		}
+
+		//a compressor is dominated by another one with at least its inputs, at most its outputs, and at most its area in every column
+		auto at = [](vector<int> &v, unsigned int j) { return (j < v.size() ? v[j] : 0); };
+		minAreaPerInput = numeric_limits<double>::infinity();
+		for(unsigned int a = 0; a < candidates.size(); a++){
+			bool dominated = false;
+			for(unsigned int b = 0; b < candidates.size() && !dominated; b++){
+				if(b == a || candidates[b]->area > candidates[a]->area){
+					continue;
+				}
+				bool noWorse = true, better = (candidates[b]->area < candidates[a]->area);
+				unsigned int width = std::max(std::max(in[a].size(), in[b].size()), std::max(out[a].size(), out[b].size()));
+				for(unsigned int j = 0; j < width && noWorse; j++){
+					noWorse = (at(in[b], j) >= at(in[a], j) && at(out[b], j) <= at(out[a], j));
+					better = better || at(in[b], j) > at(in[a], j) || at(out[b], j) < at(out[a], j);
+				}
+				dominated = noWorse && (better || b < a);
+			}
+			if(!dominated){
+				compressors.push_back(candidates[a]);
+				inputs.push_back(in[a]);
+				outputs.push_back(out[a]);
+				int inputCount = 0;
+				for(int i : in[a]){
+					inputCount += i;
+				}
+				minAreaPerInput = std::min(minAreaPerInput, (double)candidates[a]->area / inputCount);
+			}
+		}
+	}
+
+
+
+	int CompressionBranchAndBound::arrivals(unsigned int stage, unsigned int column){
+		return (stage < bitAmount.size() ? bitAmount[stage][column] : 0);
+	}
+
+
+	bool CompressionBranchAndBound::canBeFinal(unsigned int stage, vector<int> &bits){
+		if(lastArrival > stage){
+			return false;
+		}
+		for(unsigned int c = 0; c < columns; c++){
+			if(bits[c] > 2){
+				return false;
+			}
+		}
+		return true;
+	}
+
+
+	bool CompressionBranchAndBound::normalize(Node &node){
+		while(true){
+			while(node.column < columns && node.demand[node.column] <= 0){
+				//no compressor placed from now on has an output in this column of the next stage
+				if(node.stage + 1 == lastStage && node.next[node.column] > 2){
+					return false;
+				}
+				node.column++;
+				node.first = 0;
+			}
+			if(node.column < columns){
+				return true;
+			}
+			unsigned int s = node.stage + 1;
+			if(canBeFinal(s, node.next) && (!exactStages || s == lastStage)){
+				offer(node, s);
+				return false;
+			}
+			if(s >= lastStage){
+				return false;
+			}
+			node.stage = s;
+			node.demand = node.next;
+			for(unsigned int c = 0; c < columns; c++){
+				node.next[c] = arrivals(s + 1, c);
+			}
+			node.column = 0;
+			node.first = 0;
+		}
+	}
+
+
+	double CompressionBranchAndBound::bound(Node &node){
+		double bits = 0.0;
+		for(unsigned int c = node.column; c < columns; c++){
+			bits += std::max(node.demand[c], 0);
+		}
+		bool nextIsCompressed;
+		if(exactStages){
+			nextIsCompressed = (node.stage + 1 < lastStage);
+		}
+		else{
+			nextIsCompressed = !canBeFinal(node.stage + 1, node.next);
+		}
+		if(nextIsCompressed){
+			for(unsigned int c = 0; c < columns; c++){
+				bits += node.next[c];
+			}
+		}
+		return node.area + bits * minAreaPerInput;
+	}
+
+
+	void CompressionBranchAndBound::place(Node &node, unsigned int e){
+		for(unsigned int j = 0; j < inputs[e].size() && node.column + j < columns; j++){
+			node.demand[node.column + j] -= inputs[e][j];
+		}
+		for(unsigned int j = 0; j < outputs[e].size() && node.column + j < columns; j++){
+			node.next[node.column + j] += outputs[e][j];
+		}
+		node.area += compressors[e]->area;
+		node.first = e;
+		node.placed.push_back(node.stage);
+		node.placed.push_back(node.column);
+		node.placed.push_back(e);
+	}
+
+
+	void CompressionBranchAndBound::offer(Node &node, unsigned int finalStage){
+		std::lock_guard<std::mutex> lock(bestMutex);
+		if(!found || node.area < bestArea - 1e-9){
+			bestArea = node.area;
+			bestPlaced = node.placed;
+			bestFinalStage = finalStage;
+			found = true;
+			best.store(node.area);
+		}
+	}
+
+
+	bool CompressionBranchAndBound::timeIsUp(){
+		if(stop.load()){
+			return true;
+		}
+		if(hasDeadline && std::chrono::steady_clock::now() > deadline){
+			stop.store(true);
+			return true;
+		}
+		return false;
+	}
+
+
+	void CompressionBranchAndBound::search(Node &node, unsigned long &nodes){
+		if((++nodes & 0x3ff) == 0 && timeIsUp()){
+			return;
+		}
+		if(stop.load(std::memory_order_relaxed) || !normalize(node) || bound(node) >= best.load() - 1e-9){
+			return;
+		}
+		//the compressors that waste no input first, for a good first solution
+		int demand = node.demand[node.column];
+		for(int wasteful = 0; wasteful < 2; wasteful++){
+			for(unsigned int e = node.first; e < compressors.size(); e++){
+				if((inputs[e][0] > demand) != (wasteful == 1)){
+					continue;
+				}
+				Node child = node;
+				place(child, e);
+				search(child, nodes);
+			}
+		}
+	}
+
+
+	void CompressionBranchAndBound::split(Node node, unsigned int depth, vector<Node> &nodes){
+		if(!normalize(node) || bound(node) >= best.load() - 1e-9){
+			return;
+		}
+		if(depth == 0){
+			nodes.push_back(node);
+			return;
+		}
+		int demand = node.demand[node.column];
+		for(int wasteful = 0; wasteful < 2; wasteful++){
+			for(unsigned int e = node.first; e < compressors.size(); e++){
+				if((inputs[e][0] > demand) != (wasteful == 1)){
+					continue;
+				}
+				Node child = node;
+				place(child, e);
+				split(child, depth - 1, nodes);
+			}
+		}
+	}
+
+
+
+	bool CompressionBranchAndBound::solve(unsigned int stages, bool exactStages_, int timeout){
+		lastStage = stages;
+		exactStages = exactStages_;
+		found = false;
+		bestArea = numeric_limits<double>::infinity();
+		best.store(bestArea);
+		bestPlaced.clear();
+		stop.store(false);
+		hasDeadline = (timeout > 0);
+		deadline = std::chrono::steady_clock::now() + std::chrono::seconds(timeout);
+
+		Node root;
+		root.stage = 0;
+		root.column = 0;
+		root.first = 0;
+		root.area = 0.0;
+		root.demand.resize(columns);
+		root.next.resize(columns);
+		for(unsigned int c = 0; c < columns; c++){
+			root.demand[c] = arrivals(0, c);
+			root.next[c] = arrivals(1, c);
+		}
+
+		if(canBeFinal(0, root.demand) && (!exactStages || lastStage == 0)){
+			offer(root, 0);
+		}
+		else if(lastStage > 0 && lastArrival <= lastStage && !compressors.empty()){
+			//expand the first levels until there are enough subtrees for the threads
+			unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+			vector<Node> nodes;
+			unsigned int depth = 0;
+			do{
+				depth++;
+				nodes.clear();
+				split(root, depth, nodes);
+			} while(threads > 1 && nodes.size() > 0 && nodes.size() < 8 * threads && depth < 8);
+
+			std::atomic<size_t> next(0);
+			auto worker = [this, &nodes, &next]() {
+				unsigned long searched = 0;
+				for(size_t i = next++; i < nodes.size() && !stop.load(); i = next++){
+					search(nodes[i], searched);
+				}
+			};
+			threads = std::min<size_t>(threads, nodes.size());
+			if(threads <= 1){
+				worker();
+			}
+			else{
+				vector<std::thread> pool;
+				for(unsigned int t = 0; t < threads; t++){
+					pool.push_back(std::thread(worker));
+				}
+				for(auto &t : pool){
+					t.join();
+				}
+			}
+		}
+
+		complete = !stop.load();
+		return found;
+	}
+
+
+
+	void CompressionBranchAndBound::fillSolution(BitHeapSolution &solution){
+		unsigned int stages = std::max((unsigned int)bitAmount.size(), lastStage + 1);
+		vector<vector<int> > covered(stages, vector<int>(columns, 0));
+		vector<vector<int> > bits(stages, vector<int>(columns, 0));
+		for(unsigned int s = 0; s < stages; s++){
+			for(unsigned int c = 0; c < columns; c++){
+				bits[s][c] = arrivals(s, c);
+			}
+		}
+
+		for(unsigned int i = 0; i < bestPlaced.size(); i += 3){
+			unsigned int s = bestPlaced[i], c = bestPlaced[i + 1], e = bestPlaced[i + 2];
+			for(unsigned int j = 0; j < inputs[e].size() && c + j < columns; j++){
+				covered[s][c + j] += inputs[e][j];
+			}
+			for(unsigned int j = 0; j < outputs[e].size() && c + j < columns; j++){
+				bits[s + 1][c + j] += outputs[e][j];
+			}
+			if(compressors[e] != flipflop){
+				solution.addCompressor(s, c, compressors[e]);
+			}
+		}
+
+		//the empty inputs are negative, and there are none from the final stage on
+		for(unsigned int s = 0; s < stages; s++){
+			vector<int> emptyInputs(columns, 0);
+			if(s < bestFinalStage){
+				for(unsigned int c = 0; c < columns; c++){
+					emptyInputs[c] = bits[s][c] - covered[s][c];
+				}
+			}
+			solution.setEmptyInputsByRemainingBits(s, emptyInputs);
+		}
+	}
+
+}
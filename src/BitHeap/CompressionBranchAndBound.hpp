@@ -0,0 +1,111 @@
+#ifndef COMPRESSIONBRANCHANDBOUND_HPP
+#define COMPRESSIONBRANCHANDBOUND_HPP
+
+#include <atomic>
+#include <mutex>
+#include <chrono>
+
+#include "BitHeap/Compressor.hpp"
+#include "BitHeap/BitHeapSolution.hpp"
+
+namespace flopoco
+{
+
+	/**
+	 * An exact solver for the compressor placement problem of OptimalCompressionStrategy, used when FloPoCo is built without ScaLP.
+	 *
+	 * The problem is the one of the ILP formulation: place compressors of minimal total area such that,
+	 * in each stage before the final one, every bit (new or output by the previous stage) enters a compressor, possibly a flipflop,
+	 * and the final stage has at most two bits per column and no bit arrives after it.
+	 *
+	 * It is a depth-first branch and bound, stage by stage and, in each stage, from the least significant column:
+	 * the compressors whose least significant input is in the current column are added while this column has bits not yet covered.
+	 * - The compressors added to a column are enumerated in increasing index order (as a multiset, not as a sequence).
+	 * - A compressor that has no more inputs, no fewer outputs, and no smaller area than another one in every column is discarded beforehand.
+	 * - The bound adds to the current area the bits of the stage that remain to be covered, and the bits of the next stage if it cannot be the final one,
+	 *   times the lowest area per input of the compressors.
+	 * - The first solution is the one of a greedy descent (the compressors with the best efficiency that waste no input first), and is the initial incumbent.
+	 * - The subtrees below the first decisions are searched by all the hardware threads, which share the incumbent.
+	 */
+	class CompressionBranchAndBound
+	{
+	public:
+		/**
+		 * @param bitAmount the number of bits arriving in each stage and column, as in CompressionStrategy
+		 * @param compressors the compressors that can be placed (the flipflop included)
+		 * @param flipflop the flipflop among the compressors, which is not placed in the solution: its bit just stays in the bit heap
+		 */
+		CompressionBranchAndBound(vector<vector<int> > bitAmount, vector<BasicCompressor*> compressors, BasicCompressor* flipflop);
+
+		/**
+		 * @brief runs the search
+		 * @param stages the last stage that may be the final one (the bits then are in stages 0 to stages)
+		 * @param exactStages if true, stages must be the final stage, as with OptimalCompressionStrategy::selectOutputStage()
+		 * @param timeout in seconds, 0 for no timeout (as Target::getILPTimeout())
+		 * @return true if a solution was found
+		 */
+		bool solve(unsigned int stages, bool exactStages, int timeout);
+
+		/**
+		 * @brief true if the search completed: the solution found is optimal, or there is no solution
+		 */
+		bool isComplete() { return complete; }
+
+		/**
+		 * @brief the area of the solution found
+		 */
+		double getArea() { return bestArea; }
+
+		/**
+		 * @brief adds the compressors and the empty inputs of the solution found to solution
+		 */
+		void fillSolution(BitHeapSolution &solution);
+
+	private:
+		/** the state of a partial compressor tree, copied at each node */
+		struct Node {
+			unsigned int stage;
+			unsigned int column;
+			unsigned int first;				/**< the lowest index of the compressors that may still be added to this column */
+			vector<int> demand;				/**< the bits of the current stage not yet covered (negative: empty inputs) */
+			vector<int> next;				/**< the bits of the next stage so far */
+			double area;
+			vector<unsigned int> placed;	/**< the compressors placed, as triples (stage, column, compressor) */
+		};
+
+		int arrivals(unsigned int stage, unsigned int column);
+		bool canBeFinal(unsigned int stage, vector<int> &bits);
+		bool normalize(Node &node);
+		double bound(Node &node);
+		void place(Node &node, unsigned int e);
+		void offer(Node &node, unsigned int finalStage);
+		void search(Node &node, unsigned long &nodes);
+		void split(Node node, unsigned int depth, vector<Node> &nodes);
+		bool timeIsUp();
+
+		vector<vector<int> > bitAmount;
+		vector<BasicCompressor*> compressors;	/**< the undominated compressors, by decreasing efficiency */
+		vector<vector<int> > inputs;			/**< inputs[e][j]: the inputs of compressors[e] in its column j */
+		vector<vector<int> > outputs;			/**< outputs[e][j]: the outputs of compressors[e] in its column j */
+		BasicCompressor* flipflop;
+		unsigned int columns;
+		unsigned int lastStage;
+		unsigned int lastArrival;				/**< the last stage in which bits arrive */
+		bool exactStages;
+		double minAreaPerInput;
+
+		std::mutex bestMutex;
+		std::atomic<double> best;				/**< area of the incumbent, read by all threads */
+		double bestArea;
+		vector<unsigned int> bestPlaced;
+		unsigned int bestFinalStage;
+		bool found;
+		bool complete;
+
+		std::atomic<bool> stop;
+		bool hasDeadline;
+		std::chrono::steady_clock::time_point deadline;
+	};
+
+}
+#endif
@@ -22,6 +22,7 @@ namespace flopoco{
 
 		//no chunks already compressed
 		compressionDoneIndex = 0;
+		registerReport = UserInterface::reportRegisters && UserInterface::pipelineActive_;
 
 		if(UserInterface::pipelineActive_) {
 			//the initial delay between the soonest bit and the rest of the bits
@@ -281,6 +282,60 @@ namespace flopoco{
 
 
 
+	void CompressionStrategy::reportRegisteredBits()
+	{
+		if(!registerReport || bitConsumers.size() == 0)
+			return;
+
+		map<int, int> registeredBits;
+		int totalRegisteredBits = countRegisteredBits(registeredBits);
+		int baseline = baselineRegisteredBits();
+
+		ostringstream report;
+		report << "Bitheap " << bitheap->name << ": " << totalRegisteredBits << " registered bits in the compressor tree";
+		if(baseline >= 0)
+			report << " (" << baseline << " without the register-aware cost)";
+		if(totalRegisteredBits > 0)
+		{
+			report << ", per cycle boundary:";
+			for(auto boundary: registeredBits)
+				report << " " << boundary.first << "->" << boundary.first+1 << ":" << boundary.second;
+		}
+		REPORT(DETAILED, report.str());
+		bitheap->getOp()->addToFinalReport(report.str());
+	}
+
+
+
+	int CompressionStrategy::countRegisteredBits(map<int, int> &registeredBits)
+	{
+		//compute the cycles of the compressor and final adder inputs
+		bitheap->op->schedule();
+
+		int totalRegisteredBits = 0;
+		for(auto consumer: bitConsumers)
+		{
+			//constant bits are not registered
+			if(consumer.first->type() == Signal::constant || consumer.first->type() == Signal::constantWithDeclaration)
+				continue;
+			for(int cycle = consumer.first->getCycle(); cycle < consumer.second->getCycle(); cycle++)
+			{
+				registeredBits[cycle]++;
+				totalRegisteredBits++;
+			}
+		}
+		return totalRegisteredBits;
+	}
+
+
+
+	int CompressionStrategy::baselineRegisteredBits()
+	{
+		return -1;
+	}
+
+
+
     void CompressionStrategy::applyAllCompressorsFromSolution(){
 		REPORT(DEBUG, "applying all compressors");
 
@@ -292,6 +347,12 @@ namespace flopoco{
 			Bit *soonestBit, *soonestCompressibleBit;
 			soonestBit = getSoonestBit(0, bitheap->width - 1);
 			soonestCompressibleBit = getSoonestCompressibleBit(0, bitheap->width-1, compressionDelay);
+			//with compressor arrays, the compressors of the stage and their input bits: the bits are taken from the current bitheap,
+			//	the outputs of the stage are only used by the next one
+			bool useArrays = bitheap->getOp()->getTarget()->useCompressorArrays();
+			vector<Compressor*> stageCompressors;
+			vector<vector<vector<Bit*> > > stageBits;
+			vector<int> stageColumns;
 			for(unsigned int c = 0; c < bitheap->width; c++){	//drop all compressors which start > MSB
 				vector<pair<BasicCompressor*, unsigned int> > tempVector;
 				tempVector = solution.getCompressorsAtPosition(s, c);
@@ -337,12 +398,64 @@ namespace flopoco{
 							}
 						}
 					}
-					applyCompressor(tempBitVector, realCompressor, c);
-					bitheap->op->schedule();
-					bitheap->sortBitsInColumns();
+					if(!useArrays){
+						applyCompressor(tempBitVector, realCompressor, c);
+						bitheap->op->schedule();
+						bitheap->sortBitsInColumns();
+						continue;
+					}
+					//these bits are not available to the next compressors of the stage
+					for(auto column: tempBitVector)
+						for(auto bit: column)
+							bitheap->markBit(bit, BitType::compressed);
+					stageCompressors.push_back(realCompressor);
+					stageBits.push_back(tempBitVector);
+					stageColumns.push_back(c);
 				}
 			}
 
+			if(useArrays){
+				//group the compressors by type and by the timing of their latest input (constants excluded, as by the scheduler),
+				//	which is the timing of their output
+				vector<vector<unsigned int> > groups;
+				map<pair<Compressor*, pair<int, double> >, unsigned int> groupOfKey;
+				for(unsigned int i = 0; i < stageCompressors.size(); i++){
+					pair<int, double> latest(-1, 0.0);
+					for(auto column: stageBits[i]){
+						for(auto bit: column){
+							if(bit->signal->type() == Signal::constant || bit->signal->type() == Signal::constantWithDeclaration){
+								continue;
+							}
+							latest = max(latest, make_pair(bit->signal->getCycle(), bit->signal->getCriticalPath()));
+						}
+					}
+					auto key = make_pair(stageCompressors[i], latest);
+					if(groupOfKey.count(key) == 0){
+						groupOfKey[key] = groups.size();
+						groups.push_back(vector<unsigned int>());
+					}
+					groups[groupOfKey[key]].push_back(i);
+				}
+
+				for(auto group: groups){
+					if(group.size() == 1){
+						applyCompressor(stageBits[group[0]], stageCompressors[group[0]], stageColumns[group[0]]);
+					}
+					else{
+						vector<vector<vector<Bit*> > > groupBits;
+						vector<int> groupColumns;
+						for(unsigned int i : group){
+							groupBits.push_back(stageBits[i]);
+							groupColumns.push_back(stageColumns[i]);
+						}
+						REPORT(DEBUG, "applying " << group.size() << " compressors " << stageCompressors[group[0]]->getName() << " as an array");
+						applyCompressorArray(groupBits, stageCompressors[group[0]], groupColumns);
+					}
+				}
+				bitheap->op->schedule();
+				bitheap->sortBitsInColumns();
+			}
+
 			//assume that in every stage we compress bits
 			colorCount++;
 			bitheap->colorBits(BitType::justAdded, colorCount);
@@ -514,6 +627,8 @@ namespace flopoco{
 		}
 		//generate the final addition
         generateFinalAddVHDL(bitheap->getOp()->getTarget()->getVendor() == "Xilinx");
+		//count the registers of the compressor tree
+		reportRegisteredBits();
         //concatenate all the chunks and create the final result
 		concatenateChunks();
 		//mark the bitheap as compressed
@@ -599,6 +714,7 @@ namespace flopoco{
 		//create the signals for the compressor inputs
 		//	and create the port mappings
         bitheap->getOp()->vhdl << endl;
+		count = 0;
 		for(unsigned i=0; i<compressor->heights.size(); i++)
 		{
 			if(compressor->heights[i] > 0)
@@ -609,6 +725,10 @@ namespace flopoco{
 				bitheap->getOp()->vhdl << tab << bitheap->getOp()->declare(compressorIONames.str(), compressor->heights[i])
 						<< " <= \"\" & " << compressorInputs[i] << ";" << endl;
 				bitheap->getOp()->inPortMap(join("X",i), compressorIONames.str());
+
+				Signal* inputSignal = bitheap->getOp()->getSignalByName(compressorIONames.str());
+				for(int j=0; j<compressor->heights[i]; j++)
+					bitConsumers.push_back(make_pair(bitVector[count++]->signal, inputSignal));
 			}
 		}
 
@@ -686,6 +806,10 @@ namespace flopoco{
 				bitheap->getOp()->vhdl << tab << bitheap->getOp()->declare(vectorName.str(), compressor->heights[i])
 						<< " <= \"\" & " << compressorInputs[i] << ";" << endl;
 				bitheap->getOp()->inPortMap(join("X",i), vectorName.str());
+
+				Signal* inputSignal = bitheap->getOp()->getSignalByName(vectorName.str());
+				for(unsigned j=0; j<inputBits[i].size() && j<(unsigned)compressor->heights[i]; j++)
+					bitConsumers.push_back(make_pair(inputBits[i][j]->signal, inputSignal));
 			}
 		}
 
@@ -754,6 +878,94 @@ namespace flopoco{
 	}
 
 
+	void CompressionStrategy::applyCompressorArray(vector<vector<vector<Bit*> > > bitVectors, Compressor* compressor, vector<int> weights)
+	{
+		ostringstream vectorName;
+		int instanceUID = Operator::getNewUId();
+		unsigned int count = bitVectors.size();
+
+		if(compressor == nullptr){
+			THROWERROR("Compressor empty in applyCompressorArray");
+		}
+		for(unsigned int c = 0; c < compressor->outHeights.size(); c++){
+			if(compressor->outHeights[c] > 1){
+				THROWERROR("applyCompressorArray: compressor " << compressor->getName() << " has several outputs per column");
+			}
+		}
+
+		//the array with this number of copies, shared by all the groups of the same size
+		CompressorArray* array;
+		auto key = make_pair(compressor, count);
+		if(compressorArrays.count(key) > 0){
+			array = compressorArrays[key];
+		}
+		else{
+			array = new CompressorArray(bitheap->getOp(), bitheap->getOp()->getTarget(), compressor, count);
+			compressorArrays[key] = array;
+		}
+
+		//input buses: the inputs of each copy as in applyCompressor, the last copy first (at the msb)
+		bitheap->getOp()->vhdl << endl;
+		for(unsigned int c = 0; c < compressor->heights.size(); c++){
+			if(compressor->heights[c] <= 0){
+				continue;
+			}
+			ostringstream inputName;
+			for(int k = count - 1; k >= 0; k--){
+				for(unsigned int i = 0; i < (unsigned) compressor->heights[c]; i++){
+					if(k != (int)count - 1 || i != 0){
+						inputName << " & ";
+					}
+					if(bitVectors[k][c].size() > i){
+						inputName << bitVectors[k][c][i]->getName();
+					}
+					else{
+						inputName << "\"0\"";
+					}
+				}
+			}
+			vectorName.str("");
+			vectorName << array->getName() << "_bh" << bitheap->guid << "_uid" << instanceUID << "_In" << c;
+			bitheap->getOp()->vhdl << tab << bitheap->getOp()->declare(vectorName.str(), count*compressor->heights[c])
+					<< " <= \"\" & " << inputName.str() << ";" << endl;
+			bitheap->getOp()->inPortMap(join("X",c), vectorName.str());
+
+			Signal* inputSignal = bitheap->getOp()->getSignalByName(vectorName.str());
+			for(unsigned int k = 0; k < count; k++){
+				for(unsigned int i = 0; i < bitVectors[k][c].size() && i < (unsigned)compressor->heights[c]; i++){
+					bitConsumers.push_back(make_pair(bitVectors[k][c][i]->signal, inputSignal));
+				}
+			}
+		}
+
+		//output bus, and instance of the array
+		vectorName.str("");
+		vectorName << array->getName() << "_bh" << bitheap->guid << "_uid" << instanceUID << "_Out";
+		bitheap->getOp()->outPortMap("R", vectorName.str());
+		bitheap->getOp()->vhdl << bitheap->getOp()->instance(array, join(array->getName(), "_uid", instanceUID)) << endl;
+
+		//add the outputBits of each copy to the bitheap
+		for(unsigned int k = 0; k < count; k++){
+			for(unsigned int c = 0; c < compressor->outHeights.size(); c++){
+				if(c + weights[k] < bitheap->width){
+					bitheap->addBit(vectorName.str() + of(k*compressor->wOut + c), c + weights[k]);
+				}
+			}
+		}
+		bitheap->markBits(bitheap->getOp()->getSignalByName(vectorName.str()), BitType::justAdded, *min_element(weights.begin(), weights.end()));
+
+		//set the inputbits to compressed
+		for(auto copyBits: bitVectors){
+			for(auto column: copyBits){
+				for(auto bit: column){
+					bitheap->markBit(bit, BitType::compressed);
+				}
+			}
+		}
+		compressor->markUsed();
+	}
+
+
 	void CompressionStrategy::generateFinalAddVHDL(bool isXilinx)
 	{
         //check if the last two lines are already compressed
@@ -832,6 +1044,15 @@ namespace flopoco{
 					<< " <= " << adderCin.str() << ";" << endl;
             bitheap->getOp()->vhdl << endl;
 
+			//the bits enter the adder inputs in the order in which they were concatenated
+			vector<Signal*> adderInputs = {bitheap->getOp()->getSignalByName(adderIn0Name.str()),
+					bitheap->getOp()->getSignalByName(adderIn1Name.str()), bitheap->getOp()->getSignalByName(adderCinName.str())};
+			for(unsigned i=adderStartIndex; i<bitheap->bits.size(); i++)
+				for(unsigned j=0; j<bitheap->bits[i].size() && j<2; j++)
+					bitConsumers.push_back(make_pair(bitheap->bits[i][j]->signal, adderInputs[j]));
+			if((unsigned)adderStartIndex < bitheap->bits.size() && bitheap->bits[adderStartIndex].size() > 2)
+				bitConsumers.push_back(make_pair(bitheap->bits[adderStartIndex][2]->signal, adderInputs[2]));
+
 			//declare the adder
 #if 0
 			IntAdder* adder;
@@ -9,6 +9,7 @@
 
 #include "BitHeap/Bit.hpp"
 #include "BitHeap/Compressor.hpp"
+#include "BitHeap/CompressorArray.hpp"
 #include "BitHeap/BitHeap.hpp"
 #include "BitHeap/BitHeapPlotter.hpp"
 #include "BitHeap/BitHeapSolution.hpp"
@@ -78,6 +79,15 @@ class BitheapPlotter;
 		 */
 		void applyCompressor(vector<vector<Bit*> > bitVector, Compressor* compressor, int weight);
 
+		/**
+		 * @brief apply several copies of a compressor, as a single CompressorArray instance.
+		 *        The copies must have the same input timing, so that the schedule is that of separate compressors.
+		 * @param bitVectors the bits to compress by each copy, as for applyCompressor()
+		 * @param compressor the compressor used for compression
+		 * @param weights the weight of the lsb column of bits of each copy
+		 */
+		void applyCompressorArray(vector<vector<vector<Bit*> > > bitVectors, Compressor* compressor, vector<int> weights);
+
 		/**
 		 * @brief applies an adder with wIn = msbColumn-lsbColumn+1;
 		 * lsbColumn has size=3, if hasCin=true, and the other columns (including msbColumn) have size=2
@@ -227,10 +237,32 @@ class BitheapPlotter;
           */
         void printSolutionStatistics();
 
+		/**
+		 * @brief with the reportRegisters option, adds the bits registered in the compressor tree to the final report of the operator,
+		 *        next to those of the tree built without the register-aware cost of the strategy, if it has one (see baselineRegisteredBits()).
+		 */
+		void reportRegisteredBits();
+
+		/**
+		 * @brief counts the bits registered in the compressor tree at each cycle boundary, using the schedule of the operator.
+		 *        A bit is registered from its own cycle to the cycle of the compressor (or final adder) input it enters.
+		 * @param registeredBits filled with the count of each cycle boundary, indexed by the cycle before it
+		 * @return the total count
+		 */
+		int countRegisteredBits(map<int, int> &registeredBits);
+
+		/**
+		 * @brief the registered bits of the compressor tree that the strategy builds without its register-aware cost
+		 * @return the count, or -1 if the strategy has no register-aware cost
+		 */
+		virtual int baselineRegisteredBits();
+
 
 
         /**
-		 * @brief all compressors specified in the solution will be used (vhdl code will be generated)
+		 * @brief all compressors specified in the solution will be used (vhdl code will be generated).
+		 *        With Target::useCompressorArrays(), the compressors of a stage that have the same type and input timing
+		 *        are generated as a single CompressorArray.
 		 */
 		void applyAllCompressorsFromSolution();
 
@@ -254,10 +286,14 @@ class BitheapPlotter;
 		BitheapPlotter *bitheapPlotter;             /**< The bitheap plotter for this bitheap compression */
 
 		vector<BasicCompressor*> possibleCompressors;    /**< All the possible compressors that can be used for compressing the bitheap */
+		map<pair<Compressor*, unsigned>, CompressorArray*> compressorArrays; /**< The arrays generated so far, by compressor and number of copies */
 
 		unsigned compressionDoneIndex;              /**< The index in the range msb-lsb up to which the compression is completed */
 		vector<string> chunksDone;                  /**< The vector containing the chunks of the compression result */
 
+		vector<pair<Signal*, Signal*> > bitConsumers; /**< For each bit that entered a compressor or the final adder, the signal of the bit and the input signal it entered */
+		bool registerReport;                        /**< If true, reportRegisteredBits() reports the registers of the compressor tree */
+
 		int stagesPerCycle;                         /**< The number of stages of compression in each cycle */
 		double compressionDelay;                    /**< The duration of a compression stage */
 
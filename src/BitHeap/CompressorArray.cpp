@@ -0,0 +1,53 @@
+#include "CompressorArray.hpp"
+
+using namespace std;
+
+namespace flopoco{
+
+	CompressorArray::CompressorArray(Operator* parentOp, Target * target, Compressor* compressor_, unsigned count_)
+		: Operator(parentOp, target), compressor(compressor_), count(count_)
+	{
+		ostringstream name;
+
+		//like the compressors, the arrays are combinatorial and shared.
+		//	The generate loop is not understood by the scheduler: the code is output as it is,
+		//	and the timing of the output is the one of the compressor
+		setCombinatorial();
+		setShared();
+		setNoParseNoSchedule();
+
+		name << "CompressorArray_";
+		for(int i=compressor->heights.size()-1; i>=0; i--)
+			name << compressor->heights[i];
+		name << "_" << compressor->wOut << "_x" << count;
+		setNameWithFreqAndUID(name.str());
+
+		for(int i=compressor->heights.size()-1; i>=0; i--)
+		{
+			if(compressor->heights[i] > 0)
+				addInput(join("X",i), count*compressor->heights[i]);
+		}
+		addOutput("R", count*compressor->wOut);
+
+		//the compressor is scheduled and its code generated, as by instance() for a shared operator
+		compressor->schedule();
+		compressor->applySchedule();
+		addSubComponent(compressor);
+		getSignalByName("R")->setCriticalPath(compressor->getSignalByName("R")->getCriticalPath());
+
+		vhdl << tab << "copies: for k in 0 to " << count-1 << " generate" << endl;
+		vhdl << tab << tab << "copy: " << compressor->getName() << endl;
+		vhdl << tab << tab << tab << "port map ( ";
+		for(int i=compressor->heights.size()-1; i>=0; i--)
+		{
+			if(compressor->heights[i] > 0)
+				vhdl << "X" << i << " => X" << i << "((k+1)*" << compressor->heights[i] << "-1 downto k*" << compressor->heights[i] << ")," << endl
+						<< tab << tab << tab << "           ";
+		}
+		vhdl << "R => R((k+1)*" << compressor->wOut << "-1 downto k*" << compressor->wOut << "));" << endl;
+		vhdl << tab << "end generate;" << endl;
+
+		REPORT(DEBUG, "Generated " << name.str());
+	}
+
+}
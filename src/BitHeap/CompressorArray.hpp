@@ -0,0 +1,33 @@
+#ifndef COMPRESSORARRAY_HPP
+#define COMPRESSORARRAY_HPP
+
+#include "BitHeap/Compressor.hpp"
+
+namespace flopoco
+{
+
+	/**
+	 * Several copies of a compressor in a single entity, instantiated by a generate loop.
+	 * The inputs X<i> and the output R are the concatenations of those of the copies, copy 0 at the lsb:
+	 * copy k uses X<i>((k+1)*heights[i]-1 downto k*heights[i]) and R((k+1)*wOut-1 downto k*wOut).
+	 *
+	 * It replaces, in the code of a bitheap, the compressors of a same type that have the same input timing,
+	 * so that a large compressor tree needs one instance and a few buses per group instead of per compressor.
+	 * The netlist is the same, and so is the schedule: the delay of the array is the one of the compressor.
+	 */
+	class CompressorArray : public Operator
+	{
+	public:
+
+		/**
+		 * @param compressor the compressor that is copied
+		 * @param count the number of copies
+		 */
+		CompressorArray(Operator* parentOp, Target * target, Compressor* compressor, unsigned count);
+
+		Compressor* compressor;             /**< the compressor that is copied */
+		unsigned count;                     /**< the number of copies */
+	};
+
+}
+#endif
@@ -1,5 +1,7 @@
 
 #include "MaxEfficiencyCompressionStrategy.hpp"
+#include <algorithm>
+#include <thread>
 //#include "CompressionStrategy.hpp"
 //#include "BitHeap/BitHeap.hpp"
 
@@ -51,6 +53,11 @@ namespace flopoco{
 
 	void MaxEfficiencyCompressionStrategy::maxEfficiencyAlgorithm(){
 
+		//a placement changes the bits of the columns it covers, hence the efficiency of the compressors overlapping them
+		unsigned int maxCompressorColumns = 0;
+		for(unsigned int e = 0; e < possibleCompressors.size(); e++){
+			maxCompressorColumns = std::max(maxCompressorColumns, possibleCompressors[e]->getHeights());
+		}
 
 		unsigned int s = 0;
 		while(true){
@@ -66,6 +73,17 @@ namespace flopoco{
 				bitAmount[bitAmount.size() - 1].resize(bitAmount[bitAmount.size() - 2].size(), 0);
 			}
 
+			float lowerBound;
+			if(s < lowerBounds.size())
+				lowerBound = lowerBounds[s];
+			else
+				lowerBound = 0.0;
+
+			//score every compressor on every column once per stage; after that, only around each placement
+			unsigned int columns = bitAmount[s].size();
+			efficiency.assign(possibleCompressors.size(), vector<double>(columns, 0.0));
+			scoreColumns(s, 0, columns);
+
 			bool found = true;
 			while(found){
 				found = false;
@@ -74,33 +92,17 @@ namespace flopoco{
 				BasicCompressor* compressor = nullptr;
 				unsigned int column = 0;
 
+				vector<unsigned int> order = columnOrder(s);
+
 				for(unsigned int e = 0; e < possibleCompressors.size(); e++){
 					BasicCompressor* currentCompressor = possibleCompressors[e];
 					REPORT(DEBUG, "compressor is " << currentCompressor->getStringOfIO());
-					vector<bool> used;
-					used.resize(bitAmount[s].size(), false);
-
-					unsigned int columnsAlreadyChecked = 0;
-					//check if the achievedEfficiency is better than the maximal efficiency possible by this compressor. If true, it's not necessary to check this and the following compressors. Therefore return.
-					while(columnsAlreadyChecked < bitAmount[s].size() && !((found == true) && currentCompressor->getEfficiency() - achievedEfficiencyBest < 0.0001)){
-
-						unsigned int currentMaxColumn = 0;
-						int currentSize = 0;
-						for(unsigned int c = 0; c < bitAmount[s].size(); c++){
-							if(!used[c] && bitAmount[s][c] > currentSize){
-								currentMaxColumn = c;
-								currentSize = bitAmount[s][c];
-							}
-						}
-						used[currentMaxColumn] = true;
-						double achievedEfficiencyCurrent = getCompressionEfficiency(s, currentMaxColumn, currentCompressor);
-						REPORT(FULL, "checked " << currentCompressor->getStringOfIO() << " in stage " << s << " and column " << currentMaxColumn << " with an efficiency of " << achievedEfficiencyCurrent);
 
-						float lowerBound;
-						if(s < lowerBounds.size())
-							lowerBound = lowerBounds[s];
-						else
-							lowerBound = 0.0;
+					//check if the achievedEfficiency is better than the maximal efficiency possible by this compressor. If true, it's not necessary to check this and the following compressors.
+					for(unsigned int k = 0; k < order.size() && !((found == true) && currentCompressor->getEfficiency() - achievedEfficiencyBest < 0.0001); k++){
+						unsigned int currentMaxColumn = order[k];
+						double achievedEfficiencyCurrent = efficiency[e][currentMaxColumn];
+						REPORT(FULL, "checked " << currentCompressor->getStringOfIO() << " in stage " << s << " and column " << currentMaxColumn << " with an efficiency of " << achievedEfficiencyCurrent);
 
 						if(achievedEfficiencyCurrent > (achievedEfficiencyBest + 0.0001) && achievedEfficiencyCurrent > (lowerBound - 0.0001)){
 							achievedEfficiencyBest = achievedEfficiencyCurrent;
@@ -108,13 +110,14 @@ namespace flopoco{
 							found = true;
 							column = currentMaxColumn;
 						}
-						columnsAlreadyChecked++;
 					}
 				}
 				if(found){
 					REPORT(DETAILED, "placed compressor " << compressor->getStringOfIO() << " in stage " << s << " and column " << column);
 					REPORT(DETAILED, "efficiency is " << achievedEfficiencyBest);
 					placeCompressor(s, column, compressor);
+					scoreColumns(s, (column + 1 > maxCompressorColumns ? column + 1 - maxCompressorColumns : 0),
+											 std::min(columns, column + compressor->getHeights()));
 				}
 			}
 			//finished one stage. bring the remaining bits in bitAmount to the new stage
@@ -133,10 +136,50 @@ namespace flopoco{
 	}
 
 
+	vector<unsigned int> MaxEfficiencyCompressionStrategy::columnOrder(unsigned int s){
+		// This is the order in which the columns used to be picked, by repeatedly searching the highest column not used yet:
+		// when none of the remaining columns has bits, this search returned column 0
+		vector<unsigned int> order;
+		for(unsigned int c = 0; c < bitAmount[s].size(); c++){
+			if(bitAmount[s][c] > 0){
+				order.push_back(c);
+			}
+		}
+		std::stable_sort(order.begin(), order.end(),
+										 [this, s](unsigned int c1, unsigned int c2) { return bitAmount[s][c1] > bitAmount[s][c2]; });
+		if(order.size() < bitAmount[s].size()){
+			order.push_back(0);
+		}
+		return order;
+	}
 
 
+	// Below this number of (compressor, column) pairs, starting threads costs more than it saves
+	static const unsigned int parallelScoringThreshold = 1 << 14;
 
+	void MaxEfficiencyCompressionStrategy::scoreColumns(unsigned int s, unsigned int first, unsigned int last){
+		auto score = [this, s](unsigned int from, unsigned int to) {
+			for(unsigned int c = from; c < to; c++){
+				for(unsigned int e = 0; e < possibleCompressors.size(); e++){
+					efficiency[e][c] = getCompressionEfficiency(s, c, possibleCompressors[e]);
+				}
+			}
+		};
 
-
+		unsigned int threads = std::thread::hardware_concurrency();
+		if(first >= last || (last - first) * possibleCompressors.size() < parallelScoringThreshold || threads < 2){
+			score(first, last);
+			return;
+		}
+		//the columns are independent: each thread scores a slice of them
+		vector<std::thread> pool;
+		unsigned int slice = (last - first + threads - 1) / threads;
+		for(unsigned int from = first; from < last; from += slice){
+			pool.push_back(std::thread(score, from, std::min(last, from + slice)));
+		}
+		for(auto& t: pool){
+			t.join();
+		}
+	}
 
 }
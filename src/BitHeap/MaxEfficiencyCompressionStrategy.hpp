@@ -19,7 +19,7 @@ class BitHeap;
 		MaxEfficiencyCompressionStrategy(BitHeap *bitheap);
 
 
-	private:
+	protected:
 		/**
 		 *	@brief starts the compression algorithm. It will call maxEfficiencyAlgorithm()
 		 */
@@ -30,8 +30,23 @@ class BitHeap;
 		 */
 		void maxEfficiencyAlgorithm();
 
+		/**
+		 * @brief computes efficiency[e][c] for all the compressors, and the columns c in [first, last) of the given stage.
+		 * Large ranges are split among threads.
+		 */
+		void scoreColumns(unsigned int stage, unsigned int first, unsigned int last);
+
+		/**
+		 * @brief returns the columns of a stage in the order in which they are tried for each compressor:
+		 * by decreasing number of bits (the lowest column first in case of a tie),
+		 * followed by column 0 if some columns have no bits
+		 */
+		vector<unsigned int> columnOrder(unsigned int stage);
+
 		vector<float> lowerBounds;
 
+		vector<vector<double> > efficiency;          /**< efficiency[e][c] of possibleCompressors[e] placed at column c of the current stage */
+
 
 	};
 
@@ -1,5 +1,8 @@
 
 #include "OptimalCompressionStrategy.hpp"
+#ifndef HAVE_SCALP
+#include "CompressionBranchAndBound.hpp"
+#endif
 
 
 
@@ -20,10 +23,6 @@ namespace flopoco{
 	{
 		REPORT(DEBUG, "compressionAlgorithm is optimal");
 
-#ifndef HAVE_SCALP
-		THROWERROR("For the optimal compressor tree generation scalp is needed");
-#else
-
 		//for debugging it might be better to order the compressors by efficiency
 		orderCompressorsByCompressionEfficiency();
 
@@ -65,7 +64,6 @@ namespace flopoco{
 
 		//here the VHDL-Code for the compressors as well as the bits->compressors->bits are being written.
 		applyAllCompressorsFromSolution();
-#endif //HAVE_SCALP
 	}
 
 #ifdef HAVE_SCALP
@@ -133,6 +131,42 @@ namespace flopoco{
 
 	}
 
+#else
+	bool OptimalCompressionStrategy::optimalGeneration(unsigned int stages, bool optimalMinStages){
+
+		if(!optimalMinStages){
+			stages = getMaxStageCount();
+
+			REPORT(DEBUG, "daddaStageCount is " << stages);
+		}
+		resizeBitAmount(stages);
+		REPORT(DEBUG, "bitAmount has now a size of " << bitAmount.size());
+
+		addFlipFlop();
+		REPORT(DEBUG, "added flipflop");
+
+		for(unsigned int e = 0; e < possibleCompressors.size(); e++){
+			REPORT(DEBUG, "at position " << e << " is compressor " << possibleCompressors[e]->getStringOfIO() << " with costs of " << possibleCompressors[e]->area);
+		}
+
+		//same problem as the ILP: without a fixed output stage, the final adder may be placed in any stage of bitAmount
+		CompressionBranchAndBound solver(bitAmount, possibleCompressors, flipflop);
+		unsigned int lastStage = (optimalMinStages ? stages : bitAmount.size() - 1);
+		bool success = solver.solve(lastStage, optimalMinStages, bitheap->getOp()->getTarget()->getILPTimeout());
+		REPORT(DEBUG, "branch and bound " << (solver.isComplete() ? "completed" : "timed out") << " with success = " << success);
+
+		if(!success && !solver.isComplete()){
+			THROWERROR("No feasible solution possible within given ILPTimeout.");
+		}
+		if(success){
+			REPORT(INFO, "compressor tree of area " << solver.getArea() << (solver.isComplete() ? " (optimal)" : " (best found within ILPTimeout)"));
+			solver.fillSolution(solution);
+		}
+
+		return success;
+	}
+#endif //HAVE_SCALP
+
 	void OptimalCompressionStrategy::resizeBitAmount(unsigned int stages){
 
 		stages++;	//we need also one stage for the outputbits
@@ -145,6 +179,7 @@ namespace flopoco{
 		}
 	}
 
+#ifdef HAVE_SCALP
 	void OptimalCompressionStrategy::initializeSolver(){
 
 		problemSolver = new ScaLP::Solver(ScaLP::newSolverDynamic({bitheap->getOp()->getTarget()->getILPSolver(),"Gurobi","CPLEX","SCIP","LPSolve"}));
@@ -360,6 +395,8 @@ namespace flopoco{
 
 	}
 
+#endif //HAVE_SCALP
+
 	bool OptimalCompressionStrategy::addFlipFlop(){
 
 		bool foundFlipflop = false;
@@ -389,6 +426,7 @@ namespace flopoco{
 		return !foundFlipflop;
 	}
 
+#ifdef HAVE_SCALP
 	bool OptimalCompressionStrategy::solve(){
 
 		for(unsigned int e = 0; e < possibleCompressors.size(); e++){
@@ -458,6 +496,8 @@ namespace flopoco{
 		}
 	}
 
+#endif //HAVE_SCALP
+
 	unsigned int OptimalCompressionStrategy::getMaxStageCount(){
 
 		//catching the case that there is no bitheap needed
@@ -528,6 +568,4 @@ namespace flopoco{
 		return 0;
 	}
 
-
-#endif //HAVE_SCALP
 }
@@ -37,12 +37,30 @@ class BitHeap;
 		 */
 		void compressionAlgorithm();
 
-#ifdef HAVE_SCALP
-
+		/**
+		 *	@brief generates the compressor tree, with the ILP solver if FloPoCo was built with ScaLP, with CompressionBranchAndBound otherwise
+		 *	@param stages the stage of the final adder, if optimalMinStages is true
+		 *	@return true if a solution was found
+		 */
 		bool optimalGeneration(unsigned int stages = 0, bool optimalMinStages = false);
 
 		void resizeBitAmount(unsigned int stages);
 
+		/**
+		 *	@brief adds flipflop at back if there is not present in possible compressors. If flipflop is added, returns true, otherwise false. stores the found or created flipflop.
+		 */
+		bool addFlipFlop();
+
+		unsigned int getMaxStageCount();
+
+		unsigned int getMinAmountOfStages();
+
+		bool daddaTwoBitStageReached(vector<int> currentBits, unsigned int stage);
+
+		BasicCompressor* flipflop;
+
+#ifdef HAVE_SCALP
+
 		void initializeSolver();
 
 		/**
@@ -86,23 +104,12 @@ class BitHeap;
 		 */
 		void selectOutputStage(unsigned int stage);
 
-		/**
-		 *	@brief adds flipflop at back if there is not present in possible compressors. If flipflop is added, returns true, otherwise false. stores the found or created flipflop.
-		 */
-		bool addFlipFlop();
-
 		void generateConstraintForVariableCompressors();
 
 		bool solve();
 
 		void fillSolutionFromILP();
 
-		unsigned int getMaxStageCount();
-
-		unsigned int getMinAmountOfStages();
-
-		bool daddaTwoBitStageReached(vector<int> currentBits, unsigned int stage);
-
 		ScaLP::Solver *problemSolver; /* stores the solver */
 
 		vector<vector<vector<ScaLP::Variable> > > compCountVars; /* stores k_s_e_c: the integer variable, which counts how many compressors fro mtype e are in stage s and column c. s is the first index, e the second and c the third. */
@@ -115,8 +122,6 @@ class BitHeap;
 
 		vector<vector<ScaLP::Variable> > emptyInputVars; /* stores Z_s_c: the integer variable, which counts, how many empty inputs are in stage s and column c. First dimension is s, second is c */
 
-		BasicCompressor* flipflop;
-
 #endif //HAVE_SCALP
 
 	};
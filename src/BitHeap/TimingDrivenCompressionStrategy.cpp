@@ -0,0 +1,234 @@
+#include "TimingDrivenCompressionStrategy.hpp"
+#include "UserInterface.hpp"
+
+#include <algorithm>
+
+
+using namespace std;
+
+namespace flopoco{
+
+	// The area of a flip-flop in LUT-equivalents (the unit of the compressor areas): a slice has two flip-flops per LUT
+	static const double flipflopArea = 0.5;
+
+
+	TimingDrivenCompressionStrategy::TimingDrivenCompressionStrategy(BitHeap* bitheap) : CompressionStrategy(bitheap)
+	{
+		registerAware = true;
+	}
+
+
+
+	double TimingDrivenCompressionStrategy::arrivalTime(Bit* bit)
+	{
+		return bit->signal->getCycle() * (1.0/bitheap->getOp()->getTarget()->frequency()) + bit->signal->getCriticalPath();
+	}
+
+
+
+	bool TimingDrivenCompressionStrategy::compressReadyBits(double time)
+	{
+		unsigned width = bitheap->bits.size();
+		vector<vector<Bit*> > readyBits(width);
+		vector<int> height(width, 0);
+		bool compressionPerformed = false;
+
+		//the bits in a column are sorted by arrival time, so the ready bits come first
+		for(unsigned c=compressionDoneIndex; c<width; c++)
+		{
+			for(auto bit: bitheap->bits[c])
+			{
+				if(bit->type != BitType::free)
+					continue;
+				height[c]++;
+				if(arrivalTime(bit) <= time + compressionDelay)
+					readyBits[c].push_back(bit);
+			}
+		}
+
+		while(true)
+		{
+			//find the most efficient compressor, counting only the ready bits as inputs
+			//	and only the outputs that fall inside the bitheap
+			BasicCompressor* bestCompressor = nullptr;
+			unsigned bestColumn = 0;
+			double bestEfficiency = 0.0;
+
+			for(auto compressor: possibleCompressors)
+			{
+				if(compressor->type.compare("variable") == 0 || compressor->area <= 0.0 || compressor->heights.size() == 0)
+					continue;
+
+				for(unsigned c=compressionDoneIndex; c<width; c++)
+				{
+					//only compress the columns that are too high for the final adder
+					if(height[c] <= 2)
+						continue;
+
+					int inputBits = 0, outputBits = 0, latestCycle = 0, cycleSum = 0;
+					for(unsigned j=0; j<compressor->heights.size() && c+j<width; j++)
+					{
+						int count = min(compressor->heights[j], (int)readyBits[c+j].size());
+						inputBits += count;
+						for(int k=0; k<count; k++)
+						{
+							latestCycle = max(latestCycle, readyBits[c+j][k]->signal->getCycle());
+							cycleSum += readyBits[c+j][k]->signal->getCycle();
+						}
+					}
+					for(unsigned j=0; j<compressor->outHeights.size() && c+j<width; j++)
+						outputBits += compressor->outHeights[j];
+
+					//the inputs that arrive in an earlier cycle than the latest one are registered:
+					//	count them in the cost, so that the bits of a same cycle are compressed together
+					int registeredBits = inputBits * latestCycle - cycleSum;
+					double efficiency = (double)(inputBits - outputBits) / (compressor->area + (registerAware ? flipflopArea * registeredBits : 0.0));
+					if((inputBits > outputBits) && (efficiency > bestEfficiency))
+					{
+						bestCompressor = compressor;
+						bestColumn = c;
+						bestEfficiency = efficiency;
+					}
+				}
+			}
+
+			if(bestCompressor == nullptr)
+				break;
+
+			//take the earliest ready bits as inputs, the missing ones are set to zero by applyCompressor
+			vector<vector<Bit*> > inputBits(bestCompressor->heights.size());
+			for(unsigned j=0; j<bestCompressor->heights.size() && bestColumn+j<width; j++)
+			{
+				vector<Bit*> &column = readyBits[bestColumn+j];
+				unsigned count = min(bestCompressor->heights[j], (int)column.size());
+				inputBits[j].assign(column.begin(), column.begin() + count);
+				column.erase(column.begin(), column.begin() + count);
+				height[bestColumn+j] -= count;
+			}
+			//the outputs are not ready before the next round
+			for(unsigned j=0; j<bestCompressor->outHeights.size() && bestColumn+j<width; j++)
+				height[bestColumn+j] += bestCompressor->outHeights[j];
+
+			REPORT(DEBUG, "applying compressor " << bestCompressor->getStringOfIO() << " to column " << bestColumn << " at time " << time);
+			applyCompressor(inputBits, bestCompressor->getCompressor(), bestColumn);
+			compressionPerformed = true;
+		}
+
+		return compressionPerformed;
+	}
+
+
+
+	void TimingDrivenCompressionStrategy::compressionAlgorithm()
+	{
+		REPORT(DEBUG, "compressionAlgorithm is TimingDriven");
+		unsigned int colorCount = 0;
+
+		//keep the bits to compress, for the comparison of reportRegisteredBits()
+		if(registerReport && registerAware)
+		{
+			bitheap->op->schedule();
+			for(unsigned c=compressionDoneIndex; c<bitheap->bits.size(); c++)
+				for(auto bit: bitheap->bits[c])
+					if(bit->type == BitType::free)
+						initialBits.push_back(make_pair(bitheap->lsb + (int)c, bit->signal));
+		}
+
+		while(bitheap->compressionRequired())
+		{
+			//compute the timing of the bits added by the previous round
+			bitheap->op->schedule();
+			bitheap->sortBitsInColumns();
+
+			//the arrival times of the bits, in increasing order
+			vector<double> arrivalTimes;
+			for(unsigned c=compressionDoneIndex; c<bitheap->bits.size(); c++)
+				for(auto bit: bitheap->bits[c])
+					if(bit->type == BitType::free)
+						arrivalTimes.push_back(arrivalTime(bit));
+			sort(arrivalTimes.begin(), arrivalTimes.end());
+			arrivalTimes.erase(unique(arrivalTimes.begin(), arrivalTimes.end()), arrivalTimes.end());
+
+			Bit *soonestBit = getSoonestBit(0, bitheap->width-1);
+
+			//compress the bits that are ready at the earliest time where a compressor can be applied,
+			//	the later bits are left for the next rounds
+			bool bitheapCompressed = false;
+			for(unsigned i=0; i<arrivalTimes.size() && !bitheapCompressed; i++)
+				bitheapCompressed = compressReadyBits(arrivalTimes[i]);
+
+			if(bitheapCompressed == false)
+				THROWERROR("TimingDriven compression: no compressor can reduce the bitheap");
+
+			//color the newly added bits and take a snapshot of the bitheap
+			colorCount++;
+			bitheap->colorBits(BitType::justAdded, colorCount);
+			bitheapPlotter->takeSnapshot(soonestBit, soonestBit);
+
+			//remove the bits that have just been compressed
+			bitheap->removeCompressedBits();
+
+			//mark the bits that have just been added as free to be compressed
+			bitheap->markBitsForCompression();
+
+			//take a snapshot of the bitheap without the bits that have been removed
+			bitheapPlotter->takeSnapshot(soonestBit, soonestBit);
+
+			//send the parts of the bitheap that has already been compressed to the final result
+			concatenateLSBColumns();
+
+			//print the status of the bitheap
+			bitheap->printBitHeapStatus();
+		}
+
+		//reports the area in LUT-equivalents
+		printSolutionStatistics();
+	}
+
+
+
+	int TimingDrivenCompressionStrategy::baselineRegisteredBits()
+	{
+		if(!registerAware || initialBits.size() == 0)
+			return -1;
+
+		//the same bits, with the same timing, in a bitheap of a scratch operator,
+		//outside of the generation context: the shared compressors of the baseline tree must not end up in globalOpList
+		UserInterface::pushAndClearGlobalOpList();
+		int count;
+		try {
+			Operator scratch(nullptr, bitheap->getOp()->getTarget());
+			scratch.setName(bitheap->getOp()->getName() + "_" + bitheap->name + "_baseline");
+			BitHeap scratchBitheap(&scratch, bitheap->msb, bitheap->lsb, bitheap->name + "_baseline");
+			for(unsigned i=0; i<initialBits.size(); i++)
+			{
+				Signal* signal = initialBits[i].second;
+				if(signal->type() == Signal::constant || signal->type() == Signal::constantWithDeclaration)
+				{
+					scratchBitheap.addConstantOneBit(initialBits[i].first);
+					continue;
+				}
+				string name = scratch.declare(join("B", i), 1, false);
+				Signal* copy = scratch.getSignalByName(name);
+				copy->setCycle(signal->getCycle());
+				copy->setCriticalPath(signal->getCriticalPath());
+				copy->setHasBeenScheduled(true);
+				scratchBitheap.addBit(name, initialBits[i].first);
+			}
+
+			TimingDrivenCompressionStrategy baseline(&scratchBitheap);
+			baseline.registerAware = false;
+			baseline.registerReport = false;
+			scratchBitheap.startCompression(&baseline);
+			map<int, int> registeredBits;
+			count = baseline.countRegisteredBits(registeredBits);
+		}
+		catch(...) {
+			UserInterface::popGlobalOpList();
+			throw;
+		}
+		UserInterface::popGlobalOpList();
+		return count;
+	}
+
+}
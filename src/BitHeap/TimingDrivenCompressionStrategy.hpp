@@ -0,0 +1,57 @@
+#ifndef TIMINGDRIVENCOMPRESSIONSTRATEGY_HPP
+#define TIMINGDRIVENCOMPRESSIONSTRATEGY_HPP
+
+#include "BitHeap/CompressionStrategy.hpp"
+#include "BitHeap/BitHeap.hpp"
+
+namespace flopoco
+{
+
+class BitHeap;
+
+	/**
+	 * A compression strategy driven by the arrival time of each bit, as computed by the scheduler for its signal.
+	 *
+	 * Each round schedules the bitheap, then looks for the earliest time at which a compressor can be applied
+	 * to bits that have all arrived (within one compression delay), and greedily applies the most efficient compressors
+	 * to these bits only. The bits of the early partial products are thus compressed while the late ones (e.g. the outputs of the DSP blocks)
+	 * are still in flight, and the compressors on the critical path are only the ones that take the late bits,
+	 * which reduces the pipeline depth and the registers of the compressor tree.
+	 * The cost of a compressor includes the flip-flops of its inputs that arrive in an earlier cycle than the others,
+	 * so that a compressor does not mix bits of different cycles when the bits of the latest cycle can be compressed together.
+	 */
+	class TimingDrivenCompressionStrategy : public CompressionStrategy
+	{
+	public:
+
+		/**
+		 * A basic constructor for a compression strategy
+		 */
+		TimingDrivenCompressionStrategy(BitHeap *bitheap);
+
+	private:
+		void compressionAlgorithm();
+
+		/**
+		 * @brief compresses, in a scratch operator, the bits of the bitheap as they were before compression,
+		 *        without the register-aware cost, and counts the registered bits of that tree
+		 */
+		int baselineRegisteredBits();
+
+		/**
+		 * @brief applies the most efficient compressors to the free bits that arrive at most a compression delay after time
+		 * @return true if at least one compressor was applied
+		 */
+		bool compressReadyBits(double time);
+
+		/**
+		 * @brief the arrival time of a bit, in seconds from the start of cycle 0
+		 */
+		double arrivalTime(Bit* bit);
+
+		bool registerAware;                         /**< If true, the cost of a compressor includes the flip-flops of its early inputs */
+		vector<pair<int, Signal*> > initialBits;    /**< With the reportRegisters option, the weight and signal of each bit before compression */
+	};
+
+}
+#endif
@@ -1615,6 +1615,17 @@ namespace flopoco{
 		tc->addExpectedOutput("R", svR);
 	}
 
+	bool IntConstMult::hasEmulateFast(){
+		// the product fits the output, so it fits 64 bits if the output does
+		return n >= 0 && getSignalByName("X")->width() <= 64 && getSignalByName("R")->width() <= 64;
+	}
+
+	void IntConstMult::emulateFast(FastTestCase *tc){
+		uint64_t c = 0;
+		mpz_export(&c, nullptr, -1, sizeof(c), 0, 0, n.get_mpz_t());
+		tc->addExpectedOutput(0, tc->getInput(0) * c);
+	}
+
 
 
 	void IntConstMult::buildStandardTestCases(TestCaseList* tcl){
@@ -64,6 +64,8 @@ namespace flopoco{
 		// Overloading the virtual functions of Operator
 
 		void emulate(TestCase* tc);
+		void emulateFast(FastTestCase* tc);
+		bool hasEmulateFast();
 		void buildStandardTestCases(TestCaseList* tcl);
 
 
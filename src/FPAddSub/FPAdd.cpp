@@ -1,5 +1,6 @@
 #include "FPAdd.hpp"
 #include <Operator.hpp>
+#include <cmath>
 
 
 using namespace std;
@@ -185,11 +186,81 @@ namespace flopoco{
 		}
 
 		/* Get correct outputs */
-		emulate(tc,wE, wF, subtract);
+		op->emulateTestCase(tc);
 		return tc;
 	}
 
 
+
+	bool FPAdd::hasEmulateFast(int wE, int wF)
+	{
+		// The exponent range then fits that of a double, without subnormals, so inputs and sums are exact or normal doubles.
+		// The sum is rounded twice, first to 53 bits then to wF+1 bits, which is innocuous for an addition if 53 >= 2(wF+1)+2 (Figueroa 1995).
+		return wE >= 2 && wE <= 10 && wF <= 24;
+	}
+
+	/* Converts a FloPoCo FP number to a double, exactly if FPAdd::hasEmulateFast(wE,wF) */
+	static double fpToDouble(uint64_t v, int wE, int wF)
+	{
+		int exn = int(v >> (wE+wF+1));
+		bool sign = (v >> (wE+wF)) & 1;
+		double r;
+		if (exn == 3)
+			return NAN;
+		else if (exn == 2)
+			r = INFINITY;
+		else if (exn == 0)
+			r = 0.0;
+		else {
+			uint64_t mantissa = v & ((uint64_t(1) << wF) - 1);
+			int exponent = int((v >> wF) & ((uint64_t(1) << wE) - 1));
+			r = ldexp(double(mantissa + (uint64_t(1) << wF)), exponent - ((1<<(wE-1))-1) - wF);
+		}
+		return sign ? -r : r;
+	}
+
+	/* Rounds a double to nearest even on wF+1 bits and converts it to a FloPoCo FP number, as FPNumber does from an MPFR number */
+	static uint64_t doubleToFP(double x, int wE, int wF)
+	{
+		uint64_t exn, sign, exponent = 0, mantissa = 0;
+		if (std::isnan(x))
+			return uint64_t(3) << (wE+wF+1);
+		sign = std::signbit(x) ? 1 : 0;
+		if (std::isinf(x))
+			exn = 2;
+		else if (x == 0)
+			exn = 0;
+		else {
+			int e;
+			double m = frexp(fabs(x), &e); // m in [1/2, 1)
+			double r = nearbyint(ldexp(m, wF+1)); // default rounding mode is to nearest even
+			if (r == ldexp(1.0, wF+1)) {
+				r = ldexp(1.0, wF);
+				e++;
+			}
+			int biasedExp = e - 1 + ((1<<(wE-1))-1);
+			if (biasedExp < 0) // underflow, the sign is kept
+				exn = 0;
+			else if (biasedExp >= (1<<wE))  // overflow
+				exn = 2;
+			else {
+				exn = 1;
+				exponent = biasedExp;
+				mantissa = uint64_t(r) - (uint64_t(1) << wF);
+			}
+		}
+		return (((((exn << 1) + sign) << wE) + exponent) << wF) + mantissa;
+	}
+
+	void FPAdd::emulateFast(FastTestCase * tc, int wE, int wF, bool subtract)
+	{
+		double x = fpToDouble(tc->getInput(0), wE, wF);
+		double y = fpToDouble(tc->getInput(1), wE, wF);
+		double r = subtract ? x - y : x + y;
+		tc->addExpectedOutput(0, doubleToFP(r, wE, wF));
+	}
+
+
 	
 	OperatorPtr FPAdd::parseArguments(OperatorPtr parentOp, Target *target, vector<string> &args) {
 		int wE, wF;
@@ -19,6 +19,12 @@ namespace flopoco{
 		/** emulate() function to be shared by various implementations */
 		static void emulate(TestCase * tc, int wE, int wF, bool subtract);
 
+		/** The same using double-precision arithmetic. Correct if hasEmulateFast(wE, wF) is true */
+		static void emulateFast(FastTestCase * tc, int wE, int wF, bool subtract);
+
+		/** true if wE and wF are small enough for emulateFast() */
+		static bool hasEmulateFast(int wE, int wF);
+
 		/** Random FP number generator biased to stress floating-point addition,
 				to be shared by various implementations */
 		static TestCase* buildRandomTestCase(Operator* op, int i, int wE, int wF, bool subtract, bool onlyPositiveIO=false);
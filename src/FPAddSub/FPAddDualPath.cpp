@@ -462,6 +462,16 @@ namespace flopoco{
 		FPAdd::emulate(tc, wE, wF, sub);
 	}
 
+	void FPAddDualPath::emulateFast(FastTestCase * tc)
+	{
+		FPAdd::emulateFast(tc, wE, wF, sub);
+	}
+
+	bool FPAddDualPath::hasEmulateFast()
+	{
+		return FPAdd::hasEmulateFast(wE, wF);
+	}
+
 
 
 
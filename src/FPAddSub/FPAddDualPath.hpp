@@ -39,6 +39,9 @@ namespace flopoco{
 		void emulate(TestCase * tc);
 		void buildStandardTestCases(TestCaseList* tcl);
 		TestCase* buildRandomTestCase(int i);
+		bool isEmulateThreadSafe() {return true;}
+		void emulateFast(FastTestCase * tc);
+		bool hasEmulateFast();
 
 
 
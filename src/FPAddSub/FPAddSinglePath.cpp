@@ -252,6 +252,16 @@ namespace flopoco{
 		FPAdd::emulate(tc, wE, wF, sub);
 	}
 
+	void FPAddSinglePath::emulateFast(FastTestCase * tc)
+	{
+		FPAdd::emulateFast(tc, wE, wF, sub);
+	}
+
+	bool FPAddSinglePath::hasEmulateFast()
+	{
+		return FPAdd::hasEmulateFast(wE, wF);
+	}
+
 
 
 
@@ -37,6 +37,9 @@ namespace flopoco{
 		void emulate(TestCase * tc);
 		void buildStandardTestCases(TestCaseList* tcl);
 		TestCase* buildRandomTestCase(int i);
+		bool isEmulateThreadSafe() {return true;}
+		void emulateFast(FastTestCase * tc);
+		bool hasEmulateFast();
 
 	private:
 		/** width of the exponent */
@@ -52,6 +52,9 @@ namespace flopoco{
 		 */
 		void emulate(TestCase * tc);
 
+		/** emulate() only uses MPFR with explicit precisions */
+		bool isEmulateThreadSafe() {return true;}
+
 		/* Overloading the Operator method */
 		void buildStandardTestCases(TestCaseList* tcl);
 
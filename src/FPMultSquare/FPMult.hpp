@@ -41,6 +41,9 @@ namespace flopoco{
 		 */
 		void emulate(TestCase * tc);
 
+		/** emulate() only uses MPFR with explicit precisions */
+		bool isEmulateThreadSafe() {return true;}
+
 		// User-interface stuff
 		/** Factory method */
 		static OperatorPtr parseArguments(OperatorPtr parentOp, Target *target , vector<string> &args);
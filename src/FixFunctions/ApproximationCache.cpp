@@ -0,0 +1,147 @@
+/*
+  A cache of the function approximations, shared by successive and concurrent runs.
+
+  This file is part of the FloPoCo project
+
+  Initial software.
+  Copyright © INSA-Lyon, INRIA, CNRS, UCBL,
+  2024.
+  All rights reserved.
+ */
+
+#include "ApproximationCache.hpp"
+#include "../OperatorCache.hpp"
+#include "../UserInterface.hpp"
+
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifndef FLOPOCO_VERSION
+#define FLOPOCO_VERSION "unknown"
+#endif
+
+namespace flopoco{
+
+	// The first line of an entry file: change it when the format of the entries changes
+	static const string entryHeader = "FloPoCo approximation cache entry, format 1";
+
+	std::mutex ApproximationCache::mutex_;
+	std::map<string, string> ApproximationCache::entries_;
+
+
+
+	string ApproximationCache::keyDescription(string kind, sollya_obj_t fS, bool signedIn, int lsbIn, int msbOut, int lsbOut, int degree, double targetAccuracy, vector<string> options)
+	{
+		// Sollya prints the function the same way whichever way it was built
+		int size = sollya_lib_snprintf(NULL, 0, "%b", fS);
+		char *buffer = (char *)malloc(size + 1);
+		sollya_lib_snprintf(buffer, size + 1, "%b", fS);
+		string function(buffer);
+		free(buffer);
+
+		ostringstream s;
+		s << "flopoco " << FLOPOCO_VERSION << endl;
+		s << kind << endl;
+		s << "f " << function << endl;
+		s << "range " << (signedIn ? "[-1,1)" : "[0,1)") << endl;
+		s << "lsbIn " << lsbIn << " msbOut " << msbOut << " lsbOut " << lsbOut << endl;
+		s << "degree " << degree << " targetAccuracy " << setprecision(17) << targetAccuracy;
+		for(auto o: options)
+			s << endl << o;
+		return s.str();
+	}
+
+
+
+	string ApproximationCache::directory()
+	{
+		return UserInterface::cacheDir;
+	}
+
+
+
+	bool ApproximationCache::lookup(string description, string &value)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			auto it = entries_.find(description);
+			if(it != entries_.end()) {
+				value = it->second;
+				return true;
+			}
+		}
+
+		string dir = directory();
+		if(dir == "")
+			return false;
+		// Any inconsistency is a miss: the entry will be overwritten by the new one
+		ifstream file(dir + "/" + OperatorCache::keyHash(description) + ".approx");
+		string line, word, checksum;
+		int descriptionLines = 0;
+		size_t size = 0;
+		if(!file.is_open() || !getline(file, line) || line != entryHeader)
+			return false;
+		if(!getline(file, line) || !(istringstream(line) >> word >> descriptionLines) || word != "key")
+			return false;
+		ostringstream storedDescription;
+		for(int i = 0; i < descriptionLines; i++) {
+			if(!getline(file, line))
+				return false;
+			storedDescription << (i == 0 ? "" : "\n") << line;
+		}
+		if(storedDescription.str() != description) // a hash collision
+			return false;
+		if(!getline(file, line) || !(istringstream(line) >> word >> checksum >> size) || word != "checksum")
+			return false;
+		string stored(size, '\0');
+		if(size > 0 && !file.read(&stored[0], size))
+			return false;
+		if(OperatorCache::keyHash(stored) != checksum) // a truncated or corrupted entry
+			return false;
+
+		value = stored;
+		std::lock_guard<std::mutex> lock(mutex_);
+		entries_[description] = value;
+		return true;
+	}
+
+
+
+	void ApproximationCache::store(string description, string value)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			entries_[description] = value;
+		}
+
+		string dir = directory();
+		if(dir == "")
+			return;
+		// Write to a file private to this thread, then rename it atomically
+		string hash = OperatorCache::keyHash(description);
+		mkdir(dir.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+		ostringstream tmpName;
+		tmpName << dir << "/" << hash << "." << getpid() << "." << std::hash<std::thread::id>()(std::this_thread::get_id()) << ".tmp";
+		ofstream file(tmpName.str());
+		file << entryHeader << endl;
+		file << "key " << count(description.begin(), description.end(), '\n') + 1 << endl;
+		file << description << endl;
+		file << "checksum " << OperatorCache::keyHash(value) << " " << value.size() << endl;
+		file << value;
+		file.close();
+		if(!file || rename(tmpName.str().c_str(), (dir + "/" + hash + ".approx").c_str()) != 0) {
+			remove(tmpName.str().c_str());
+			if(UserInterface::verbose >= INFO) {
+				cerr << "> ApproximationCache: could not write an approximation in " << dir << endl;
+			}
+		}
+	}
+
+}
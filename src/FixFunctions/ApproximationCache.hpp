@@ -0,0 +1,64 @@
+#ifndef _APPROXIMATIONCACHE_HPP_
+#define _APPROXIMATIONCACHE_HPP_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+
+#include <sollya.h>
+
+using namespace std;
+
+namespace flopoco{
+
+	/** A cache of the function approximations (polynomials, multipartite decompositions) computed by the FixFunction operators.
+
+			The key describes everything an approximation depends on: the kind of approximation, the function and its input range,
+			the input and output formats, the degree and target accuracy, the parameters specific to the kind, and the FloPoCo version.
+			The value is written by the approximation itself: typically the coefficients, their formats and the certified error bound.
+
+			The entries are kept in memory for the whole run, and also stored in the cacheDir generic option directory if it is set:
+			without it, nothing is written to disk.
+			An entry file holds a format version, the key, and a checksum of the value: any inconsistency is a miss.
+			It is written to a temporary file then renamed, so that concurrent flopoco processes sharing the directory never read a partial entry.
+	*/
+	class ApproximationCache {
+	public:
+		/**
+		 * The description of an approximation from which the cache key is computed
+		 * @param kind the class that computes the approximation
+		 * @param fS the function, printed by Sollya in the key
+		 * @param signedIn true if the input range is [-1,1), false for [0,1)
+		 * @param lsbIn, msbOut, lsbOut the formats, 0 when irrelevant
+		 * @param degree the degree of the polynomials, -1 when irrelevant
+		 * @param targetAccuracy the target accuracy, 0 when irrelevant
+		 * @param options the other parameters of the approximation, as name=value strings
+		 */
+		static string keyDescription(string kind, sollya_obj_t fS, bool signedIn, int lsbIn, int msbOut, int lsbOut, int degree, double targetAccuracy, vector<string> options = vector<string>());
+
+		/**
+		 * Looks up an approximation, in memory then in the cache directory, if any
+		 * @param description the key description, see keyDescription()
+		 * @param value filled with the stored value on a hit
+		 * @return true on a hit
+		 */
+		static bool lookup(string description, string &value);
+
+		/**
+		 * Stores an approximation, in memory and in the cache directory, if any
+		 * @param description the key description, see keyDescription()
+		 * @param value the approximation, in the format of its class
+		 */
+		static void store(string description, string value);
+
+	private:
+		/** The directory of the entry files, empty if the entries are only kept in memory */
+		static string directory();
+
+		static std::mutex mutex_;
+		static std::map<string, string> entries_;   /**< the entries of this run, by key description */
+	};
+
+}
+#endif
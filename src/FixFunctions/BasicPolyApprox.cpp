@@ -16,11 +16,13 @@
 */
 
 #include "BasicPolyApprox.hpp"
+#include "ApproximationCache.hpp"
 #include "../UserInterface.hpp"
 #include <string>
 #include <sstream>
 #include <iomanip>
 #include <iostream>
+#include <cstdlib>
 
 using namespace std;
 
@@ -32,8 +34,7 @@ namespace flopoco{
 	{
 		needToFreeF = false;
 		initialize();
-		buildApproxFromTargetAccuracy(targetAccuracy,  addGuardBits);
-		buildFixFormatVector();
+		buildCachedApprox(targetAccuracy,  addGuardBits);
 	}
 
 
@@ -43,8 +44,7 @@ namespace flopoco{
 		f = new FixFunction(sollyaString_, signedIn);
 		needToFreeF = true;
 		initialize();
-		buildApproxFromTargetAccuracy(targetAccuracy,  addGuardBits);
-		buildFixFormatVector();
+		buildCachedApprox(targetAccuracy,  addGuardBits);
 	}
 
 
@@ -54,8 +54,7 @@ namespace flopoco{
 		f = new FixFunction(fS_,signedIn);
 		needToFreeF = true;
 		initialize();
-		buildApproxFromTargetAccuracy(targetAccuracy,  addGuardBits);
-		buildFixFormatVector();
+		buildCachedApprox(targetAccuracy,  addGuardBits);
 	}
 
 	BasicPolyApprox::BasicPolyApprox(sollya_obj_t fS_, int degree_, int lsb_, bool signedIn):
@@ -81,6 +80,55 @@ namespace flopoco{
 	}
 
 
+	BasicPolyApprox::BasicPolyApprox(istream &s)
+	{
+		needToFreeF = false;
+		initialize(); // so that the destructor can be called on a failed read
+		polynomialS = NULL;
+		if(!read(s))
+			s.setstate(ios::failbit); // the callers check the stream
+	}
+
+
+	bool BasicPolyApprox::read(istream &s)
+	{
+		for (auto c: coeff)
+			delete c;
+		coeff.clear();
+		string error;
+		if(!(s >> degree >> LSB >> error) || degree < 0)
+			return false;
+		approxErrorBound = strtod(error.c_str(), NULL); // unlike >>, strtod reads inf
+		for (int i=0; i<=degree; i++){
+			int msb, lsb;
+			mpz_class mantissa;
+			long exponent;
+			if(!(s >> msb >> lsb >> mantissa >> exponent))
+				return false;
+			mpfr_t value;
+			mpfr_init2(value, mpz_sizeinbase(mantissa.get_mpz_t(), 2) + 1);
+			mpfr_set_z_2exp(value, mantissa.get_mpz_t(), exponent, GMP_RNDN); // exact
+			coeff.push_back(new FixConstant(msb, lsb, true/*signed*/, value));
+			mpfr_clear(value);
+		}
+		return true;
+	}
+
+
+	void BasicPolyApprox::write(ostream &s)
+	{
+		s << degree << " " << LSB << " " << setprecision(17) << approxErrorBound << endl;
+		for (int i=0; i<=degree; i++){
+			mpz_class mantissa;
+			long exponent = 0;
+			if(!mpfr_zero_p(coeff[i]->fpValue))
+				exponent = mpfr_get_z_2exp(mantissa.get_mpz_t(), coeff[i]->fpValue);
+			s << coeff[i]->MSB << " " << coeff[i]->LSB << " " << mantissa << " " << exponent << endl;
+		}
+	}
+
+
+
 	void BasicPolyApprox::initialize() {
 		srcFileName="BasicPolyApprox"; // should be somehow static but this is too much to ask me -> Matei: typeid() should solve this; note: the name is mangled, so some compiler-specific function to demangle the name is needed
 		fixedS = sollya_lib_fixed();
@@ -103,7 +151,7 @@ namespace flopoco{
 		//	  sollya_lib_clear_obj(S);
 		if(coeff.size()!=0){
 			for (unsigned int i=0; i<coeff.size(); i++)
-				free(coeff[i]);
+				delete coeff[i];
 		}
 	}
 
@@ -267,6 +315,45 @@ g(int)=-1: the number of guardbits added. Using -1 gives sensible default",
 
 
 
+	void BasicPolyApprox::buildCachedApprox(double targetAccuracy, int addGuardBits)
+	{
+		ostringstream guardBits;
+		guardBits << "addGuardBits=" << addGuardBits;
+		string key = ApproximationCache::keyDescription("BasicPolyApprox", f->fS, f->signedIn, 0, 0, 0, -1, targetAccuracy, {guardBits.str()});
+		string value;
+		if(ApproximationCache::lookup(key, value)) {
+			istringstream s(value);
+			if(read(s)) {
+				REPORT(DETAILED, "Polynomial found in the approximation cache");
+				// Rebuild the Sollya polynomial out of the exact coefficients, in Horner form
+				ostringstream p;
+				for (int i=0; i<=degree; i++){
+					mpz_class mantissa;
+					long exponent = 0;
+					if(!mpfr_zero_p(coeff[i]->fpValue))
+						exponent = mpfr_get_z_2exp(mantissa.get_mpz_t(), coeff[i]->fpValue);
+					p << (i==0 ? "" : " + x*(") << mantissa << "b" << exponent;
+				}
+				for (int i=1; i<=degree; i++)
+					p << ")";
+				polynomialS = sollya_lib_parse_string(p.str().c_str());
+				return;
+			}
+			for (auto c: coeff)
+				delete c;
+			coeff.clear();
+		}
+
+		buildApproxFromTargetAccuracy(targetAccuracy, addGuardBits);
+		buildFixFormatVector();
+		ostringstream s;
+		write(s);
+		ApproximationCache::store(key, s.str());
+	}
+
+
+
+
 	void BasicPolyApprox::buildApproxFromDegreeAndLSBs()
 	{
 		sollya_obj_t fS = f->fS; // no need to free this one
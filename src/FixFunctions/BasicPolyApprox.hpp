@@ -98,6 +98,11 @@ namespace flopoco{
 		 */
 		BasicPolyApprox(int degree, vector<int> MSB, int LSB, vector<mpz_class> coeff);
 
+		/** A constructor that reads back an approximation written by write(), e.g. by another process.
+				Beware, f is un-initialized in this case. On a read error, the failbit of s is set
+		 */
+		BasicPolyApprox(istream &s);
+
 
 		virtual ~BasicPolyApprox();
 
@@ -106,6 +111,10 @@ namespace flopoco{
 		 */
 		static	void guessDegree(sollya_obj_t fS, sollya_obj_t rangeS, double targetAccuracy, int* degreeInfP, int* degreeSupP);
 
+		/** Writes the degree, LSB, approximation error and coefficients, exactly, to be read back by BasicPolyApprox(istream&)
+		 */
+		void write(ostream &s);
+
 
 		static OperatorPtr parseArguments(OperatorPtr parentOp, Target *target, vector<string> &args);
 
@@ -127,6 +136,14 @@ namespace flopoco{
 		 * */
 		void buildApproxFromTargetAccuracy(double targetAccuracy, int addGuardBitsToConstant);
 
+		/** buildApproxFromTargetAccuracy then buildFixFormatVector, or reads the result in the ApproximationCache
+		 * */
+		void buildCachedApprox(double targetAccuracy, int addGuardBitsToConstant);
+
+		/** reads an approximation written by write(), false if the stream is inconsistent
+		 * */
+		bool read(istream &s);
+
 		/** build an approximation of a certain degree, LSB being already defined, then computes the approx error.
 				Essentially a wrapper for Sollya fpminimax() followed by supnorm()
 		*/
@@ -16,6 +16,11 @@
 
 #include "FixFunction.hpp"
 #include <sstream>
+#include <cmath>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
 
 namespace flopoco{
 
@@ -48,6 +53,7 @@ namespace flopoco{
 		if (sollya_lib_obj_is_error(fS) || !sollya_lib_obj_is_function(fS))
 			throw(string("FixFunction: Unable to parse input function: ")+sollyaString);
 
+		compileExpression();
 	}
 
 
@@ -60,6 +66,7 @@ namespace flopoco{
 			rangeS = sollya_lib_parse_string("[-1;1]");
 		else
 			rangeS = sollya_lib_parse_string("[0;1]");
+		compileExpression();
 	}
 
 
@@ -152,6 +159,403 @@ namespace flopoco{
 
 
 
+	void FixFunction::compileExpression()
+	{
+		expression.clear();
+		if(compileNode(fS) < 0)
+			expression.clear();
+	}
+
+
+
+	int FixFunction::compileNode(sollya_obj_t nodeS)
+	{
+		sollya_base_function_t type;
+		int arity;
+		sollya_obj_t aS = NULL;
+		sollya_obj_t bS = NULL;
+		if(!sollya_lib_decompose_function(nodeS, &type, &arity, &aS, &bS, NULL))
+			return -1;
+
+		ExprNode node;
+		node.op = type;
+		node.a = -1;
+		node.b = -1;
+		node.exponent = 0;
+		bool ok = (arity <= 2);
+		if(ok && arity >= 1) {
+			node.a = compileNode(aS);
+			ok = (node.a >= 0);
+		}
+		if(ok && arity == 2) {
+			node.b = compileNode(bS);
+			ok = (node.b >= 0);
+		}
+		if(aS != NULL)
+			sollya_lib_clear_obj(aS);
+		if(bS != NULL)
+			sollya_lib_clear_obj(bS);
+
+		switch(type) {
+		case SOLLYA_BASE_FUNC_CONSTANT: {
+			// a constant of the expression is a floating-point number, stored exactly
+			mpfr_t c;
+			mpfr_init2(c, 4096);
+			ok = ok && sollya_lib_get_constant(c, nodeS) && mpfr_number_p(c);
+			if(ok)
+				node.exponent = mpfr_get_z_2exp(node.mantissa.get_mpz_t(), c);
+			mpfr_clear(c);
+			break;
+		}
+		case SOLLYA_BASE_FUNC_FREE_VARIABLE:
+		case SOLLYA_BASE_FUNC_PI:
+		case SOLLYA_BASE_FUNC_ADD:
+		case SOLLYA_BASE_FUNC_SUB:
+		case SOLLYA_BASE_FUNC_MUL:
+		case SOLLYA_BASE_FUNC_DIV:
+		case SOLLYA_BASE_FUNC_POW:
+		case SOLLYA_BASE_FUNC_NEG:
+		case SOLLYA_BASE_FUNC_ABS:
+		case SOLLYA_BASE_FUNC_SQRT:
+		case SOLLYA_BASE_FUNC_EXP:
+		case SOLLYA_BASE_FUNC_EXP_M1:
+		case SOLLYA_BASE_FUNC_LOG:
+		case SOLLYA_BASE_FUNC_LOG_2:
+		case SOLLYA_BASE_FUNC_LOG_10:
+		case SOLLYA_BASE_FUNC_LOG_1P:
+		case SOLLYA_BASE_FUNC_SIN:
+		case SOLLYA_BASE_FUNC_COS:
+		case SOLLYA_BASE_FUNC_ATAN:
+		case SOLLYA_BASE_FUNC_SINH:
+		case SOLLYA_BASE_FUNC_COSH:
+		case SOLLYA_BASE_FUNC_TANH:
+		case SOLLYA_BASE_FUNC_ASINH:
+		case SOLLYA_BASE_FUNC_ERF:
+		case SOLLYA_BASE_FUNC_ERFC:
+			break;
+		default: // evalExpression() has no error bound for the other ones
+			ok = false;
+		}
+
+		if(!ok)
+			return -1;
+		expression.push_back(node);
+		return expression.size() - 1;
+	}
+
+
+
+	// The error bounds of evalExpression() are computed in double, and enlarged by this factor to cover the errors of this computation
+	static const double boundSlack = 1.0 + ldexp(1.0, -40);
+
+	// an upper bound on |v|
+	static double upperMagnitude(mpfr_t v)
+	{
+		return fabs(mpfr_get_d(v, GMP_RNDN)) * boundSlack;
+	}
+
+	// a lower bound on |v|
+	static double lowerMagnitude(mpfr_t v)
+	{
+		return fabs(mpfr_get_d(v, GMP_RNDN)) / boundSlack;
+	}
+
+	// a bound on the error of an MPFR operation with rounding to nearest that returned r with the given ternary value
+	static double roundingError(mpfr_t r, int ternary, mpfr_prec_t prec)
+	{
+		if(ternary == 0)
+			return 0.0;
+		return ldexp(1.0, mpfr_get_exp(r) - prec);
+	}
+
+
+
+	double FixFunction::evalExpression(mpfr_t* values, vector<double> &error, mpfr_t x, mpfr_prec_t prec) const
+	{
+		const double inf = INFINITY;
+		for(size_t i = 0; i < expression.size(); i++) {
+			const ExprNode& node = expression[i];
+			mpfr_ptr r = values[i];
+			mpfr_ptr a = (node.a >= 0 ? values[node.a] : NULL);
+			mpfr_ptr b = (node.b >= 0 ? values[node.b] : NULL);
+			double ea = (node.a >= 0 ? error[node.a] : 0.0);
+			double eb = (node.b >= 0 ? error[node.b] : 0.0);
+			// e bounds the error propagated from the errors ea and eb of the operands (infinite if there is no bound),
+			// the rounding error of the operation is added at the end
+			double e = inf;
+			int t = 0;
+			switch(node.op) {
+			case SOLLYA_BASE_FUNC_CONSTANT:
+				t = mpfr_set_z_2exp(r, node.mantissa.get_mpz_t(), node.exponent, GMP_RNDN);
+				e = 0.0;
+				break;
+			case SOLLYA_BASE_FUNC_FREE_VARIABLE:
+				t = mpfr_set(r, x, GMP_RNDN);
+				e = 0.0;
+				break;
+			case SOLLYA_BASE_FUNC_PI:
+				t = mpfr_const_pi(r, GMP_RNDN);
+				e = 0.0;
+				break;
+			case SOLLYA_BASE_FUNC_ADD:
+				t = mpfr_add(r, a, b, GMP_RNDN);
+				e = ea + eb;
+				break;
+			case SOLLYA_BASE_FUNC_SUB:
+				t = mpfr_sub(r, a, b, GMP_RNDN);
+				e = ea + eb;
+				break;
+			case SOLLYA_BASE_FUNC_MUL:
+				t = mpfr_mul(r, a, b, GMP_RNDN);
+				e = upperMagnitude(a) * eb + upperMagnitude(b) * ea + ea * eb;
+				break;
+			case SOLLYA_BASE_FUNC_DIV:
+				t = mpfr_div(r, a, b, GMP_RNDN);
+				if(lowerMagnitude(b) > eb)
+					e = (ea + (upperMagnitude(a) / lowerMagnitude(b)) * eb) / (lowerMagnitude(b) - eb);
+				break;
+			case SOLLYA_BASE_FUNC_POW:
+				if(eb == 0.0 && mpfr_integer_p(b) && mpfr_cmp_si(b, 1024) <= 0 && mpfr_cmp_si(b, -1024) >= 0) {
+					// integer exponent n: the derivative is n*a^(n-1)
+					long n = mpfr_get_si(b, GMP_RNDN);
+					t = mpfr_pow_si(r, a, n, GMP_RNDN);
+					if(n == 0 || ea == 0.0)
+						e = 0.0;
+					else if(n > 0)
+						e = n * pow(upperMagnitude(a) + ea, n - 1) * ea;
+					else if(lowerMagnitude(a) > ea)
+						e = -n * pow(lowerMagnitude(a) - ea, n - 1) * ea;
+				}
+				else {
+					// a^b = exp(b*log(a)) for a > 0: bound the error of b*log(a) first
+					t = mpfr_pow(r, a, b, GMP_RNDN);
+					if(mpfr_sgn(a) > 0 && lowerMagnitude(a) > ea) {
+						double logError = ea / (lowerMagnitude(a) - ea);
+						double logA = fmax(fabs(log(upperMagnitude(a))), fabs(log(lowerMagnitude(a))));
+						double l = upperMagnitude(b) * logError + eb * (logA + logError);
+						e = (upperMagnitude(r) + roundingError(r, t, prec)) * expm1(l) * boundSlack;
+					}
+				}
+				break;
+			case SOLLYA_BASE_FUNC_NEG:
+				t = mpfr_neg(r, a, GMP_RNDN);
+				e = ea;
+				break;
+			case SOLLYA_BASE_FUNC_ABS:
+				t = mpfr_abs(r, a, GMP_RNDN);
+				e = ea;
+				break;
+			case SOLLYA_BASE_FUNC_SQRT:
+				t = mpfr_sqrt(r, a, GMP_RNDN);
+				if(ea == 0.0)
+					e = 0.0;
+				else if(mpfr_sgn(a) > 0 && lowerMagnitude(a) > ea)
+					e = ea / sqrt(lowerMagnitude(a) - ea);
+				break;
+			case SOLLYA_BASE_FUNC_EXP:
+				t = mpfr_exp(r, a, GMP_RNDN);
+				e = (upperMagnitude(r) + roundingError(r, t, prec)) * expm1(ea) * boundSlack;
+				break;
+			case SOLLYA_BASE_FUNC_EXP_M1:
+				t = mpfr_expm1(r, a, GMP_RNDN);
+				e = (upperMagnitude(r) + roundingError(r, t, prec) + 1.0) * expm1(ea) * boundSlack;
+				break;
+			case SOLLYA_BASE_FUNC_LOG:
+			case SOLLYA_BASE_FUNC_LOG_2:
+			case SOLLYA_BASE_FUNC_LOG_10:
+				if(node.op == SOLLYA_BASE_FUNC_LOG)
+					t = mpfr_log(r, a, GMP_RNDN);
+				else if(node.op == SOLLYA_BASE_FUNC_LOG_2)
+					t = mpfr_log2(r, a, GMP_RNDN);
+				else
+					t = mpfr_log10(r, a, GMP_RNDN);
+				// the derivative of log is 1/a, the one of log10 is smaller, the one of log2 is less than 1.5/a
+				if(ea == 0.0)
+					e = 0.0;
+				else if(mpfr_sgn(a) > 0 && lowerMagnitude(a) > ea)
+					e = ea / (lowerMagnitude(a) - ea) * (node.op == SOLLYA_BASE_FUNC_LOG_2 ? 1.5 : 1.0);
+				break;
+			case SOLLYA_BASE_FUNC_LOG_1P:
+				t = mpfr_log1p(r, a, GMP_RNDN);
+				if(ea == 0.0)
+					e = 0.0;
+				else if(mpfr_cmp_si(a, -1) > 0) {
+					// a lower bound on 1+a
+					double d = (mpfr_get_d(a, GMP_RNDD) + 1.0) / boundSlack;
+					if(d > ea)
+						e = ea / (d - ea);
+				}
+				break;
+			case SOLLYA_BASE_FUNC_SIN:
+			case SOLLYA_BASE_FUNC_COS:
+			case SOLLYA_BASE_FUNC_ATAN:
+			case SOLLYA_BASE_FUNC_TANH:
+			case SOLLYA_BASE_FUNC_ASINH:
+				// derivatives bounded by 1
+				if(node.op == SOLLYA_BASE_FUNC_SIN)
+					t = mpfr_sin(r, a, GMP_RNDN);
+				else if(node.op == SOLLYA_BASE_FUNC_COS)
+					t = mpfr_cos(r, a, GMP_RNDN);
+				else if(node.op == SOLLYA_BASE_FUNC_ATAN)
+					t = mpfr_atan(r, a, GMP_RNDN);
+				else if(node.op == SOLLYA_BASE_FUNC_TANH)
+					t = mpfr_tanh(r, a, GMP_RNDN);
+				else
+					t = mpfr_asinh(r, a, GMP_RNDN);
+				e = ea;
+				break;
+			case SOLLYA_BASE_FUNC_SINH:
+			case SOLLYA_BASE_FUNC_COSH:
+				// derivatives bounded by cosh(|a|) <= exp(|a|)
+				if(node.op == SOLLYA_BASE_FUNC_SINH)
+					t = mpfr_sinh(r, a, GMP_RNDN);
+				else
+					t = mpfr_cosh(r, a, GMP_RNDN);
+				e = ea * exp(upperMagnitude(a) + ea) * boundSlack;
+				break;
+			case SOLLYA_BASE_FUNC_ERF:
+			case SOLLYA_BASE_FUNC_ERFC:
+				// derivatives bounded by 2/sqrt(pi) < 1.13
+				if(node.op == SOLLYA_BASE_FUNC_ERF)
+					t = mpfr_erf(r, a, GMP_RNDN);
+				else
+					t = mpfr_erfc(r, a, GMP_RNDN);
+				e = 1.13 * ea;
+				break;
+			default:
+				return inf;
+			}
+
+			if(!mpfr_number_p(r) || !(e < inf))
+				return inf;
+			error[i] = (e + roundingError(r, t, prec)) * boundSlack;
+		}
+		return error.back();
+	}
+
+
+
+	void FixFunction::evalRange(uint64_t first, uint64_t count, vector<mpz_class> &rNorD, vector<mpz_class> &ru, bool correctlyRounded) const
+	{
+		rNorD.assign(count, mpz_class(0));
+		ru.assign(correctlyRounded ? 0 : count, mpz_class(0));
+
+		// the inputs whose rounding the error bound leaves ambiguous, for Sollya
+		vector<uint64_t> ambiguous;
+		std::mutex ambiguousMutex;
+
+		if(!expression.empty()) {
+			const mpfr_prec_t prec = std::max(64, 2 * wIn + wOut + 40);
+			const uint64_t chunkSize = 1024;
+			const uint64_t chunks = (count + chunkSize - 1) / chunkSize;
+			std::atomic<uint64_t> nextChunk(0);
+
+			auto worker = [&]() {
+				// the MPFR buffers of this thread, reused for all its inputs
+				mpfr_t* values = new mpfr_t[expression.size()];
+				for(size_t i = 0; i < expression.size(); i++)
+					mpfr_init2(values[i], prec);
+				mpfr_t mpX, lo, hi, err;
+				mpfr_init2(mpX, wIn + 2);
+				mpfr_init2(lo, prec + 64);
+				mpfr_init2(hi, prec + 64);
+				mpfr_init2(err, 53);
+				vector<double> error(expression.size());
+				mpz_class low, high;
+				vector<uint64_t> localAmbiguous;
+
+				for(uint64_t k = nextChunk++; k < chunks; k = nextChunk++) {
+					for(uint64_t j = k * chunkSize; j < std::min(count, (k + 1) * chunkSize); j++) {
+						// convert the input to an mpfr_t as eval() does
+						uint64_t i = first + j;
+						mpfr_set_z(mpX, mpz_class((unsigned long)i).get_mpz_t(), GMP_RNDN);
+						if(signedIn && (i >> (-lsbIn)) != 0)
+							mpfr_sub_z(mpX, mpX, mpz_class(mpz_class(1) << wIn).get_mpz_t(), GMP_RNDN);
+						mpfr_div_2si(mpX, mpX, -lsbIn, GMP_RNDN);
+
+						double e = evalExpression(values, error, mpX, prec);
+						if(!(e < INFINITY)) {
+							localAmbiguous.push_back(i);
+							continue;
+						}
+
+						// the exact result, times 2^-lsbOut, is in [lo, hi]
+						mpfr_ptr y = values[expression.size() - 1];
+						mpfr_set_d(err, e, GMP_RNDU);
+						mpfr_sub(lo, y, err, GMP_RNDD);
+						mpfr_add(hi, y, err, GMP_RNDU);
+						mpfr_mul_2si(lo, lo, -lsbOut, GMP_RNDN);
+						mpfr_mul_2si(hi, hi, -lsbOut, GMP_RNDN);
+						if(correctlyRounded) {
+							// ambiguous if lo and hi round to different integers
+							mpfr_get_z(low.get_mpz_t(), lo, GMP_RNDN);
+							mpfr_get_z(high.get_mpz_t(), hi, GMP_RNDN);
+							if(low != high) {
+								localAmbiguous.push_back(i);
+								continue;
+							}
+							if(low < 0)
+								low += (mpz_class(1) << wOut);
+							rNorD[j] = low;
+						}
+						else {
+							// ambiguous if [lo, hi] is not a single point and contains an integer
+							mpfr_get_z(low.get_mpz_t(), lo, GMP_RNDD);
+							mpfr_get_z(high.get_mpz_t(), hi, GMP_RNDD);
+							if(mpfr_cmp(lo, hi) != 0 && (low != high || mpfr_integer_p(lo))) {
+								localAmbiguous.push_back(i);
+								continue;
+							}
+							mpfr_get_z(high.get_mpz_t(), hi, GMP_RNDU);
+							if(low < 0)
+								low += (mpz_class(1) << wOut);
+							if(high < 0)
+								high += (mpz_class(1) << wOut);
+							rNorD[j] = low;
+							ru[j] = high;
+						}
+					}
+				}
+
+				for(size_t i = 0; i < expression.size(); i++)
+					mpfr_clear(values[i]);
+				delete[] values;
+				mpfr_clears(mpX, lo, hi, err, NULL);
+
+				std::lock_guard<std::mutex> lock(ambiguousMutex);
+				ambiguous.insert(ambiguous.end(), localAmbiguous.begin(), localAmbiguous.end());
+			};
+
+			// MPFR may only be used by several threads if it is built thread-safe
+			uint64_t threads = 1;
+			if(mpfr_buildopt_tls_p())
+				threads = std::max(1u, std::thread::hardware_concurrency());
+			threads = std::min(threads, chunks);
+			if(threads <= 1) {
+				worker();
+			}
+			else {
+				vector<std::thread> pool;
+				for(uint64_t t = 0; t < threads; t++)
+					pool.push_back(std::thread(worker));
+				for(auto& t: pool)
+					t.join();
+			}
+		}
+		else {
+			for(uint64_t j = 0; j < count; j++)
+				ambiguous.push_back(first + j);
+		}
+
+		// Sollya is not thread-safe: the remaining inputs are evaluated by this thread
+		mpz_class devnull;
+		for(uint64_t i: ambiguous) {
+			eval(mpz_class((unsigned long)i), rNorD[i - first], (correctlyRounded ? devnull : ru[i - first]), correctlyRounded);
+		}
+	}
+
+
+
 	void FixFunction::emulate(TestCase * tc, bool correctlyRounded){
 			mpz_class x = tc->getInputValue("X");
 			mpz_class rNorD,ru;
@@ -3,6 +3,8 @@
 
 #include <string>
 #include <iostream>
+#include <vector>
+#include <cstdint>
 
 #include <sollya.h>
 #include <gmpxx.h>
@@ -57,6 +59,14 @@ namespace flopoco{
 		*/
 		void eval(mpz_class x, mpz_class &rNorD, mpz_class &ru, bool correctlyRounded=false) const;
 
+		/** evaluates the function on the count inputs from first on, given as bit vectors as for eval(mpz_class...),
+				with the same results as eval() on each of them: rNorD[i] (and ru[i] if not correctlyRounded) is the result for first+i.
+				The inputs are shared among threads, which evaluate the expression of the function with MPFR at a moderate precision,
+				along with a bound on the error of this evaluation.
+				Only the inputs for which this bound leaves the rounding ambiguous are evaluated by Sollya, as eval() does.
+		*/
+		void evalRange(uint64_t first, uint64_t count, vector<mpz_class> &rNorD, vector<mpz_class> &ru, bool correctlyRounded=false) const;
+
 		void emulate(TestCase * tc,	bool correctlyRounded=false /**< if true, correctly rounded RN; if false, faithful function */);
 
 		// All the following public, not good practice I know, but life is complicated enough
@@ -70,6 +80,26 @@ namespace flopoco{
 		string description;
 		sollya_obj_t fS;
 		sollya_obj_t rangeS;
+
+	private:
+		/** A node of the expression of the function, for evalRange(). The operands come before it in expression. */
+		struct ExprNode {
+			int op;             /**< a sollya_base_function_t */
+			int a;              /**< index of the first operand, -1 if none */
+			int b;              /**< index of the second operand, -1 if none */
+			mpz_class mantissa; /**< for a constant, its value is mantissa*2^exponent */
+			long exponent;
+		};
+
+		/** translates fS into expression. It stays empty if fS uses a function for which evalRange() has no error bound. */
+		void compileExpression();
+		/** appends the nodes of nodeS to expression, returns the index of its root or -1 */
+		int compileNode(sollya_obj_t nodeS);
+		/** evaluates expression on x, in values[i] for node i, with prec bits, and bounds its error in error[i].
+				Returns the bound for the root, infinite if there is none. */
+		double evalExpression(mpfr_t* values, vector<double> &error, mpfr_t x, mpfr_prec_t prec) const;
+
+		vector<ExprNode> expression;
 	};
 
 }
@@ -17,6 +17,9 @@
 #include <sstream>
 #include <vector>
 #include <cmath> //for abs(double)
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
 #include <gmp.h>
 #include <gmpxx.h>
@@ -29,6 +32,7 @@
 #include "../utils.hpp"
 #include "FixFunctionByMultipartiteTable.hpp"
 #include "Multipartite.hpp"
+#include "ApproximationCache.hpp"
 #include "../BitHeap/BitHeap.hpp"
 #include "../Table.hpp"
 
@@ -92,84 +96,102 @@ namespace flopoco
 		}
 
 
-		// Outer loop on guardBitSlack;
-		guardBitsSlack =-1; // first  try the exploration with one guard bit less than the safe value
+		// The decomposition only depends on the function and the parameters: look for it in the approximation cache first
 		Multipartite* bestMP;
-		bool successWithguardBitsSlack = false;
-		int rank;
-		while (guardBitsSlack<=0 && !successWithguardBitsSlack) {
-
-			bool decompositionFound;
-			if(nbTOi==0) {
-				// The following is not as clean as it should be because the code was first written with nbTOi a global variable...
-				nbTOi=1;
-				decompositionFound=true;
-				while (decompositionFound) {
-					REPORT(INFO, "Exploring nbTO=" << nbTOi);
+		string cacheKey = ApproximationCache::keyDescription("FixFunctionByMultipartiteTable", f->fS, signedIn_, lsbIn_, msbOut_, lsbOut_, -1, 0,
+																												 {join("nbTOi=", nbTOi_), join("compressTIV=", compressTIV)});
+		string cacheValue;
+		if(ApproximationCache::lookup(cacheKey, cacheValue) && (bestMP = readFromCache(cacheValue)) != nullptr) {
+			REPORT(INFO, "Decomposition found in the approximation cache:" << endl << tab << bestMP->descriptionString());
+			delete topTen[0];
+			topTen[0] = bestMP; // so that it is deleted with the others
+			bestMP->mkTables(target);
+		}
+		else {
+			// Outer loop on guardBitSlack;
+			guardBitsSlack =-1; // first  try the exploration with one guard bit less than the safe value
+			bool successWithguardBitsSlack = false;
+			int rank;
+			while (guardBitsSlack<=0 && !successWithguardBitsSlack) {
+
+				bool decompositionFound;
+				if(nbTOi==0) {
+					// The following is not as clean as it should be because the code was first written with nbTOi a global variable...
+					nbTOi=1;
+					decompositionFound=true;
+					while (decompositionFound) {
+						REPORT(INFO, "Exploring nbTO=" << nbTOi);
+						buildOneTableError();
+						buildGammaiMin();
+						decompositionFound = enumerateDec(); 
+						if(!decompositionFound)
+							REPORT(INFO, "No decomposition found for nbTOi=" << nbTOi << ", stopping search.");
+						nbTOi ++;
+					}
+					if(topTen[0]->totalSize == sizeMax) {
+						THROWERROR("\nSorry, the multipartite method doesn't seem to work for this function. \nTry another of the FixFunction* operators. At least FixFunctionByTable should work...");
+					}
+				}
+				else	{ // nbTOi was given
+	 				// build the required tables of errors
 					buildOneTableError();
 					buildGammaiMin();
-					decompositionFound = enumerateDec(); 
+					decompositionFound = enumerateDec();
 					if(!decompositionFound)
-						REPORT(INFO, "No decomposition found for nbTOi=" << nbTOi << ", stopping search.");
-					nbTOi ++;
+						THROWERROR("No decomposition found for nbTOi=" << nbTOi << ", aborting");
 				}
-				if(topTen[0]->totalSize == sizeMax) {
-					THROWERROR("\nSorry, the multipartite method doesn't seem to work for this function. \nTry another of the FixFunction* operators. At least FixFunctionByTable should work...");
-				}
-			}
-			else	{ // nbTOi was given
- 				// build the required tables of errors
-				buildOneTableError();
-				buildGammaiMin();
-				decompositionFound = enumerateDec();
-				if(!decompositionFound)
-					THROWERROR("No decomposition found for nbTOi=" << nbTOi << ", aborting");
-			}
 
-			// Parameter space exploration complete. Now checking the results
-			rank = 0 ;
-			bool tryAgain = true;
-			while (rank < ten && tryAgain) {
-				// time to report
-				bestMP = topTen[rank];
-				if(bestMP->totalSize==sizeMax) { // This is one of the dummy mpts
-					tryAgain=false;
-				}
-				else {						
-					REPORT(INFO, "Now running exhaustive test on candidate #" << rank << " :" << endl
-								 << tab << bestMP->descriptionString() << endl
-								 << tab<< bestMP->descriptionStringLaTeX()  );
-					bestMP->mkTables(target);
-					if (bestMP->exhaustiveTest()) {
-						REPORT(INFO, "... passed, now building the operator");
-						tryAgain = false;
+				// Parameter space exploration complete. Now checking the results
+				rank = 0 ;
+				bool tryAgain = true;
+				while (rank < ten && tryAgain) {
+					// time to report
+					bestMP = topTen[rank];
+					if(bestMP->totalSize==sizeMax) { // This is one of the dummy mpts
+						tryAgain=false;
 					}
-					else {
-						REPORT(INFO, "... failed, trying next candidate");
-						rank++;
+					else {						
+						REPORT(INFO, "Now running exhaustive test on candidate #" << rank << " :" << endl
+									 << tab << bestMP->descriptionString() << endl
+									 << tab<< bestMP->descriptionStringLaTeX()  );
+						bestMP->mkTables(target);
+						if (bestMP->exhaustiveTest()) {
+							REPORT(INFO, "... passed, now building the operator");
+							tryAgain = false;
+						}
+						else {
+							REPORT(INFO, "... failed, trying next candidate");
+							rank++;
+						}
 					}
 				}
-			}
 				
-			if(rank==ten || bestMP->totalSize==sizeMax) {
-				REPORT(INFO, "It seems we have to use the safe value of g... starting again");
-				for (int i=0; i<ten; i++){
-					topTen[i]-> totalSize =	sizeMax; 
+				if(rank==ten || bestMP->totalSize==sizeMax) {
+					REPORT(INFO, "It seems we have to use the safe value of g... starting again");
+					for (int i=0; i<ten; i++){
+						topTen[i]-> totalSize =	sizeMax; 
+					}
+					guardBitsSlack ++;
+					//REPORT(0,"guardBitsSlack now " << guardBitsSlack);
+					nbTOi=nbTOi_;
+				}
+				else {
+					successWithguardBitsSlack=true;
 				}
-				guardBitsSlack ++;
-				//REPORT(0,"guardBitsSlack now " << guardBitsSlack);
-				nbTOi=nbTOi_;
-			}
-			else {
-				successWithguardBitsSlack=true;
 			}
-		}
 
-		if(guardBitsSlack>0)
-			THROWERROR("Unable to reach faithful rounding with this value of NbTOi");
-		// Exploration complete. Now building the operator
+			if(guardBitsSlack>0)
+				THROWERROR("Unable to reach faithful rounding with this value of NbTOi");
+			// Exploration complete. Now building the operator
+
+			bestMP = topTen[rank];
 
-		bestMP = topTen[rank];
+			ostringstream entry;
+			entry << bestMP->m << " " << bestMP->alpha << " " << bestMP->beta << " " << bestMP->guardBits << endl;
+			for (int i=0; i<bestMP->m; i++)
+				entry << bestMP->gammai[i] << " " << bestMP->betai[i] << endl;
+			ApproximationCache::store(cacheKey, entry.str());
+		}
 
 		REPORT(DEBUG,"Full table dump:" <<endl << bestMP->fullTableDump()); 
 
@@ -289,6 +311,34 @@ namespace flopoco
 		f->emulate(tc);
 	}
 
+	//------------------------------------------------------------------------------------ Private methods
+
+	Multipartite* FixFunctionByMultipartiteTable::readFromCache(string value)
+	{
+		istringstream s(value);
+		int m, alpha, beta, guardBits;
+		if(!(s >> m >> alpha >> beta >> guardBits) || m < 1 || alpha < 1 || alpha > f->wIn)
+			return nullptr;
+		vector<int> gammai(m), betai(m);
+		int sumBetai = 0;
+		for (int i=0; i<m; i++) {
+			if(!(s >> gammai[i] >> betai[i]) || gammai[i] < 1 || gammai[i] > alpha || betai[i] < 2)
+				return nullptr;
+			sumBetai += betai[i];
+		}
+		if(sumBetai != beta || alpha + beta != f->wIn)
+			return nullptr;
+
+		// the Multipartite constructor computes the approximation error out of the table of errors
+		nbTOi = m;
+		buildOneTableError();
+		Multipartite* mp = new Multipartite(f, m, alpha, beta, gammai, betai, this);
+		mp->guardBits = guardBits;
+		mp->buildGuardBitsAndSizes(false);
+		return mp;
+	}
+
+
 	//------------------------------------------------------------------------------------ Private classes
 	
 	// enumerating the alphas is much simpler
@@ -539,7 +589,6 @@ namespace flopoco
 #else // only betai=2 or 3 is useful
 	bool FixFunctionByMultipartiteTable::enumerateDec()
 	{
-		Multipartite *mpt;
 		int beta, p;
 		int n = f->wIn;
 		int alphamin = n/3;
@@ -547,41 +596,85 @@ namespace flopoco
 		vector<vector<int>> betaEnum;
 		vector<vector<int>> alphaEnum;
 		vector<int> gammaimin;
-		vector<int> gammai;
-		vector<int> betai;
 
-		int sizeMax = f->wOut <<f->wIn; // size of a plain table
+		std::atomic<bool> decompositionFound(false);
+
+		// The sizes of the ten best decompositions found so far: a decomposition larger than the last one is hopeless
+		vector<int> bestSizes;
+		for (int i=0; i<ten; i++)
+			bestSizes.push_back(topTen[i]->totalSize);
+		std::atomic<int> sizeBound(bestSizes.back());
+		std::mutex bestSizesMutex;
+
+		// Only the few evaluations of f missing from fValues are serialized
+		unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
 
-		bool decompositionFound=false;
-		
 		for (int alpha = alphamin; alpha <= alphamax; alpha++)		{
+			// The decompositions for this alpha, in the order of the sequential exploration
+			vector<vector<int>> candidateBetai, candidateGammai;
 			beta = n-alpha;
 			betaEnum = betaenum(beta, nbTOi);
 			for(unsigned int e = 0; e < betaEnum.size(); e++) {
-				betai = betaEnum[e];
-
 				gammaimin = vector<int>(nbTOi);
 				p = 0;
 				for(int i = nbTOi-1; i >= 0; i--) {
-					gammaimin[i] = gammaiMin[p][betai[i]];
-					p += betai[i];
+					gammaimin[i] = gammaiMin[p][betaEnum[e][i]];
+					p += betaEnum[e][i];
 				}
 
 				alphaEnum = alphaenum(alpha,nbTOi,gammaimin);
 				for(unsigned int ae = 0; ae < alphaEnum.size(); ae++)		{
-					gammai = alphaEnum[ae];
-					mpt = new Multipartite(f, nbTOi,
-																 alpha, beta,
-																 gammai, betai, this);
-					if(mpt->mathError < epsilonT){
-						decompositionFound=true;
-						mpt->buildGuardBitsAndSizes();
-						insertInTopTen(mpt);
+					candidateBetai.push_back(betaEnum[e]);
+					candidateGammai.push_back(alphaEnum[ae]);
+				}
+			}
+
+			// Evaluate them in parallel
+			size_t candidates = candidateBetai.size();
+			vector<Multipartite*> results(candidates, nullptr);
+			std::atomic<size_t> next(0);
+			auto worker = [&]() {
+				for(size_t c = next++; c < candidates; c = next++) {
+					Multipartite* mpt = new Multipartite(f, nbTOi,
+																							 alpha, beta,
+																							 candidateGammai[c], candidateBetai[c], this);
+					if(mpt->mathError >= epsilonT) {
+						delete mpt;
+						continue;
+					}
+					decompositionFound = true;
+					mpt->buildGuardBitsAndSizes(true, sizeBound);
+					if(mpt->totalSize > sizeBound) {
+						delete mpt;
+						continue;
+					}
+					results[c] = mpt;
+					std::lock_guard<std::mutex> lock(bestSizesMutex);
+					if(mpt->totalSize < bestSizes.back()) {
+						bestSizes.back() = mpt->totalSize;
+						sort(bestSizes.begin(), bestSizes.end());
+						sizeBound = bestSizes.back();
 					}
-					else
-						mpt->totalSize = sizeMax;
 				}
+			};
+			size_t poolSize = std::min<size_t>(threads, candidates);
+			if(poolSize <= 1) {
+				worker();
+			}
+			else {
+				vector<std::thread> pool;
+				for(size_t t = 0; t < poolSize; t++)
+					pool.push_back(std::thread(worker));
+				for(auto& t: pool)
+					t.join();
 			}
+
+			// Insert them in the sequential order, so that ties are broken as in a sequential exploration
+			for(auto mpt: results) {
+				if(mpt != nullptr && !insertInTopTen(mpt))
+					delete mpt;
+			}
+
 			// exit this loop as soon as 2^alpha > best totalSize
 			if( (f->wOut << (alpha+1)) > topTen[0]->totalSize)
 				alpha =  alphamax+1 ; // exit
@@ -624,6 +717,18 @@ namespace flopoco
 	}
 
 
+	double FixFunctionByMultipartiteTable::evalF(double x)
+	{
+		std::lock_guard<std::mutex> lock(fValuesMutex);
+		auto it = fValues.find(x);
+		if(it != fValues.end())
+			return it->second;
+		double y = f->eval(x);
+		fValues[x] = y;
+		return y;
+	}
+
+
 	/** eq 11 */
 	double FixFunctionByMultipartiteTable::errorForOneTable(int pi, int betai, int gammai)
 	{
@@ -654,7 +759,7 @@ namespace flopoco
 	}
 
 	
-	void  FixFunctionByMultipartiteTable::insertInTopTen(Multipartite* mp) {
+	bool  FixFunctionByMultipartiteTable::insertInTopTen(Multipartite* mp) {
 		REPORT(DEBUG, "Entering  insertInTopTen");
 		int rank=ten-1;
 		Multipartite* current = topTen[rank];
@@ -675,7 +780,9 @@ namespace flopoco
 			//debug
 			for (rank=0; rank<ten; rank++)
 				REPORT(DETAILED, "top "<< rank << " size is " << topTen[rank]->totalSize);
+			return true;
 		}
+		return false;
 	}
 
 
@@ -8,6 +8,8 @@
 #include <gmpxx.h>
 
 #include <vector>
+#include <map>
+#include <mutex>
 
 using namespace std;
 
@@ -71,6 +73,12 @@ namespace flopoco
 		 */
 		bool enumerateDec();
 
+		/**
+		 * @brief readFromCache : rebuilds the decomposition stored in the ApproximationCache, which passed the exhaustive test when it was stored
+		 * @return the decomposition, or nullptr if the value is inconsistent
+		 */
+		Multipartite* readFromCache(string value);
+
 
 		/** Some needed methods, extracted from the article */
 
@@ -85,6 +93,12 @@ namespace flopoco
 		double epsilon(int ci_, int gammai, int betai, int pi);
 		double epsilon2ndOrder(int Ai, int gammai, int betai, int pi);
 
+		/**
+		 * @brief evalF : f->eval(x), memoized because the exploration evaluates f at the same few points for many decompositions.
+		 * Unlike f->eval(), it may be called by several threads at once.
+		 */
+		double evalF(double x);
+
 
 		FixFunction *f;
 		double epsilonT;
@@ -93,12 +107,15 @@ namespace flopoco
 		bool compressTIV; /**< use Hsiao TIV compression or not */
 		vector<vector<vector<double>>> oneTableError;   /** for nbTOi fixed, the errors of each possible table configuration, precomputed  here to speed up exploration  */
 		vector<vector<int>> gammaiMin;  /** for nbTOi fixed, the min value of gamma, precomputed  here to speed up exploration */
+		map<double, double> fValues;  /**< the values of f already computed by evalF */
+		std::mutex fValuesMutex;  /**< protects fValues, and serializes the calls to Sollya, which is not thread-safe */
 
 	private:
 		const int ten=10;
 		vector<Multipartite*> topTen; /**< the top 10 best candidates (for some value of ten), sorted by size */ 
 		int guardBitsSlack; /* this allows first to try the exploration with one guard bit less than the safe value */ 
-		void insertInTopTen(Multipartite* mp);
+		/** @return true if mp was inserted, false if it is not in the top ten (it is then up to the caller to delete it) */
+		bool insertInTopTen(Multipartite* mp);
 	};
 
 }
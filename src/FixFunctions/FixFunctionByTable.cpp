@@ -37,14 +37,15 @@ namespace flopoco{
 			THROWERROR("lsbIn limited to -30 (a table with 1O^9 entries should be enough for anybody). Do you really want me to write a source file of "
 								 << wOut * (mpz_class(1) << wIn) << " bytes?");
 		}
-		vector<mpz_class> v;
-		for(int i=0; i<(1<<wIn); i++) {
-			mpz_class rn, devnull;
-			f->eval(mpz_class(i), rn, devnull, true);
-			v.push_back(rn);
-			//cerr <<   f-> getDescription()<< " : f("<< i << ") = " << rn <<endl;
-		};
+		vector<mpz_class> v, devnull;
+		f->evalRange(0, 1<<wIn, v, devnull, true);
 		Table::init(v, join("f", getNewUId()), wIn, wOut);
+
+		if(wOut <= 64) {
+			fastValues.resize(v.size());
+			for(size_t i=0; i<v.size(); i++)
+				mpz_export(&fastValues[i], nullptr, -1, sizeof(uint64_t), 0, 0, v[i].get_mpz_t());
+		}
 	}
 
 
@@ -59,6 +60,14 @@ namespace flopoco{
 		f->emulate(tc, true /* correct rounding */);
 	}
 
+	bool FixFunctionByTable::hasEmulateFast(){
+		return !fastValues.empty();
+	}
+
+	void FixFunctionByTable::emulateFast(FastTestCase* tc){
+		tc->addExpectedOutput(0, fastValues[tc->getInput(0)]);
+	}
+
 	OperatorPtr FixFunctionByTable::parseArguments(OperatorPtr parentOp, Target *target, vector<string> &args)
 	{
 		bool signedIn;
@@ -24,6 +24,10 @@ namespace flopoco{
 
 		void emulate(TestCase * tc);
 
+		/** Reads the correctly rounded value from the table contents, for outputs up to 64 bits */
+		void emulateFast(FastTestCase * tc);
+		bool hasEmulateFast();
+
 		/** Factory method that parses arguments and calls the constructor */
 		static OperatorPtr parseArguments(OperatorPtr parentOp, Target *target , vector<string> &args);
 
@@ -34,6 +38,7 @@ namespace flopoco{
 
 		FixFunction *f;
 		unsigned wR;
+		vector<uint64_t> fastValues; /**< the table contents as native integers, empty if wOut>64 */
 	};
 
 }
@@ -104,10 +104,10 @@ namespace flopoco
 				+ (f->signedIn ? 2 : 1) * intpow2(-gammai[i])  * ((double)Ai);
 		double xright= (f->signedIn ? -1 : 0) + (f->signedIn ? 2 : 1) * ((intpow2(-gammai[i]) * ((double)Ai+1)) - intpow2(-wi+pi[i]+betai[i]));
 		double delta = deltai(i);
-		double si =  (f->eval(xleft + delta)
-					  - f->eval(xleft)
-					  + f->eval(xright+delta)
-					  - f->eval(xright) )    / (2*delta);
+		double si =  (mpt->evalF(xleft + delta)
+					  - mpt->evalF(xleft)
+					  + mpt->evalF(xright+delta)
+					  - mpt->evalF(xright) )    / (2*delta);
 		return si;
 	}
 
@@ -240,7 +240,7 @@ namespace flopoco
 
 	//------------------------------------------------------------------------------------- Public methods
 
-	void Multipartite::buildGuardBitsAndSizes(bool computeGuardBits)
+	void Multipartite::buildGuardBitsAndSizes(bool computeGuardBits, int sizeBound)
 	{
 
 		if(computeGuardBits) {
@@ -251,6 +251,16 @@ namespace flopoco
 		}
 		
 		sizeTIV = (outputSize + guardBits)<<alpha;
+		// A lower bound of the TIV size that needs no evaluation of f. A compressed TIV has at least 2^2 entries in the ATIV,
+		// and each LSB saved in the ATIV costs at least one bit in the 2^alpha entries of the DiffTIV (see computeTIVCompressionParameters)
+		int sizeTIVMin = sizeTIV;
+		if(mpt->compressTIV)
+			sizeTIVMin = min(sizeTIV, (outputSize + guardBits + 1)<<2);
+		if(sizeTIVMin > sizeBound) {
+			totalSize = sizeTIVMin;
+			return;
+		}
+
 		int size = sizeTIV;
 		outputSizeTOi = vector<int>(m);
 		sizeTOi = vector<int>(m);
@@ -259,6 +269,10 @@ namespace flopoco
 			size += sizeTOi[i];
 		}
 		totalSize = size;
+		if(size - sizeTIV + sizeTIVMin > sizeBound) { // no need to look for the TIV compression parameters
+			totalSize = size - sizeTIV + sizeTIVMin;
+			return;
+		}
 
 		if(mpt->compressTIV)
 			computeTIVCompressionParameters(); // may change sizeTIV and totalSize
@@ -400,8 +414,8 @@ namespace flopoco
 		double xVal = (f->signedIn ? -1 : 0) + (f->signedIn ? 2 : 1) * x * intpow2(-alpha);
 		// we compute the function at the left and at the right of
 		// the interval
-		yl = f->eval(xVal) * intpow2(f->lsbIn - f->lsbOut) * intpow2(inputSize - outputSize);
-		yr = f->eval(xVal+offsetX) * intpow2(f->lsbIn - f->lsbOut) * intpow2(inputSize - outputSize);
+		yl = mpt->evalF(xVal) * intpow2(f->lsbIn - f->lsbOut) * intpow2(inputSize - outputSize);
+		yr = mpt->evalF(xVal+offsetX) * intpow2(f->lsbIn - f->lsbOut) * intpow2(inputSize - outputSize);
 
 		// and we take the mean of these values
 		y =  0.5 * (yl + yr);
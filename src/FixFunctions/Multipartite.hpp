@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <map>
+#include <climits>
 
 #include "FixFunction.hpp"
 #include "../Operator.hpp"
@@ -31,8 +32,10 @@ namespace flopoco
 
 		/**
 		 * @brief buildGuardBitsAndSizes : Builds decomposition's guard bits and tables sizes
+		 * @param sizeBound : the sizes are not computed further as soon as a lower bound of totalSize exceeds sizeBound:
+		 * totalSize is then only this lower bound, which is enough to tell that this decomposition is worse than a known one
 		 */
-		void buildGuardBitsAndSizes(bool computeGuardBits=true);
+		void buildGuardBitsAndSizes(bool computeGuardBits=true, int sizeBound=INT_MAX);
 
 		/**
 		 * @brief mkTables : fill  the TIV and TOs tables
@@ -25,9 +25,14 @@
 
 */
 #include "PiecewisePolyApprox.hpp"
+#include "SollyaWorkers.hpp"
+#include "ApproximationCache.hpp"
 #include <sstream>
+#include <iomanip>
+#include <cstdlib>
 #include <limits.h>
 #include <float.h>
+#include <algorithm>
 
 namespace flopoco{
 
@@ -91,13 +96,15 @@ namespace flopoco{
 	// split into smaller and smaller intervals until the function can be approximated by a polynomial of degree given by degree.
 	void PiecewisePolyApprox::build()
 	{
-		ostringstream cacheFileName;
-		cacheFileName << "PiecewisePoly_"<<vhdlize(f->description) << "_" << degree << "_" << targetAccuracy << ".cache";
-
-		// Test existence of cache file, create it if necessary
-		openCacheFile(cacheFileName.str());
+		string cacheKey = ApproximationCache::keyDescription("PiecewisePolyApprox", f->fS, f->signedIn, 0, 0, 0, degree, targetAccuracy);
+		string cacheValue;
+		bool cached = ApproximationCache::lookup(cacheKey, cacheValue);
+		if(cached) {
+			istringstream s(cacheValue);
+			cached = readFromCache(s);
+		}
 
-		if(!cacheFile.is_open())
+		if(!cached)
 		{
 			//********************** Do the work, then write the cache *********************
 			sollya_obj_t fS = f->fS; // no need to free this one
@@ -110,38 +117,37 @@ namespace flopoco{
 
 			// Limit alpha to 24, because alpha will be the number of bits input to a table
 			// it will take too long before that anyway
+			// The intervals of an alpha are tested in parallel; the first one that fails aborts the others.
 			bool alphaOK;
 			for (alpha=0; alpha<24; alpha++)
 			{
 				nbIntervals = 1<<alpha;
-				alphaOK = true;
 				REPORT(DETAILED, " Testing alpha=" << alpha );
-				for (int i=0; i<nbIntervals; i++) {
-					// The worst case is typically on the left (i==0) or on the right (i==nbIntervals-1).
-					// To test these two first, we do this small rotation of i
-					int ii=(i+nbIntervals-1) & ((1<<alpha)-1);
-
-					// First build g_i(x) = f(2^(-alpha)*x + i*2^(-alpha))
-					sollya_obj_t giS = buildSubIntervalFunction(fS, alpha, ii);
-
-					if(DEBUG <= UserInterface::verbose)
-						sollya_lib_printf("> PiecewisePolyApprox: alpha=%d, ii=%d, testing  %b \n", alpha, ii, giS);
-					// Now what degree do we need to approximate gi?
-					int degreeInf, degreeSup;
-					BasicPolyApprox::guessDegree(giS, rangeS, targetAccuracy, &degreeInf, &degreeSup);
-					// REPORT(DEBUG, " guessDegree returned (" << degreeInf <<  ", " << degreeSup<<")" ); // no need to report, it is done by guessDegree()
-					sollya_lib_clear_obj(giS);
-					// For now we only consider degreeSup. Is this a TODO?
-					if(degreeSup>degree) {
-						REPORT(DEBUG, "   alpha=" << alpha << " failed." );
-						alphaOK=false;
-						break;
-					}
-				} // end for loop on i
+				vector<string> results;
+				alphaOK = runInSollyaWorkers(nbIntervals, [&](int i, bool &abort) {
+						// The worst case is typically on the left (i==0) or on the right (i==nbIntervals-1).
+						// To test these two first, we do this small rotation of i
+						int ii=(i+nbIntervals-1) & ((1<<alpha)-1);
+
+						// First build g_i(x) = f(2^(-alpha)*x + i*2^(-alpha))
+						sollya_obj_t giS = buildSubIntervalFunction(fS, alpha, ii);
+
+						if(DEBUG <= UserInterface::verbose)
+							sollya_lib_printf("> PiecewisePolyApprox: alpha=%d, ii=%d, testing  %b \n", alpha, ii, giS);
+						// Now what degree do we need to approximate gi?
+						int degreeInf, degreeSup;
+						BasicPolyApprox::guessDegree(giS, rangeS, targetAccuracy, &degreeInf, &degreeSup);
+						// REPORT(DEBUG, " guessDegree returned (" << degreeInf <<  ", " << degreeSup<<")" ); // no need to report, it is done by guessDegree()
+						sollya_lib_clear_obj(giS);
+						// For now we only consider degreeSup. Is this a TODO?
+						abort = (degreeSup>degree);
+						return to_string(degreeSup);
+					}, results);
 
 				// Did we succeed?
 				if (alphaOK)
 					break;
+				REPORT(DEBUG, "   alpha=" << alpha << " failed." );
 			} // end for loop on alpha
 
 			if (alphaOK)
@@ -164,70 +170,78 @@ namespace flopoco{
 			bool success=false;
 			while(!success) {
 				// Now fill the vector of polynomials, computing the coefficient parameters along.
-				//		LSB=INT_MAX; // very large
-				// MSB=INT_MIN; // very small
-				approxErrorBound = 0.0;
-				BasicPolyApprox *p;
-
-				REPORT(DETAILED, "Computing the actual polynomials ");
-				// initialize the vector of MSB weights
-				for (int j=0; j<=degree; j++) {
-					MSB.push_back(INT_MIN);
+				// The polynomials are computed in parallel, and the first one that is not accurate enough aborts the others.
+				// poly[i] is NULL for the intervals still to compute: the accurate polynomials of a failed attempt are kept when only LSB moves down.
+				poly.resize(nbIntervals, NULL);
+				vector<int> todo;
+				for (int i=0; i<nbIntervals; i++) {
+					if(poly[i]==NULL)
+						todo.push_back(i);
 				}
 
-				for (int i=0; i<nbIntervals; i++) {
-					REPORT(DETAILED, " ... computing polynomial approx for interval " << i << " / "<< nbIntervals);
-					// Recompute the substitution. No big deal.
-					sollya_obj_t giS = buildSubIntervalFunction(fS, alpha, i);
+				REPORT(DETAILED, "Computing the actual polynomials for " << todo.size() << " intervals");
+				vector<string> results;
+				runInSollyaWorkers(todo.size(), [&](int k, bool &abort) {
+						int i = todo[k];
+						REPORT(DETAILED, " ... computing polynomial approx for interval " << i << " / "<< nbIntervals);
+						sollya_obj_t giS = buildSubIntervalFunction(fS, alpha, i);
+						BasicPolyApprox *p = new BasicPolyApprox(giS, degree, LSB, true);
+						abort = (p->approxErrorBound >= targetAccuracy);
+						ostringstream s;
+						p->write(s);
+						delete p;
+						return s.str();
+					}, results);
 
-					p = new BasicPolyApprox(giS, degree, LSB, true);
-					poly.push_back(p);
-					if (approxErrorBound < p->approxErrorBound){
+				approxErrorBound = 0.0;
+				for (size_t k=0; k<todo.size(); k++) {
+					if(results[k] != "") {
+						istringstream s(results[k]);
+						poly[todo[k]] = new BasicPolyApprox(s);
+					}
+				}
+				for (auto p: poly) {
+					if (p!=NULL && approxErrorBound < p->approxErrorBound){
 						REPORT(DEBUG, "   new approxErrorBound=" << p->approxErrorBound );
 						approxErrorBound = p->approxErrorBound;
 					}
-					if (approxErrorBound>targetAccuracy){
-						break;
-					}
-
-					// Now compute the englobing MSB for each coefficient
-					for (int j=0; j<=degree; j++) {
-						// if the coeff is zero, we can set its MSB to anything, so we exclude this case
-						if (  (!p->coeff[j]->isZero())  &&  (p->coeff[j]->MSB > MSB[j])  )
-							MSB[j] = p->coeff[j]->MSB;
-					}
-					
-					// Now set the MSB and LSB of the zero coefficients, for consistency
-					// This prevents a future crash in this case
-					for (int j=0; j<=degree; j++) {
-						// if the coeff is zero, we can set its MSB to anything, so we exclude this case
-						if (p->coeff[j]->isZero()) {
-							p->coeff[j]->MSB = MSB[j]; // before that it was set arbitrary to 1
-							p->coeff[j]->LSB = LSB; // before that it was set arbitrary to 0
-							p->coeff[j]->width = MSB[j]-LSB+1;
-						}
-					}
-					
-				} // end for loop on i
+				}
 
-				if (approxErrorBound < targetAccuracy) {
+				if (approxErrorBound < targetAccuracy && find(poly.begin(), poly.end(), (BasicPolyApprox*)NULL) == poly.end()) {
 					REPORT(INFO, " *** Success! Final approxErrorBound=" << approxErrorBound << "  is smaller than target accuracy: " << targetAccuracy  );
 					success=true;
 				}
 				else {
 					REPORT(INFO, "Measured approx error:" << approxErrorBound << " is larger than target accuracy: " << targetAccuracy
 							<< ". Increasing LSB and starting over. Thank you for your patience");
-					//empty poly
-					for (auto i:poly)
-						free(i);
-					while(!poly.empty())
-						poly.pop_back();
-
 					if(lsbAttempts<=lsbAttemptsMax) {
 						lsbAttempts++;
 						LSB--;
+						// The accurate polynomials remain accurate with one more LSB bit: only the others are recomputed.
+						// Which intervals were computed before the abort depends on the timing of the workers,
+						// so only those before the first failing one are kept, as they are always computed.
+						int firstFailing = 0;
+						while (firstFailing<nbIntervals && poly[firstFailing]!=NULL && poly[firstFailing]->approxErrorBound < targetAccuracy)
+							firstFailing++;
+						for (int i=0; i<nbIntervals; i++) {
+							if (i>=firstFailing) {
+								delete poly[i];
+								poly[i] = NULL;
+							}
+							else {
+								poly[i]->LSB = LSB;
+								for (int j=0; j<=degree; j++) {
+									if (!poly[i]->coeff[j]->isZero())
+										poly[i]->coeff[j]->changeLSB(LSB);
+								}
+							}
+						}
 					}
 					else {
+						//empty poly
+						for (auto i:poly)
+							delete i;
+						poly.clear();
 						LSB+=lsbAttempts;
 						lsbAttempts=0;
 						alpha++;
@@ -237,6 +251,28 @@ namespace flopoco{
 				}
 			} // end while(!success)
 
+			// Now compute the englobing MSB for each coefficient
+			MSB.assign(degree+1, INT_MIN);
+			for (int i=0; i<nbIntervals; i++) {
+				for (int j=0; j<=degree; j++) {
+					// if the coeff is zero, we can set its MSB to anything, so we exclude this case
+					if (  (!poly[i]->coeff[j]->isZero())  &&  (poly[i]->coeff[j]->MSB > MSB[j])  )
+						MSB[j] = poly[i]->coeff[j]->MSB;
+				}
+			}
+
+			// Now set the MSB and LSB of the zero coefficients, for consistency
+			// This prevents a future crash in this case
+			for (int i=0; i<nbIntervals; i++) {
+				for (int j=0; j<=degree; j++) {
+					if (poly[i]->coeff[j]->isZero()) {
+						poly[i]->coeff[j]->MSB = MSB[j]; // before that it was set arbitrary to 1
+						poly[i]->coeff[j]->LSB = LSB; // before that it was set arbitrary to 0
+						poly[i]->coeff[j]->width = MSB[j]-LSB+1;
+					}
+				}
+			}
+
 			// Now we need to resize all the coefficients of degree i to the largest one
 			// TODO? we could also check if one of the coeffs is always positive or negative, and optimize generated code accordingly
 			for (int i=0; i<nbIntervals; i++) {
@@ -247,17 +283,17 @@ namespace flopoco{
 				}
 			}
 
-			// Write the cache file
-			writeToCacheFile(cacheFileName.str());
+			// Write the cache entry
+			ostringstream s;
+			writeToCache(s);
+			ApproximationCache::store(cacheKey, s.str());
 
 			//cleanup the sollya objects
 			sollya_lib_clear_obj(rangeS);
 		}
 		else
 		{
-			REPORT(INFO, "Polynomial data cache found: " << cacheFileName.str());
-			//********************** Just read the cache *********************
-			readFromCacheFile(cacheFileName.str());
+			REPORT(INFO, "Polynomial data found in the approximation cache");
 		} // end if cache
 
 		// Check if all the coefficients of a given degree are of the same sign
@@ -282,78 +318,44 @@ namespace flopoco{
 	}
 
 
-	void PiecewisePolyApprox::openCacheFile(string cacheFileName)
+	void PiecewisePolyApprox::writeToCache(ostream &s)
 	{
-		cacheFile.open(cacheFileName.c_str(), ios::in);
-
-		// check for bogus .cache file
-		if(cacheFile.is_open() && cacheFile.peek() == std::ifstream::traits_type::eof())
-		{
-			cacheFile.close();
-			std::remove(cacheFileName.c_str());
-			cacheFile.open(cacheFileName.c_str(), ios::in); // of course this one will fail
-		}
-	}
-
-
-	void PiecewisePolyApprox::writeToCacheFile(string cacheFileName)
-	{
-		cacheFile.open(cacheFileName.c_str(), ios::out);
-
-		cacheFile << "Polynomial data cache for " << cacheFileName << endl;
-		cacheFile << "Erasing this file is harmless, but do not try to edit it." <<endl;
-
-		cacheFile << degree <<endl;
-		cacheFile << alpha <<endl;
-		cacheFile << LSB <<endl;
-
+		s << alpha << " " << LSB << " " << setprecision(17) << approxErrorBound << endl;
 		for (int j=0; j<=degree; j++) {
-			cacheFile << MSB[j] << endl;
+			s << MSB[j] << endl;
 		}
 
-		cacheFile << approxErrorBound << endl;
-
-		// now write the coefficients themselves
-		for(int i=0; i<(1<<alpha); i++)
-		{
-			for (int j=0; j<=degree; j++)
-			{
-				cacheFile <<  poly[i] -> coeff[j] -> getBitVectorAsMPZ() << endl;
-			}
+		// now write the polynomials themselves
+		for(int i=0; i<(1<<alpha); i++) {
+			poly[i]->write(s);
 		}
 	}
 
 
-	void PiecewisePolyApprox::readFromCacheFile(string cacheFileName)
+	bool PiecewisePolyApprox::readFromCache(istream &s)
 	{
-		string line;
-
-		getline(cacheFile, line); // ignore the first line which is a comment
-		getline(cacheFile, line); // ignore the second line which is a comment
-
-		cacheFile >> degree;
-		cacheFile >> alpha;
+		string error;
+		if(!(s >> alpha >> LSB >> error) || alpha < 0 || alpha >= 24)
+			return false;
 		nbIntervals = 1<<alpha;
-		cacheFile >> LSB;
-
+		approxErrorBound = strtod(error.c_str(), NULL);
+		MSB.assign(degree+1, 0);
 		for (int j=0; j<=degree; j++) {
-			int msb;
-			cacheFile >> msb;
-			MSB.push_back(msb);
+			if(!(s >> MSB[j]))
+				return false;
 		}
 
-		cacheFile >> approxErrorBound;
-
 		for (int i=0; i<(1<<alpha); i++) {
-			vector<mpz_class> coeff;
-			for (int j=0; j<=degree; j++) {
-				mpz_class c;
-				cacheFile >> c;
-				coeff.push_back(c);
-			}
-			BasicPolyApprox* p = new BasicPolyApprox(degree,MSB,LSB,coeff);
+			BasicPolyApprox* p = new BasicPolyApprox(s);
 			poly.push_back(p);
+			if(!s || p->degree != degree) {
+				for (auto q: poly)
+					delete q;
+				poly.clear();
+				return false;
+			}
 		}
+		return true;
 	}
 
 
@@ -66,23 +66,17 @@ namespace flopoco{
 		sollya_obj_t buildSubIntervalFunction(sollya_obj_t fS, int alpha, int i);
 
 		/**
-		 * a local function to open the cache file, and create it if necessary
-		 * @param cacheFileName the name of the cache file
+		 * a local function to write the polynomials' parameters, their coefficients and the error bound to the ApproximationCache
+		 * @param s the stream of the cache value
 		 */
-		void openCacheFile(string cacheFileName);
+		void writeToCache(ostream &s);
 
 		/**
-		 * a local function to write the polynomials' parameters to the cache file
-		 * @param cacheFileName the name of the cache file
+		 * a local function to read the polynomials' parameters from a value of the ApproximationCache
+		 * @param s the stream of the cache value
+		 * @return false if the value is inconsistent
 		 */
-		void writeToCacheFile(string cacheFileName);
-
-		/**
-		 * a local function to read the polynomials' parameters from the cache file
-		 * @param cacheFileName the number of intervals the domain is split into
-		 * @nbIntervals number of intervals, used in build() function
-		 */
-		void readFromCacheFile(string cacheFileName);
+		bool readFromCache(istream &s);
 
 		/**
 		 * check whether all the coefficients of a given degree are of the same sign
@@ -103,7 +97,6 @@ namespace flopoco{
 		string uniqueName_;                /**< useful only to enable same kind of reporting as for FloPoCo operators. */
 		bool needToFreeF;                  /**< in an ideal world, this should not be needed */
 
-		fstream cacheFile;                 /**< file storing the cached parameters for the polynomials */
 		int nbIntervals;                   /**< the total number of intervals the domain is split into */
 	};
 
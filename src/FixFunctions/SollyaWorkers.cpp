@@ -0,0 +1,219 @@
+/*
+  Parallel Sollya computations in forked worker processes.
+
+  This file is part of the FloPoCo project
+
+  Initial software.
+  Copyright © INSA-Lyon, INRIA, CNRS, UCBL,
+  2024.
+  All rights reserved.
+ */
+
+#include "SollyaWorkers.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <cstdio>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <new>
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+namespace flopoco{
+
+	// The state shared by the workers: lock-free atomics also work between processes
+	struct SollyaWorkersShared {
+		atomic<int> next;       /**< the next task to start */
+		atomic<bool> abort;     /**< set by a task to skip the tasks not started yet */
+	};
+
+
+	// Writes the whole buffer, false if the pipe is broken
+	static bool writeAll(int fd, const string &s) {
+		size_t done = 0;
+		while(done < s.size()) {
+			ssize_t w = write(fd, s.data() + done, s.size() - done);
+			if(w < 0)
+				return false;
+			done += w;
+		}
+		return true;
+	}
+
+
+	// The number of threads that generate operators concurrently, see addGenerationThreads()
+	static atomic<int> generationThreads(0);
+
+
+	int sollyaWorkers()
+	{
+		if(generationThreads > 1)
+			return 1;
+		return max(1u, thread::hardware_concurrency());
+	}
+
+
+	void addGenerationThreads(int n)
+	{
+		generationThreads += n;
+	}
+
+
+	bool runInSollyaWorkers(int n, function<string(int, bool&)> task, vector<string> &results)
+	{
+		results.assign(n, "");
+		int workers = min(n, sollyaWorkers());
+
+		SollyaWorkersShared *shared = NULL;
+		if(workers > 1) {
+			void *mem = mmap(NULL, sizeof(SollyaWorkersShared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+			if(mem != MAP_FAILED)
+				shared = new(mem) SollyaWorkersShared;
+		}
+
+		auto sequential = [&]() {
+			for(int i = 0; i < n; i++) {
+				bool abort = false;
+				results[i] = task(i, abort);
+				if(abort)
+					return false;
+			}
+			return true;
+		};
+		if(shared == NULL)
+			return sequential();
+
+		shared->next = 0;
+		shared->abort = false;
+		// Output buffered before the fork would otherwise be written by the parent and the workers
+		cout.flush();
+		cerr.flush();
+		fflush(NULL);
+
+		vector<pid_t> pids;
+		vector<int> fds;
+		for(int w = 0; w < workers; w++) {
+			int p[2];
+			if(pipe(p) != 0)
+				break;
+			pid_t pid = fork();
+			if(pid < 0) {
+				close(p[0]);
+				close(p[1]);
+				break;
+			}
+			if(pid == 0) {
+				// The worker: the record of a task is "index status size\n" followed by the result, or the error message if status is 1
+				close(p[0]);
+				for(auto fd: fds)
+					close(fd);
+				// A task is started only if no task has aborted, but a task started is always completed:
+				// as they are started in order, all the tasks before the first one that aborts are done
+				while(!shared->abort) {
+					int i = shared->next++;
+					if(i >= n)
+						break;
+					bool abort = false;
+					int status = 0;
+					string r;
+					try {
+						r = task(i, abort);
+					}
+					catch(string &e) {
+						status = 1;
+						r = e;
+					}
+					catch(...) {
+						status = 1;
+						r = "unknown exception in a Sollya worker";
+					}
+					if(abort || status != 0)
+						shared->abort = true;
+					ostringstream record;
+					record << i << " " << status << " " << r.size() << endl << r;
+					if(!writeAll(p[1], record.str()))
+						break;
+				}
+				cout.flush();
+				cerr.flush();
+				fflush(NULL);
+				_exit(0); // the exit handlers belong to the parent
+			}
+			close(p[1]);
+			pids.push_back(pid);
+			fds.push_back(p[0]);
+		}
+
+		if(pids.empty()) { // no worker could be started
+			munmap(shared, sizeof(SollyaWorkersShared));
+			return sequential();
+		}
+
+		// Read all the pipes at once, so that no worker blocks on a full pipe
+		vector<string> received(fds.size());
+		vector<struct pollfd> pending;
+		for(auto fd: fds)
+			pending.push_back({fd, POLLIN, 0});
+		while(!pending.empty()) {
+			if(poll(pending.data(), pending.size(), -1) < 0)
+				continue; // interrupted by a signal
+			for(size_t k = 0; k < pending.size(); ) {
+				if(pending[k].revents == 0) {
+					k++;
+					continue;
+				}
+				char buffer[4096];
+				ssize_t r = read(pending[k].fd, buffer, sizeof(buffer));
+				if(r < 0 && errno == EINTR)
+					continue;
+				if(r > 0) {
+					received[find(fds.begin(), fds.end(), pending[k].fd) - fds.begin()].append(buffer, r);
+					k++;
+				}
+				else {
+					close(pending[k].fd);
+					pending.erase(pending.begin() + k);
+				}
+			}
+		}
+
+		bool crashed = false;
+		for(auto pid: pids) {
+			int status;
+			if(waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+				crashed = true;
+		}
+		bool aborted = shared->abort;
+		int started = min<int>(shared->next, n);
+		munmap(shared, sizeof(SollyaWorkersShared));
+
+		string error;
+		int done = 0;
+		for(auto &r: received) {
+			istringstream s(r);
+			int i, status;
+			size_t size;
+			while(s >> i >> status >> size && s.get() == '\n') {
+				string result(size, '\0');
+				s.read(&result[0], size);
+				if(status != 0)
+					error = result;
+				else if(i >= 0 && i < n) {
+					results[i] = result;
+					done++;
+				}
+			}
+		}
+		if(error != "")
+			throw error;
+		if(crashed || (!aborted && done < started))
+			throw string("runInSollyaWorkers: a Sollya worker process failed");
+		return !aborted;
+	}
+
+}
@@ -0,0 +1,35 @@
+#ifndef _SOLLYAWORKERS_HPP_
+#define _SOLLYAWORKERS_HPP_
+
+#include <string>
+#include <vector>
+#include <functional>
+
+using namespace std;
+
+namespace flopoco{
+
+	/** Runs independent Sollya computations in parallel.
+			Sollya is not thread-safe, so the computations are run by worker processes forked from the current one:
+			they inherit its Sollya state, and send their results back as strings through pipes.
+			There is one worker per hardware thread; on a single-threaded host, the tasks are run in the current process.
+
+			@param n the number of tasks
+			@param task task(i, abort) computes task i and returns its result.
+			It may set abort to true to skip the tasks that have not been started yet, for instance when its result makes the whole set useless.
+			The tasks are started in increasing order, and a task started is completed: all the tasks before the first one that aborts are done.
+			A task may throw a string, which is rethrown by runInSollyaWorkers once the workers are done.
+			@param results results[i] is the result of task i, empty if it was skipped
+			@return false if a task aborted
+	*/
+	bool runInSollyaWorkers(int n, function<string(int, bool&)> task, vector<string> &results);
+
+	/** The number of worker processes used by runInSollyaWorkers, e.g. to size batches of speculative tasks.
+			It is 1 while several threads generate operators: forking while another thread holds a lock (of malloc, of the streams...) may deadlock the workers */
+	int sollyaWorkers();
+
+	/** Adds n (possibly negative) to the number of threads that generate operators concurrently, e.g. the jobs of the batch mode */
+	void addGenerationThreads(int n);
+
+}
+#endif
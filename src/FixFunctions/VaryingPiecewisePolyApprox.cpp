@@ -24,9 +24,14 @@
 
 */
 #include "VaryingPiecewisePolyApprox.hpp"
+#include "SollyaWorkers.hpp"
+#include "ApproximationCache.hpp"
 #include <sstream>
+#include <iomanip>
+#include <cstdlib>
 #include <limits.h>
 #include <float.h>
+#include <algorithm>
 
 namespace flopoco {
 
@@ -85,13 +90,15 @@ namespace flopoco {
 	// split into smaller and smaller intervals until the function can be approximated by a polynomial of degree given by degree.
 	void VaryingPiecewisePolyApprox::build()
 	{
-		ostringstream cacheFileName;
-		cacheFileName << "VaryingPiecewisePoly_"<<vhdlize(f->description) << "_" << degree << "_" << targetAccuracy << ".cache";
-
-		// Test existence of cache file, create it if necessary
-		openCacheFile(cacheFileName.str());
+		string cacheKey = ApproximationCache::keyDescription("VaryingPiecewisePolyApprox", f->fS, f->signedIn, lsbIn, msbOut, lsbOut, -1, targetAccuracy);
+		string cacheValue;
+		bool cached = ApproximationCache::lookup(cacheKey, cacheValue);
+		if(cached) {
+			istringstream s(cacheValue);
+			cached = readFromCache(s);
+		}
 
-		if(!cacheFile.is_open())
+		if(!cached)
 		{
 			//********************** Do the work, then write the cache *********************
 			sollya_obj_t fS = f->fS; // no need to free this one
@@ -106,34 +113,52 @@ namespace flopoco {
 			// it will take too long before that anyway
 			tabulateRest = true;
 			int biggestNbInterval = -lsbIn -6; //une fois qu'on a beaucoup shifté, ça coûte rien de tabuler
-			
-			for (nbInterval=0; nbInterval<biggestNbInterval; nbInterval++)
+
+			// The degrees needed by successive values of nbInterval are guessed in parallel, by batches of one per worker,
+			// then checked in order, since degree accumulates along the search
+			int batch = sollyaWorkers();
+			bool found = false;
+			for (int first=0; first<biggestNbInterval && !found; first+=batch)
 			{
-			        REPORT(DETAILED, " Testing nbInterval=" << nbInterval );
-
-				sollya_obj_t giS = buildSubIntervalFunction(fS, nbInterval);
-				if(DEBUG <= UserInterface::verbose)
-				  sollya_lib_printf("> VaryingPiecewisePolyApprox: nbInterval=%d, testing  %b \n", nbInterval, giS);
-				int degreeInf, degreeSup;
-				BasicPolyApprox::guessDegree(giS, rangeS, targetAccuracy, &degreeInf, &degreeSup);
-				sollya_lib_clear_obj(giS);
-				degree = max(degreeSup, degree);
-
-				giS = buildFinalSubIntervalFunction(fS, nbInterval);
-				if(DEBUG <= UserInterface::verbose)
-				  sollya_lib_printf("> VaryingPiecewisePolyApprox, Interval rest : nbInterval=%d, testing  %b \n", nbInterval, giS);
-				BasicPolyApprox::guessDegree(giS, rangeS, targetAccuracy, &degreeInf, &degreeSup);
-				sollya_lib_clear_obj(giS);
-				
-				if (degreeSup<=degree) {
-				  tabulateRest=false;
-				  break;
-				}
-				else {
-				  REPORT(DEBUG, "   nbInterval=" << nbInterval+1 << " failed." );
+				int n = min(batch, biggestNbInterval-first);
+				vector<string> results;
+				runInSollyaWorkers(n, [&](int k, bool &abort) {
+						int nb = first+k;
+						sollya_obj_t giS = buildSubIntervalFunction(fS, nb);
+						if(DEBUG <= UserInterface::verbose)
+							sollya_lib_printf("> VaryingPiecewisePolyApprox: nbInterval=%d, testing  %b \n", nb, giS);
+						int degreeInf, degreeSup, restDegreeSup;
+						BasicPolyApprox::guessDegree(giS, rangeS, targetAccuracy, &degreeInf, &degreeSup);
+						sollya_lib_clear_obj(giS);
+
+						giS = buildFinalSubIntervalFunction(fS, nb);
+						if(DEBUG <= UserInterface::verbose)
+							sollya_lib_printf("> VaryingPiecewisePolyApprox, Interval rest : nbInterval=%d, testing  %b \n", nb, giS);
+						BasicPolyApprox::guessDegree(giS, rangeS, targetAccuracy, &degreeInf, &restDegreeSup);
+						sollya_lib_clear_obj(giS);
+						return to_string(degreeSup) + " " + to_string(restDegreeSup);
+					}, results);
+
+				for (int k=0; k<n; k++)
+				{
+					nbInterval = first+k;
+					REPORT(DETAILED, " Testing nbInterval=" << nbInterval );
+					int degreeSup, restDegreeSup;
+					istringstream(results[k]) >> degreeSup >> restDegreeSup;
+					degree = max(degreeSup, degree);
+
+					if (restDegreeSup<=degree) {
+					  tabulateRest=false;
+					  found=true;
+					  break;
+					}
+					else {
+					  REPORT(DEBUG, "   nbInterval=" << nbInterval+1 << " failed." );
+					}
 				}
-				
-			} // end for loop on i
+			} // end for loop on batches
+			if (!found)
+				nbInterval = max(biggestNbInterval, 0);
 			nbInterval++; nbInterval++;
 			
 			REPORT(INFO, "Found nbInterval=" << nbInterval)
@@ -160,67 +185,84 @@ namespace flopoco {
 			bool success=false;
 			while(!success) {
 				// Now fill the vector of polynomials, computing the coefficient parameters along.
-				//		LSB=INT_MAX; // very large
-				// MSB=INT_MIN; // very small
-				approxErrorBound = 0.0;
-				BasicPolyApprox *p;
-
-				REPORT(DETAILED, "Computing the actual polynomials ");
-				// initialize the vector of MSB weights
-				for (int j=0; j<=degree; j++) {
-					MSB.push_back(INT_MIN);
+				// The polynomials are computed in parallel, and the first one that is not accurate enough aborts the others.
+				// poly[i] is NULL for the intervals still to compute: the accurate polynomials of a failed attempt are kept when only LSB moves down.
+				poly.resize(nbInterval, NULL);
+				vector<int> todo;
+				for (int i=0; i<nbInterval; i++) {
+					if(poly[i]==NULL)
+						todo.push_back(i);
 				}
 
-				for (int i=0; i<nbInterval; i++) {
-					REPORT(DETAILED, " ... computing polynomial approx for interval " << i << " / "<< nbInterval);
-					// Recompute the substitution. No big deal.
-					sollya_obj_t giS;
-					if (i==nbInterval-1 && not tabulateRest) {
-					  giS = buildFinalSubIntervalFunction(fS, i-1);
-					}
-					else {
-					  giS = buildSubIntervalFunction(fS, i);
+				REPORT(DETAILED, "Computing the actual polynomials for " << todo.size() << " intervals");
+				vector<string> results;
+				runInSollyaWorkers(todo.size(), [&](int k, bool &abort) {
+						int i = todo[k];
+						REPORT(DETAILED, " ... computing polynomial approx for interval " << i << " / "<< nbInterval);
+						sollya_obj_t giS;
+						if (i==nbInterval-1 && not tabulateRest) {
+						  giS = buildFinalSubIntervalFunction(fS, i-1);
+						}
+						else {
+						  giS = buildSubIntervalFunction(fS, i);
+						}
+						BasicPolyApprox *p = new BasicPolyApprox(giS, degree, LSB, true);
+						abort = (p->approxErrorBound >= targetAccuracy);
+						ostringstream s;
+						p->write(s);
+						delete p;
+						return s.str();
+					}, results);
+
+				approxErrorBound = 0.0;
+				for (size_t k=0; k<todo.size(); k++) {
+					if(results[k] != "") {
+						istringstream s(results[k]);
+						poly[todo[k]] = new BasicPolyApprox(s);
 					}
-					
-					p = new BasicPolyApprox(giS, degree, LSB, true);
-					poly.push_back(p);
-					if (approxErrorBound < p->approxErrorBound){
+				}
+				for (auto p: poly) {
+					if (p!=NULL && approxErrorBound < p->approxErrorBound){
 						REPORT(DEBUG, "   new approxErrorBound=" << p->approxErrorBound );
 						approxErrorBound = p->approxErrorBound;
 					}
-					if (approxErrorBound>targetAccuracy){
-						break;
-					}
-
-					// Now compute the englobing MSB for each coefficient
-					for (int j=0; j<=degree; j++) {
-						// if the coeff is zero, we can set its MSB to anything, so we exclude this case
-						if (  (!p->coeff[j]->isZero())  &&  (p->coeff[j]->MSB > MSB[j])  )
-							MSB[j] = p->coeff[j]->MSB;
-					}
-					sollya_lib_clear_obj(giS);
-					
-
-				} // end for loop on j
+				}
 
-				if (approxErrorBound < targetAccuracy) {
+				if (approxErrorBound < targetAccuracy && find(poly.begin(), poly.end(), (BasicPolyApprox*)NULL) == poly.end()) {
 					REPORT(INFO, " *** Success! Final approxErrorBound=" << approxErrorBound << "  is smaller than target accuracy: " << targetAccuracy  );
 					success=true;
 				}
 				else {
 					REPORT(INFO, "Measured approx error:" << approxErrorBound << " is larger than target accuracy: " << targetAccuracy
 							<< ". Increasing LSB and starting over. Thank you for your patience");
-					//empty poly
-					for (auto i:poly)
-						free(i);
-					while(!poly.empty())
-						poly.pop_back();
-
 					if(lsbAttempts<=lsbAttemptsMax) {
 						lsbAttempts++;
 						LSB--;
+						// The accurate polynomials remain accurate with one more LSB bit: only the others are recomputed.
+						// Which intervals were computed before the abort depends on the timing of the workers,
+						// so only those before the first failing one are kept, as they are always computed.
+						int firstFailing = 0;
+						while (firstFailing<nbInterval && poly[firstFailing]!=NULL && poly[firstFailing]->approxErrorBound < targetAccuracy)
+							firstFailing++;
+						for (int i=0; i<nbInterval; i++) {
+							if (i>=firstFailing) {
+								delete poly[i];
+								poly[i] = NULL;
+							}
+							else {
+								poly[i]->LSB = LSB;
+								for (int j=0; j<=degree; j++) {
+									if (!poly[i]->coeff[j]->isZero())
+										poly[i]->coeff[j]->changeLSB(LSB);
+								}
+							}
+						}
 					}
 					else {
+						//empty poly
+						for (auto i:poly)
+							delete i;
+						poly.clear();
 					        LSB+=lsbAttempts;
 						lsbAttempts=0;
 						degree ++;
@@ -232,6 +274,16 @@ namespace flopoco {
 				}
 			} // end while(!success)
 
+			// Now compute the englobing MSB for each coefficient
+			MSB.assign(degree+1, INT_MIN);
+			for (int i=0; i<nbInterval; i++) {
+				for (int j=0; j<=degree; j++) {
+					// if the coeff is zero, we can set its MSB to anything, so we exclude this case
+					if (  (!poly[i]->coeff[j]->isZero())  &&  (poly[i]->coeff[j]->MSB > MSB[j])  )
+						MSB[j] = poly[i]->coeff[j]->MSB;
+				}
+			}
+
 			// Now we need to resize all the coefficients of degree i to the largest one
 			// TODO? we could also check if one of the coeffs is always positive or negative, and optimize generated code accordingly
 			for (int i=0; i<nbInterval; i++) {
@@ -254,27 +306,25 @@ namespace flopoco {
 			  buf = (char *)malloc(sz + 1);
 			  sollya_lib_snprintf(buf, sz+1,"%b", giS);
 			  FixFunction* g = new FixFunction(buf, true, -5, msbOut, lsbOut);
-			  for (int i=0; i<(1<<6);i++) {
-			    mpz_class rNorD, ru;
-			    g->eval(mpz_class(i), rNorD, ru, true);
-			    table.push_back(rNorD);
-			  }
+			  vector<mpz_class> rNorD, ru;
+			  g->evalRange(0, 1<<6, rNorD, ru, true);
+			  table.insert(table.end(), rNorD.begin(), rNorD.end());
 			  sollya_lib_clear_obj(giS);
 			  free(buf);
 			  free(g);
 			}
 				    
-			// Write the cache file
-			writeToCacheFile(cacheFileName.str());
+			// Write the cache entry
+			ostringstream s;
+			writeToCache(s);
+			ApproximationCache::store(cacheKey, s.str());
 
 			//cleanup the sollya objects
 			sollya_lib_clear_obj(rangeS);
 		}
 		else
 		{
-			REPORT(INFO, "Polynomial data cache found: " << cacheFileName.str());
-			//********************** Just read the cache *********************
-			readFromCacheFile(cacheFileName.str());
+			REPORT(INFO, "Polynomial data found in the approximation cache");
 		} // end if cache
 
 		// Check if all the coefficients of a given degree are of the same sign
@@ -298,92 +348,59 @@ namespace flopoco {
 	}
 
 
-	void VaryingPiecewisePolyApprox::openCacheFile(string cacheFileName)
+	void VaryingPiecewisePolyApprox::writeToCache(ostream &s)
 	{
-		cacheFile.open(cacheFileName.c_str(), ios::in);
-
-		// check for bogus .cache file
-		if(cacheFile.is_open() && cacheFile.peek() == std::ifstream::traits_type::eof())
-		{
-			cacheFile.close();
-			std::remove(cacheFileName.c_str());
-			cacheFile.open(cacheFileName.c_str(), ios::in); // of course this one will fail
-		}
-	}
-
-
-	void VaryingPiecewisePolyApprox::writeToCacheFile(string cacheFileName)
-	{
-		cacheFile.open(cacheFileName.c_str(), ios::out);
-
-		cacheFile << "Polynomial data cache for " << cacheFileName << endl;
-		cacheFile << "Erasing this file is harmless, but do not try to edit it." <<endl;
-
-		cacheFile << degree <<endl;
-		cacheFile << nbInterval << endl;
-		cacheFile << LSB <<endl;
-		cacheFile << tabulateRest << endl;
-
+		s << degree << " " << nbInterval << " " << LSB << " " << tabulateRest << " " << setprecision(17) << approxErrorBound << endl;
 		for (int j=0; j<=degree; j++) {
-			cacheFile << MSB[j] << endl;
+			s << MSB[j] << endl;
 		}
 
-		cacheFile << approxErrorBound << endl;
-
-		// now write the coefficients themselves
-		for(int i=0; i<nbInterval; i++){
-		
-			for (int j=0; j<=degree; j++)
-			{
-				cacheFile <<  poly[i] -> coeff[j] -> getBitVectorAsMPZ() << endl;
-			}
+		// now write the polynomials themselves
+		for(int i=0; i<nbInterval; i++) {
+			poly[i]->write(s);
 		}
 
 		if (tabulateRest==true) {
 		  for (int i=0; i<(1<<6); i++) {
-		    cacheFile << table[i]<< endl;
+		    s << table[i]<< endl;
 		  }
 		}
 	}
 
 
-	void VaryingPiecewisePolyApprox::readFromCacheFile(string cacheFileName)
+	bool VaryingPiecewisePolyApprox::readFromCache(istream &s)
 	{
-		string line;
-
-		getline(cacheFile, line); // ignore the first line which is a comment
-		getline(cacheFile, line); // ignore the second line which is a comment
-
-		cacheFile >> degree;
-		cacheFile >> nbInterval;
-		cacheFile >> LSB;
-		cacheFile >> tabulateRest;
-
+		string error;
+		if(!(s >> degree >> nbInterval >> LSB >> tabulateRest >> error) || degree < 0 || nbInterval < 0)
+			return false;
+		approxErrorBound = strtod(error.c_str(), NULL);
+		MSB.assign(degree+1, 0);
 		for (int j=0; j<=degree; j++) {
-			int msb;
-			cacheFile >> msb;
-			MSB.push_back(msb);
+			if(!(s >> MSB[j]))
+				return false;
 		}
 
-		cacheFile >> approxErrorBound;
-
-		for (int i=0; i<nbInterval; i++) {
-			vector<mpz_class> coeff;
-			for (int j=0; j<=degree; j++) {
-				mpz_class c;
-				cacheFile >> c;
-				coeff.push_back(c);
-			}
-			BasicPolyApprox* p = new BasicPolyApprox(degree,MSB,LSB,coeff);
+		bool ok = true;
+		for (int i=0; i<nbInterval && ok; i++) {
+			BasicPolyApprox* p = new BasicPolyApprox(s);
 			poly.push_back(p);
+			ok = (s && p->degree == degree);
 		}
 		if (tabulateRest==true) {
-		  for (int i=0; i<(1<<6); i++) {
+		  for (int i=0; i<(1<<6) && ok; i++) {
 		    mpz_class c;
-		    cacheFile >> c;
+		    ok = (bool)(s >> c);
 		    table.push_back(c);
 		  }
 		}
+		if(!ok) {
+			for (auto p: poly)
+				delete p;
+			poly.clear();
+			table.clear();
+			degree = 0;
+		}
+		return ok;
 	}
 
 
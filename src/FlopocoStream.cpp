@@ -51,10 +51,13 @@ namespace flopoco{
 		lexLexingMode = LexerContext::unset;
 		lexLexingModeOld = LexerContext::unset;
 		lexIsLhsSet = false;
+		lexStatementCount = 0;
 	}
 
 
 	FlopocoStream::~FlopocoStream(){
+		if(lexer != nullptr)
+			delete lexer;
 	}
 
 	string FlopocoStream::str(){
@@ -67,6 +70,7 @@ namespace flopoco{
 		vhdlCode.str("");
 		vhdlCodeBuffer.str("");
 		dependenceTable.clear();
+		lexedNames.clear();
 		codeParsed = false;
 		return vhdlCode.str();
 	}
@@ -75,66 +79,56 @@ namespace flopoco{
 
 
 	void FlopocoStream::flushAndParseAndBuildDependencyTable(){
-		ostringstream bufferCode;
+		//nothing to do if the buffer is empty
+		if(vhdlCodeBuffer.tellp() <= 0) {
+			codeParsed = true;
+			return;
+		}
 
 		if(op->noParseNoSchedule()) {
-			vhdlCode << vhdlCodeBuffer.str();			
-			codeParsed = true;
-			vhdlCodeBuffer.str("");
+			vhdlCode << vhdlCodeBuffer.str();
 		}
 		else {
-			//parse the buffer if it is not empty
-			if(vhdlCodeBuffer.str() != string(""))
+			//the flex++ object is created once, then reused for all the code of this operator
+			if(lexer == nullptr)
+				lexer = new LexerContext(op, &vhdlCodeBuffer, &vhdlCode, &lexLhsName, &lexExtraRhsNames, &lexDependenceTable, &lexedNames, &lexStatementCount, &lexLexingMode, &lexLexingModeOld, &lexIsLhsSet);
+
+			//call the FlexLexer++ on the whole buffer. The lexing output is directly
+			//	appended to vhdlCode, and the names it contains to lexedNames.
+			//	Additionally, a temporary table lexer->dependenceTable
+			//	containing the triplets <lhsName, rhsName, delay> is created
+			try
 				{
-					//scan the code buffer and build the dependence table and annotate the code
-					bufferCode.str("");
-					
-					//parse the code, if required
-					istringstream in(vhdlCodeBuffer.str());
-		
-					//instantiate the flex++ object  for lexing the buffer info
-					LexerContext* lexer = new LexerContext(op, &in, &bufferCode, &lexLhsName, &lexExtraRhsNames, &lexDependenceTable, &lexLexingMode, &lexLexingModeOld, &lexIsLhsSet);
-					
-					//call the FlexLexer++ on the buffer. The lexing output is
-					//	in the variable bufferCode. Additionally, a temporary table lexer->dependenceTable 
-					//	containing the triplets <lhsName, rhsName, delay> is created
-					try
-						{
-							lexer->lex();
-						}catch(string &e)
-						{
-							cerr << "Lexing failed: " << e << endl;
-							cerr << "on the following VHDL code:" << vhdlCodeBuffer.str() << endl;
-							exit(1);
-						}
-
-					//the temporary table is used to update the dependence table  member of FlopocoStream
-					//	this also empties the lexer's dependence table
-					vector<triplet<string, string, int>>::iterator iter;
-					for(iter=  lexer->dependenceTable->begin(); iter!=lexer->dependenceTable->end();  ++iter){
-						dependenceTable.push_back(make_triplet(iter->first, iter->second, iter->third));
-					}
-					lexer->dependenceTable -> clear();
-					// updateDependenceTable();
-					
-					//set the flag for code parsing and reset the vhdl code buffer
-					codeParsed = true;
-					vhdlCodeBuffer.str("");
-					//fix the dependence table in case of (rhs1, rhs2) <= ... 
-					cleanupDependenceTable();
-
-					//the newly processed code is appended to the existing one
-					vhdlCode << bufferCode.str();
+					lexer->lex();
+				}catch(string &e)
+				{
+					cerr << "Lexing failed: " << e << endl;
+					cerr << "on the following VHDL code:" << vhdlCodeBuffer.str() << endl;
+					exit(1);
 				}
+
+			//the temporary table is used to update the dependence table  member of FlopocoStream
+			//	this also empties the lexer's dependence table
+			size_t firstNewDependence = dependenceTable.size();
+			dependenceTable.insert(dependenceTable.end(), lexer->dependenceTable->begin(), lexer->dependenceTable->end());
+			lexer->dependenceTable -> clear();
+
+			//fix the new part of the dependence table in case of (rhs1, rhs2) <= ... 
+			cleanupDependenceTable(firstNewDependence);
 		}
+
+		//set the flag for code parsing and reset the vhdl code buffer (including its eof state)
+		codeParsed = true;
+		vhdlCodeBuffer.str("");
+		vhdlCodeBuffer.clear();
 	}
 
 
 
-	void FlopocoStream::setSecondLevelCode(string code){
+	void FlopocoStream::setSecondLevelCode(stringstream& code){
 		vhdlCodeBuffer.str("");
-		vhdlCode.str("");
-		vhdlCode << code;
+		vhdlCode.swap(code);
+		lexedNames.clear();
 		codeParsed = true;
 	}
 
@@ -147,7 +141,7 @@ namespace flopoco{
 
 
 	bool FlopocoStream::isEmpty(){
-		return (((vhdlCode.str()).length() == 0) && ((vhdlCodeBuffer.str()).length() == 0));
+		return ((vhdlCode.tellp() <= 0) && (vhdlCodeBuffer.tellp() <= 0));
 	}
 
 
@@ -161,11 +155,11 @@ namespace flopoco{
 	}
 
 
-	void FlopocoStream::cleanupDependenceTable()
+	void FlopocoStream::cleanupDependenceTable(size_t first)
 	{
 		vector<triplet<string, string, int>> newDependenceTable;
 
-		for(int i=0; (unsigned)i<dependenceTable.size(); i++)
+		for(size_t i=first; i<dependenceTable.size(); i++)
 		{
 			string lhsName = dependenceTable[i].first;
 			string rhsName = dependenceTable[i].second;
@@ -236,14 +230,9 @@ namespace flopoco{
 			}
 		}
 
-		//clear the old values in the dependence table
-		dependenceTable.clear();
-
-		//add the new values to the dependence table
-		for(unsigned int i=0; i<newDependenceTable.size(); i++)
-		{
-			dependenceTable.push_back(newDependenceTable[i]);
-		}
+		//replace the old values in the dependence table with the new ones
+		dependenceTable.resize(first);
+		dependenceTable.insert(dependenceTable.end(), newDependenceTable.begin(), newDependenceTable.end());
 	}
 
 }
@@ -33,14 +33,16 @@ namespace flopoco{
 
 	/**
 	 * The FlopocoStream class.
-	 * Segments of code having the same pipeline informations are scanned
-	 * on-the-fly using flex++ to find the VHDL signal IDs. The found IDs
-	 * are marked (ID_Name becomes $$ID_Name$$, if it is a signal on the
-	 * right-hand side of an assignment, ??ID_Name??, if it is on the left-hand side)
-	 * for the second pass.
-	 * The signals with delays are marked as well (ID_Name becomes ID_Name^nb_cycles (pipeline delay)
-	 * or ID_Name^nb_cycles (functional delay)).
-	 * The assignment statements are appended with the name of the left-hand signal (??ID_Name??).
+	 * The code streamed in is accumulated in a buffer, which is scanned
+	 * using flex++ to find the VHDL signal IDs only when the dependencies are needed,
+	 * i.e. when the operator is scheduled or when the code is read back with str().
+	 * The lexed code is output unchanged, and the found IDs
+	 * are recorded in lexedNames with their role (left-hand side or right-hand side
+	 * of an assignment, component, port or actual signal of an instance)
+	 * and the index of their statement: this is the statement IR used by the second pass,
+	 * Operator::doApplySchedule(), which outputs the final code in one pass.
+	 * The signals with delays are recorded as well (ID_Name^nb_cycles).
+	 * Each stream owns one lexer, which is reused for all the batches of code of its operator.
 	 */
 	class FlopocoStream{
 		public:
@@ -52,45 +54,9 @@ namespace flopoco{
 			return output;
 		}
 
-		friend FlopocoStream& operator <<(FlopocoStream& output, char c) {
-			output.vhdlCodeBuffer << c;
-			output.codeParsed = false;
-			if(c == ';')
-				output.flushAndParseAndBuildDependencyTable();
-			return output;
-		}
-
-		friend FlopocoStream& operator<<(FlopocoStream& output, std::string s) {
-			output.vhdlCodeBuffer << s;
-			output.codeParsed = false;
-			if(s.find(';') != s.npos)
-				output.flushAndParseAndBuildDependencyTable();
-			return output;
-		}
-
-		friend FlopocoStream& operator<<(FlopocoStream& output, char *s) {
-			output.vhdlCodeBuffer << s;
-			output.codeParsed = false;
-			string str(s);
-			if(str.find(';') != str.npos)
-				output.flushAndParseAndBuildDependencyTable();
-			return output;
-		}
-
-		friend FlopocoStream& operator<<(FlopocoStream& output, char const *s) {
-			output.vhdlCodeBuffer << s;
-			output.codeParsed = false;
-			string str(s);
-			if(str.find(';') != str.npos)
-				output.flushAndParseAndBuildDependencyTable();
-			return output;
-		}
-
 		friend FlopocoStream& operator <<(FlopocoStream& output, FlopocoStream fs) {
 			output.vhdlCodeBuffer << fs.vhdlCode.str();
 			output.codeParsed = false;
-			if(fs.vhdlCode.str().find(';') != fs.vhdlCode.str().npos)
-				output.flushAndParseAndBuildDependencyTable();
 			return output;
 		}
 
@@ -131,13 +97,10 @@ namespace flopoco{
 
 			/**
 			 * Function used to flush the buffer
-			 * 	- save the code in the temporary buffer
-			 * 	- parse the code from the temporary buffer and add it to the stream
+			 * 	- parse the code accumulated in the temporary buffer, in one pass, and add it to the stream
 			 * Extract the dependencies between the signals.
-			 * Annotate the signal names, for the second phase. All signals on the right-hand side of signal assignments
-			 * will be transformed from signal_name to $$signal_name$$.
-			 * The name of the left-hand side signal is annotated to ??lhs_name??.
-			 * 	- build the dependenceTable and annotate the code
+			 * Record the signal names with their role in lexedNames, for the second phase.
+			 * 	- build the dependenceTable and the statement IR
 			 We build a dependency table, not yet the final signal graph, so that it is possible to declare a signal only after using it.
 			 */
 			void flushAndParseAndBuildDependencyTable();
@@ -145,10 +108,10 @@ namespace flopoco{
 
 			/**
 			 * Member function used to set the code resulted after a second parsing
-			 * was performed
-			 * @param[in] code the 2nd parse level code
+			 * was performed. The recorded names are forgotten.
+			 * @param[in,out] code the 2nd parse level code, which is swapped with the current code
 			 */
-			void setSecondLevelCode(string code);
+			void setSecondLevelCode(stringstream& code);
 
 			/**
 			 * Returns the dependenceTable
@@ -166,14 +129,17 @@ namespace flopoco{
 			 * of an assignment.
 			 * Because of the parsing stage, lhsName might be of the form (lhsName1, lhsName2, ...),
 			 * which must be fixed.
+			 * @param first the index of the first entry to fix: the previous ones have already been cleaned up
+			 * (cleaning up twice would lose the delays)
 			 */
-			void cleanupDependenceTable();
+			void cleanupDependenceTable(size_t first = 0);
 
 
-			ostringstream vhdlCode;                                 /**< the vhdl code */
-			ostringstream vhdlCodeBuffer;                           /**< the temporary vhdl code buffer */
+			stringstream vhdlCode;                                  /**< the vhdl code, read back by the second pass */
+			stringstream vhdlCodeBuffer;                            /**< the temporary vhdl code buffer, read directly by the lexer */
 
 			vector<triplet<string, string, int>> dependenceTable;   /**< table containing the left-hand side - right-hand side dependences, with the possible delay on the edge */
+			vector<LexerContext::LexedName> lexedNames;             /**< the names found in vhdlCode, in order: the statement IR of the second pass */
 
 			//the lexing context
 			string lexLhsName;
@@ -182,11 +148,13 @@ namespace flopoco{
 			LexerContext::LexMode lexLexingMode;
 			LexerContext::LexMode lexLexingModeOld;
 			bool lexIsLhsSet;
+			size_t lexStatementCount;
 
 		protected:
 
 			Operator *op=0;
 			bool codeParsed;
+			LexerContext* lexer=0;                                  /**< the lexer of this stream, created on the first flush */
 	};
 }
 #endif
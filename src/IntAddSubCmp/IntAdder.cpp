@@ -163,6 +163,18 @@ namespace flopoco {
 		tc->addExpectedOutput ( "R", svR );
 	}
 
+	bool IntAdder::hasEmulateFast() {
+		return wIn <= 64;
+	}
+
+	void IntAdder::emulateFast ( FastTestCase* tc ) {
+		// inputs are X, Y, Cin; uint64_t arithmetic is already modulo 2^64
+		uint64_t r = tc->getInput(0) + tc->getInput(1) + tc->getInput(2);
+		if(wIn < 64)
+			r &= (uint64_t(1) << wIn) - 1;
+		tc->addExpectedOutput(0, r);
+	}
+
 
 	OperatorPtr IntAdder::parseArguments(OperatorPtr parentOp, Target *target, vector<string> &args) {
 		int wIn;
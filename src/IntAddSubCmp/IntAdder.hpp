@@ -42,6 +42,10 @@ namespace flopoco {
 		 */
 		void emulate ( TestCase* tc );
 
+		/** The same on native integers, for wIn up to 64 */
+		void emulateFast ( FastTestCase* tc );
+		bool hasEmulateFast();
+
 		/**
 		 * get the maximum adder size for a given target period
 		 */
@@ -114,11 +114,24 @@ bool BaseMultiplierCategory::shape_contribution(int x, int y, int shape_x, int s
         int sign_x = (signedIO && wX-(int)tile_param.wX_-1 == shape_x)?1:0;      //The Xilinx DSP-Blocks can process one bit more if signed
         int sign_y = (signedIO && wY-(int)tile_param.wY_-1 == shape_y)?1:0;
         return ( 0 <= x-shape_x && x-shape_x < (int)tile_param.wX_+sign_x && 0 <= y-shape_y && y-shape_y < (int)tile_param.wY_+sign_y );
+    } else if(!shapeTable_.empty()) {
+        int rx = x-shape_x, ry = y-shape_y;
+        return ( 0 <= rx && rx < (int)tile_param.wX_ && 0 <= ry && ry < (int)tile_param.wY_ && shapeTable_[ry*tile_param.wX_ + rx] );
     } else {
         return shapeValid(x-shape_x, y-shape_y);
     }
 }
 
+// caches shapeValid() over the tile, for shape_contribution() on the placement checks of the tiling strategies
+void BaseMultiplierCategory::tabulateShape(){
+    shapeTable_.assign(tile_param.wX_*tile_param.wY_, false);
+    for(int y = 0; y < (int)tile_param.wY_; y++){
+        for(int x = 0; x < (int)tile_param.wX_; x++){
+            shapeTable_[y*tile_param.wX_ + x] = shapeValid(x, y);
+        }
+    }
+}
+
 //determine the occupation ratio of a given multiplier tile range [0..1],
 float BaseMultiplierCategory::shape_utilisation(int shape_x, int shape_y, int wX, int wY, bool signedIO){
     if(0 <= shape_x && (shape_x + (int)tile_param.wX_) < wX && 0 <= shape_y && (shape_y + (int)tile_param.wY_) < wY ){
@@ -110,6 +110,7 @@ namespace flopoco {
 			virtual bool shapeValid(Parametrization const & param, unsigned x, unsigned y) const;
             virtual bool shapeValid(int x, int y);
             bool shape_contribution(int x, int y, int shape_x, int shape_y, int wX, int wY, bool signedIO);
+            void tabulateShape();
             virtual float shape_utilisation(int shape_x, int shape_y, int wX, int wY, bool signedIO);
 
             virtual int getRelativeResultLSBWeight(Parametrization const & param) const;
@@ -140,6 +141,7 @@ namespace flopoco {
             const bool rectangular;
             string type_; /**< Name to identify the corresponding base multiplier in the solution (for debug only) */
             vector<int> output_weights;
+            vector<bool> shapeTable_; /**< shapeValid() over the tile, row by row, if tabulateShape() was called */
 
     };
 
@@ -93,7 +93,6 @@ namespace flopoco {
         for(int j = 0; j <= n; j++){
             for(int i = 0; i <= j; i++){
                 protruding_bits = x_anchor+y_anchor+2*kxy*j+wX+wY - wMultX+wMultY;
-                cout << protruding_bits << endl;
                 protruding_bits =((protruding_bits < 0)?0:protruding_bits);
                 bits += (wX + wY - protruding_bits);
                 if(i != j) {          //the DSPs that are replaced by Karatsuba contribute with 3 bits to bit heap
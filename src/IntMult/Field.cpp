@@ -1,12 +1,20 @@
 #include "Field.hpp"
 #include <iostream>
+#include <algorithm>
 
 namespace flopoco {
-    Field::Field(unsigned int wX, unsigned int wY, bool signedIO, FieldState& baseState) : wX_(wX), wY_(wY), signedIO_(signedIO), currentStateID_(0U), baseState_{&baseState} {
-        field_.resize(wY_);
-        for(unsigned int i = 0; i < wY_; i++) {
-            field_[i] = vector<ID>(wX_, currentStateID_);
-        }
+    // the bits [from, to) of a row in its 64-bit word w, with from < 64*(w+1) and to > 64*w
+    static inline uint64_t wordMask(unsigned int w, unsigned int from, unsigned int to) {
+        unsigned int lo = (from > 64 * w) ? from - 64 * w : 0;
+        unsigned int hi = (to < 64 * (w + 1)) ? to - 64 * w : 64;
+        uint64_t mask = (hi == 64) ? ~0ULL : ((1ULL << hi) - 1);
+        return mask & ~((1ULL << lo) - 1);
+    }
+
+    Field::Field(unsigned int wX, unsigned int wY, bool signedIO, FieldState& baseState) : overlayID_(0U), wX_(wX), wY_(wY), signedIO_(signedIO), currentStateID_(0U), baseState_{&baseState} {
+        words_ = (wX_ + 63) / 64;
+        base_.assign(wY_ * words_, 0ULL);
+        overlay_.assign(wY_ * words_, 0ULL);
         currentStateID_++;
 
         initFieldState(baseState);
@@ -16,20 +24,17 @@ namespace flopoco {
     Field::Field(const Field &copy) {
         wX_ = copy.wX_;
         wY_ = copy.wY_;
-
-        field_.resize(wY_);
-        for(unsigned int i = 0U; i < wY_; i++) {
-            field_[i].resize(wX_);
-            for(unsigned int j = 0; j < wX_; j++) {
-                field_[i][j] = copy.field_[i][j];
-            }
-        }
+        words_ = copy.words_;
+        base_ = copy.base_;
+        overlay_ = copy.overlay_;
+        overlayID_ = copy.overlayID_;
 
         signedIO_ = copy.signedIO_;
     }
 
     Field::~Field() {
-        field_.clear();
+        base_.clear();
+        overlay_.clear();
     }
 
     void Field::initFieldState(FieldState& fieldState) {
@@ -43,37 +48,54 @@ namespace flopoco {
     }
 
     void Field::reset() {
+        std::fill(base_.begin(), base_.end(), 0ULL);
+        overlayID_ = 0U;
         initFieldState(*baseState_);
         baseID_ = baseState_->getID();
     }
 
-    BaseMultiplierParametrization Field::checkDSPPlacement(const Cursor coord, BaseMultiplierCategory* tile, FieldState& fieldState, unsigned int maxX, unsigned int maxY) {
-        unsigned int sizeX = std::min((unsigned int)tile->wX_DSPexpanded(coord.first, coord.second, wX_, wY_, signedIO_), maxX);
-        unsigned int sizeY = std::min((unsigned int)tile->wY_DSPexpanded(coord.first, coord.second, wX_, wY_, signedIO_), maxY);
-        ID fieldID = fieldState.getID();
+    uint64_t Field::covered(unsigned int y, unsigned int w, ID id) const {
+        uint64_t bits = base_[y * words_ + w];
+        if(id == overlayID_) {
+            bits |= overlay_[y * words_ + w];
+        }
+        return bits;
+    }
 
-        for (unsigned int i = coord.second; i < sizeY + coord.second; i++) {
-            for (unsigned int j = coord.first; j < sizeX + coord.second; j++) {
-                if (field_[i][j] == fieldID || field_[i][j] == baseID_) {
-                    unsigned int area1 = i - coord.second + 1 * maxY;
-                    unsigned int area2 = maxX * j - coord.second + 1;
-                    if(area1 > area2) {
-                        maxX = i - coord.second + 1;
-                    }
-                    else {
-                        maxY = j - coord.second + 1;
-                    }
-                }
-            }
+    vector<uint64_t>& Field::coverage(FieldState& fieldState) {
+        if(fieldState.getID() == baseID_) {
+            return base_;
+        }
+
+        if(fieldState.getID() != overlayID_) {
+            std::fill(overlay_.begin(), overlay_.end(), 0ULL);
+            overlayID_ = fieldState.getID();
+        }
+        return overlay_;
+    }
+
+    bool Field::isFree(unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1, ID id) const {
+        if(x0 >= x1) {
+            return true;
         }
 
-        for (unsigned int i = coord.second; i < sizeY; i++) {
-            for (unsigned int j = coord.first; j < sizeX; j++) {
-                if (field_[i][j] == fieldID || field_[i][j] == baseID_) {
-                    return tile->parametrize(0, 0, false, false);
+        for (unsigned int i = y0; i < y1; i++) {
+            for (unsigned int w = x0 / 64; w <= (x1 - 1) / 64; w++) {
+                if (covered(i, w, id) & wordMask(w, x0, x1)) {
+                    return false;
                 }
             }
         }
+        return true;
+    }
+
+    BaseMultiplierParametrization Field::checkDSPPlacement(const Cursor coord, BaseMultiplierCategory* tile, FieldState& fieldState, unsigned int maxX, unsigned int maxY) {
+        unsigned int sizeX = std::min((unsigned int)tile->wX_DSPexpanded(coord.first, coord.second, wX_, wY_, signedIO_), maxX);
+        unsigned int sizeY = std::min((unsigned int)tile->wY_DSPexpanded(coord.first, coord.second, wX_, wY_, signedIO_), maxY);
+
+        if (!isFree(coord.first, coord.second, std::min(sizeX, wX_), std::min(sizeY, wY_), fieldState.getID())) {
+            return tile->parametrize(0, 0, false, false);
+        }
 
         return tile->parametrize(sizeX, sizeY, false, false);
     }
@@ -86,35 +108,38 @@ namespace flopoco {
         unsigned int maxX = std::min(endX, wX_);
         unsigned int maxY = std::min(endY, wY_);
 
+        if (coord.first >= maxX || coord.second >= maxY) {
+            return 0;
+        }
+
         unsigned int covered = 0;
         ID fieldID = fieldState.getID();
 
         if (tile->isIrregular() || tile->isKaratsuba()) {
             for (unsigned int i = coord.second; i < maxY; i++) {
-                for (unsigned int j = coord.first; j < maxX; j++) {
-                    //check if tile could cover this area
-                    if (!tile->shape_contribution(j, i, coord.first, coord.second, wX_, wY_, signedIO_)) {
-                        continue;
+                for (unsigned int w = coord.first / 64; w <= (maxX - 1) / 64; w++) {
+                    //the cells of the row the tile could cover in this word
+                    uint64_t shape = 0ULL;
+                    for (unsigned int j = std::max(coord.first, 64 * w); j < std::min(maxX, 64 * (w + 1)); j++) {
+                        if (tile->shape_contribution(j, i, coord.first, coord.second, wX_, wY_, signedIO_)) {
+                            shape |= 1ULL << (j - 64 * w);
+                        }
                     }
 
-                    if (field_[i][j] == fieldID || field_[i][j] == baseID_) {
+                    if (this->covered(i, w, fieldID) & shape) {
                         return 0;
                     }
 
-                    covered++;
+                    covered += __builtin_popcountll(shape);
                 }
             }
         }
         else {
-            for (unsigned int i = coord.second; i < maxY; i++) {
-                for (unsigned int j = coord.first; j < maxX; j++) {
-                    if (field_[i][j] == fieldID || field_[i][j] == baseID_) {
-                        return 0;
-                    }
-
-                    covered++;
-                }
+            if (!isFree(coord.first, coord.second, maxX, maxY, fieldID)) {
+                return 0;
             }
+
+            covered = (maxX - coord.first) * (maxY - coord.second);
         }
 
         return covered;
@@ -129,27 +154,26 @@ namespace flopoco {
         unsigned int maxY = std::min(endY, wY_);
 
         ID fieldID = fieldState.getID();
+        vector<uint64_t>& bits = coverage(fieldState);
         unsigned int updateMissing = 0U;
 
-        if(tile->isIrregular() || tile->isKaratsuba()) {
+        if (coord.first < maxX) {
+            bool shaped = tile->isIrregular() || tile->isKaratsuba();
             for (unsigned int i = coord.second; i < maxY; i++) {
-                for (unsigned int j = coord.first; j < maxX; j++) {
-                    //check if tile could cover this area and if area is free
-                    if (tile->shape_contribution(j, i, coord.first, coord.second, wX_, wY_, signedIO_) &&
-                        field_[i][j] != fieldID && field_[i][j] != baseID_) {
-                        field_[i][j] = fieldID;
-                        updateMissing++;
-                    }
-                }
-            }
-        }
-        else {
-            for (unsigned int i = coord.second; i < maxY; i++) {
-                for (unsigned int j = coord.first; j < maxX; j++) {
-                    if (field_[i][j] != fieldID && field_[i][j] != baseID_) {
-                        field_[i][j] = fieldID;
-                        updateMissing++;
+                for (unsigned int w = coord.first / 64; w <= (maxX - 1) / 64; w++) {
+                    uint64_t cells = wordMask(w, coord.first, maxX);
+                    if (shaped) {
+                        //only the cells the tile covers
+                        cells = 0ULL;
+                        for (unsigned int j = std::max(coord.first, 64 * w); j < std::min(maxX, 64 * (w + 1)); j++) {
+                            if (tile->shape_contribution(j, i, coord.first, coord.second, wX_, wY_, signedIO_)) {
+                                cells |= 1ULL << (j - 64 * w);
+                            }
+                        }
                     }
+
+                    updateMissing += __builtin_popcountll(cells & ~covered(i, w, fieldID));
+                    bits[i * words_ + w] |= cells;
                 }
             }
         }
@@ -169,27 +193,33 @@ namespace flopoco {
     }
 
     unsigned int Field::getMissingLine(FieldState& fieldState) {
-        unsigned int missing = 0U;
         Cursor c = fieldState.getCursor();
         ID fieldID = fieldState.getID();
 
-        for(unsigned int i = c.first; i < wX_; i++) {
-            if(field_[c.second][i] == fieldID || field_[c.second][i] == baseID_) {
-                break;
+        if(c.first >= wX_) {
+            return 0U;
+        }
+
+        //the first covered cell of the line from the cursor on
+        for(unsigned int w = c.first / 64; w < words_; w++) {
+            uint64_t bits = covered(c.second, w, fieldID) & wordMask(w, c.first, wX_);
+            if(bits != 0ULL) {
+                return 64 * w + __builtin_ctzll(bits) - c.first;
             }
-            missing++;
         }
 
-        return missing;
+        return wX_ - c.first;
     }
 
     unsigned int Field::getMissingHeight(FieldState& fieldState) {
         unsigned int missing = 0U;
         Cursor c = fieldState.getCursor();
         ID fieldID = fieldState.getID();
+        unsigned int w = c.first / 64;
+        uint64_t bit = 1ULL << (c.first % 64);
 
         for(unsigned int i = c.second; i < wY_; i++) {
-            if(field_[i][c.first] == fieldID || field_[i][c.first] == baseID_) {
+            if(covered(i, w, fieldID) & bit) {
                 break;
             }
             missing++;
@@ -200,34 +230,32 @@ namespace flopoco {
 
     void Field::printField() {
         //TODO: mirror output
-        for(auto v: field_) {
-            for(auto c: v) {
-                cout << c;
+        for(unsigned int y = 0; y < wY_; y++) {
+            for(unsigned int x = 0; x < wX_; x++) {
+                cout << (((base_[y * words_ + x / 64] | overlay_[y * words_ + x / 64]) >> (x % 64)) & 1ULL);
             }
             cout << endl;
         }
     }
 
     bool Field::checkPosition(unsigned int x, unsigned int y, Field::FieldState &fieldState) {
-        return (field_[y][x] == fieldState.getID() || field_[y][x] == baseID_);
+        return (covered(y, x / 64, fieldState.getID()) >> (x % 64)) & 1ULL;
     }
 
     void Field::setTruncated(unsigned int range, FieldState& fieldState) {
-        ID fieldID = fieldState.getID();
+        vector<uint64_t>& bits = coverage(fieldState);
         unsigned int updateMissing = 0;
         for(unsigned int y = 0; y < wY_; y++) {
             if(y > range) {
                 break;
             }
 
-            for(unsigned int x = 0; x < wX_; x++) {
-                if(y + x > range) {
-                   break;
-                }
-
-                field_[y][x] = fieldID;
-                updateMissing++;
+            //the cells with y + x <= range
+            unsigned int endX = std::min(wX_, range - y + 1);
+            for(unsigned int w = 0; 64 * w < endX; w++) {
+                bits[y * words_ + w] |= wordMask(w, 0, endX);
             }
+            updateMissing += endX;
         }
 
         fieldState.decreaseMissing(updateMissing);
@@ -235,11 +263,9 @@ namespace flopoco {
     }
 
     void Field::printField(FieldState& fieldState) {
-        ID fieldID = fieldState.getID();
-
-        for(auto v: field_) {
-            for(auto c: v) {
-                cout << (c == fieldID || c == baseID_);
+        for(unsigned int y = 0; y < wY_; y++) {
+            for(unsigned int x = 0; x < wX_; x++) {
+                cout << checkPosition(x, y, fieldState);
             }
             cout << endl;
         }
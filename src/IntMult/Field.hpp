@@ -3,6 +3,7 @@
 
 #include <utility>
 #include <vector>
+#include <cstdint>
 #include "BaseMultiplierCategory.hpp"
 
 using namespace std;
@@ -79,7 +80,21 @@ namespace flopoco {
         void printField(FieldState& fieldState);
 
     protected:
-        vector<vector<ID>> field_;
+        /*
+         * The covered cells are bitsets of wY_ rows of words_ 64-bit words.
+         * The cells covered by the base state are in base_, they are covered for all the states.
+         * The cells covered by another state are in overlay_, which belongs to the last state that placed a tile (overlayID_)
+         * and is cleared when another one does: resetting a state to the base state is a new ID, without any copy.
+         */
+        vector<uint64_t> base_;
+        vector<uint64_t> overlay_;
+        ID overlayID_;
+        unsigned int words_;
+
+        uint64_t covered(unsigned int y, unsigned int w, ID id) const;
+        vector<uint64_t>& coverage(FieldState& fieldState);
+        bool isFree(unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1, ID id) const;
+
         unsigned int wX_;
         unsigned int wY_;
         bool signedIO_;
@@ -33,6 +33,7 @@
 #include "TilingStrategyXGreedy.hpp"
 #include "TilingStrategyBeamSearch.hpp"
 #include "TilingAndCompressionOptILP.hpp"
+#include "TilingCache.hpp"
 
 using namespace std;
 
@@ -58,6 +59,23 @@ namespace flopoco {
 		return wX + wY;
 	}
 
+	vector<string> IntMultiplier::tilingOptions(Target* target, float dspOccupationThreshold, unsigned int maxDSP, bool superTiles, bool use2xk, bool useirregular, bool useLUT, bool useDSP, bool useKaratsuba, int beamRange)
+	{
+		return {
+			join("maxDSP=", maxDSP),
+			"dspThreshold=" + to_string(dspOccupationThreshold),
+			join("superTiles=", superTiles),
+			join("use2xk=", use2xk),
+			join("useirregular=", useirregular),
+			join("useLUT=", useLUT),
+			join("useDSP=", useDSP),
+			join("useKaratsuba=", useKaratsuba),
+			join("beamRange=", beamRange),
+			"ilpSolver=" + target->getILPSolver(),
+			join("ilpTimeout=", target->getILPTimeout())
+		};
+	}
+
     IntMultiplier::IntMultiplier (Operator *parentOp, Target* target_, int wX_, int wY_, int wOut_, bool signedIO_, float dspOccupationThreshold, unsigned int maxDSP, bool superTiles, bool use2xk, bool useirregular, bool useLUT, bool useDSP, bool useKaratsuba, int beamRange):
 		Operator ( parentOp, target_ ),wX(wX_), wY(wY_), wOut(wOut_),signedIO(signedIO_), dspOccupationThreshold(dspOccupationThreshold)
 	{
@@ -221,8 +239,24 @@ namespace flopoco {
 			THROWERROR("Tiling strategy " << tilingMethod << " unknown");
 		}
 
-		REPORT(DEBUG, "Solving tiling problem")
-		tilingStrategy->solve();
+		// A strategy that also computes the compressor tree is not cached: its solution is more than the tiling
+		bool cacheTiling = (dynamic_cast<CompressionStrategy*>(tilingStrategy) == nullptr);
+		string tilingKey;
+		if(cacheTiling) {
+			vector<string> options = tilingOptions(getTarget(), dspOccupationThreshold, maxDSP, superTiles, use2xk, useirregular, useLUT, useDSP, useKaratsuba, beamRange);
+			tilingKey = TilingCache::keyDescription(wX, wY, wOut + guardBits, signedIO, tilingMethod, options, multiplierTileCollection, getTarget());
+		}
+
+		if(cacheTiling && TilingCache::lookup(tilingKey, multiplierTileCollection, getTarget(), tilingStrategy->getSolution())) {
+			REPORT(INFO, "Tiling found in the tiling cache")
+		}
+		else {
+			REPORT(DEBUG, "Solving tiling problem")
+			tilingStrategy->solve();
+			if(cacheTiling) {
+				TilingCache::store(tilingKey, multiplierTileCollection, getTarget(), tilingStrategy->getSolution());
+			}
+		}
 
 		tilingStrategy->printSolution();
 
@@ -730,6 +764,47 @@ namespace flopoco {
     }
 
 
+    bool IntMultiplier::hasEmulateFast()
+    {
+		// the full product is computed on a signed __int128
+		return wX <= 63 && wY <= 63 && wFullP <= 126 && wOut <= 64;
+    }
+
+    void IntMultiplier::emulateFast (FastTestCase* tc)
+    {
+		__int128 x = tc->getInput(0);
+		__int128 y = tc->getInput(1);
+		if(signedIO) {
+			if(x >= (__int128(1) << (wX-1)))
+				x -= __int128(1) << wX;
+			if(y >= (__int128(1) << (wY-1)))
+				y -= __int128(1) << wY;
+		}
+		__int128 r = x * y;
+		if(negate)
+			r = -r;
+		// two's complement on wFullP bits
+		if(r < 0)
+			r += __int128(1) << wFullP;
+		unsigned __int128 ur = r;
+
+		if(wOut >= wFullP) {
+			tc->addExpectedOutput(0, uint64_t(ur));
+		}
+		else {
+			// same faithful rounding as emulate()
+			uint64_t rTrunc = uint64_t(ur >> (wFullP-wOut));
+			tc->addExpectedOutput(0, rTrunc);
+			if(((unsigned __int128)rTrunc << (wFullP-wOut)) != ur) {
+				rTrunc++;
+				if(wOut < 64)
+					rTrunc &= (uint64_t(1) << wOut) - 1;
+				tc->addExpectedOutput(0, rTrunc);
+			}
+		}
+    }
+
+
 	void IntMultiplier::buildStandardTestCases(TestCaseList* tcl)
 	{
 		TestCase *tc;
@@ -36,6 +36,10 @@ namespace flopoco {
 		 */
 		void emulate ( TestCase* tc );
 
+		/** The same on native integers, for inputs up to 63 bits and outputs up to 64 bits */
+		void emulateFast ( FastTestCase* tc );
+		bool hasEmulateFast();
+
 		void buildStandardTestCases(TestCaseList* tcl);
 
 		/** Factory method that parses arguments and calls the constructor */
@@ -52,6 +56,13 @@ namespace flopoco {
 		 */
 		static unsigned int prodsize(unsigned int wX, unsigned int wY);
 
+		/**
+		 * @brief The parameters of the tiling, as name=value strings for the key of the TilingCache
+		 * The tile options are listed explicitly: the tiles they enable do not all appear in the tile list of the key,
+		 * and some of them (the 2xk tiles) change the candidates of the greedy tilings
+		 */
+		static vector<string> tilingOptions(Target* target, float dspOccupationThreshold, unsigned int maxDSP, bool superTiles, bool use2xk, bool useirregular, bool useLUT, bool useDSP, bool useKaratsuba, int beamRange);
+
 		static TestList unitTest(int index);
 
 		BitHeap* getBitHeap(void) {return bitHeap;}
@@ -9,7 +9,9 @@
 using namespace std;
 namespace flopoco {
 
-    MultiplierTileCollection::MultiplierTileCollection(Target *target, BaseMultiplierCollection *bmc, int mult_wX, int mult_wY, bool superTile, bool use2xk, bool useirregular, bool useLUT, bool useDSP, bool useKaratsuba) {
+    MultiplierTileCollection::MultiplierTileCollection(Target *target, BaseMultiplierCollection *bmc, int mult_wX, int mult_wY, bool superTile, bool use2xk, bool useirregular, bool useLUT, bool useDSP, bool useKaratsuba) :
+        mult_wX_{mult_wX}, mult_wY_{mult_wY}
+    {
         //cout << bmc->size() << endl;
         if(useDSP) {
             addBaseTile(new BaseMultiplierDSP(24, 17, 1));
@@ -81,11 +83,13 @@ namespace flopoco {
     void  MultiplierTileCollection::addBaseTile(BaseMultiplierCategory *mult) {
         MultTileCollection.push_back(mult);
         BaseTileCollection.push_back(mult);
+        tabulate(mult);
     }
 
     void  MultiplierTileCollection::addSuperTile(BaseMultiplierCategory *mult) {
         MultTileCollection.push_back(mult);
         SuperTileCollection.push_back(mult);
+        tabulate(mult);
     }
 
     void  MultiplierTileCollection::addVariableXTile(BaseMultiplierCategory *mult) {
@@ -98,6 +102,47 @@ namespace flopoco {
         VariableYTileCollection.push_back(mult);
     }
 
+    void MultiplierTileCollection::tabulate(BaseMultiplierCategory *mult) {
+        //the variable 2xk tiles are not tabulated: there are O(wX+wY) of them, and their cost is a closed formula
+        //the costs themselves are computed on the first lookup of the tile, as the ILP tilings never read them
+        costTables_[mult] = std::make_shared<CostTable>();
+        CostTable &table = *costTables_[mult];
+        table.xMin = 1 - (int)mult->wX();
+        table.yMin = 1 - (int)mult->wY();
+        table.width = mult_wX_ - table.xMin;
+        table.height = mult_wY_ - table.yMin;
+
+        if(mult->isIrregular() || mult->isKaratsuba()) {
+            mult->tabulateShape();
+        }
+    }
+
+    void MultiplierTileCollection::fillCostTable(BaseMultiplierCategory *mult, CostTable &table) {
+        table.cost.resize((size_t)std::max(table.width, 0) * std::max(table.height, 0));
+        for(int y = 0; y < table.height; y++) {
+            for(int x = 0; x < table.width; x++) {
+                table.cost[(size_t)y * table.width + x] = mult->getLUTCost(table.xMin + x, table.yMin + y, mult_wX_, mult_wY_);
+            }
+        }
+    }
+
+    double MultiplierTileCollection::getLUTCost(BaseMultiplierCategory *tile, int x_anchor, int y_anchor, int wMultX, int wMultY) {
+        if(wMultX == mult_wX_ && wMultY == mult_wY_) {
+            auto it = costTables_.find(tile);
+            if(it != costTables_.end()) {
+                CostTable &table = *it->second;
+                int x = x_anchor - table.xMin;
+                int y = y_anchor - table.yMin;
+                if(0 <= x && x < table.width && 0 <= y && y < table.height) {
+                    //the beam search looks the costs up from several threads
+                    std::call_once(table.filled, &MultiplierTileCollection::fillCostTable, this, tile, std::ref(table));
+                    return table.cost[(size_t)y * table.width + x];
+                }
+            }
+        }
+        return tile->getLUTCost(x_anchor, y_anchor, wMultX, wMultY);
+    }
+
     BaseMultiplierCategory* MultiplierTileCollection::superTileSubtitution(vector<BaseMultiplierCategory*> mtc, int rx1, int ry1, int lx1, int ly1, int rx2, int ry2, int lx2, int ly2){
         for(int i = 0; i < (int)mtc.size(); i++)
         {
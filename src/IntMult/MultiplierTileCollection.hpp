@@ -3,6 +3,10 @@
 #include "BaseMultiplierCategory.hpp"
 #include "BaseMultiplierCollection.hpp"
 
+#include <unordered_map>
+#include <mutex>
+#include <memory>
+
 namespace flopoco {
     class MultiplierTileCollection {
 
@@ -18,7 +22,31 @@ namespace flopoco {
         static BaseMultiplierCategory *
         superTileSubtitution(vector<BaseMultiplierCategory*> mtc, int rx1, int ry1, int lx1, int ly1, int rx2, int ry2, int lx2, int ly2);
 
+        /**
+         * The LUT cost of a tile placed at (x_anchor, y_anchor) in a wMultX x wMultY multiplier, as tile->getLUTCost().
+         * For the tiles of this collection (the variable 2xk tiles excepted) and the multiplier it was built for,
+         * it is read from a table, computed on the first lookup of the tile.
+         */
+        double getLUTCost(BaseMultiplierCategory* tile, int x_anchor, int y_anchor, int wMultX, int wMultY);
+
     private:
+        /** the LUT costs of a tile for all the anchors where it overlaps the multiplier, row by row from (xMin, yMin) */
+        struct CostTable {
+            int xMin;
+            int yMin;
+            int width;
+            int height;
+            vector<double> cost;
+            std::once_flag filled;     /**< cost is filled by fillCostTable() on the first lookup */
+        };
+
+        void tabulate(BaseMultiplierCategory* mult);
+        void fillCostTable(BaseMultiplierCategory* mult, CostTable &table);
+
+        int mult_wX_;
+        int mult_wY_;
+        std::unordered_map<BaseMultiplierCategory*, std::shared_ptr<CostTable> > costTables_;   /**< shared by the copies of the collection, which have the same tiles */
+
         void addBaseTile(BaseMultiplierCategory* mult);
         void addVariableXTile(BaseMultiplierCategory* mult);
         void addVariableYTile(BaseMultiplierCategory* mult);
@@ -2,6 +2,10 @@
 #include "IntMultiplier.hpp"
 #include "BaseMultiplierLUT.hpp"
 #include "MultiplierTileCollection.hpp"
+#ifndef HAVE_SCALP
+#include "TilingBranchAndBound.hpp"
+#include "BitHeap/CompressionBranchAndBound.hpp"
+#endif
 
 using namespace std;
 namespace flopoco {
@@ -24,10 +28,14 @@ TilingAndCompressionOptILP::TilingAndCompressionOptILP(
 			bmc),
         CompressionStrategy(bitheap),
 		small_tile_mult_{1}, //Most compact LUT-Based multiplier
+		prefered_multiplier_{prefered_multiplier},
 		numUsedMults_{0},
 		max_pref_mult_ {maxPrefMult},
 		occupation_threshold_{occupation_threshold},
 		tiles{mtc_.MultTileCollection}
+#ifndef HAVE_SCALP
+		, tileCollection_{mtc_}
+#endif
 	{
         for(auto &p:tiles)
         {
@@ -39,7 +47,9 @@ void TilingAndCompressionOptILP::solve()
 {
 
 #ifndef HAVE_SCALP
-    throw "Error, TilingAndCompressionOptILP::solve() was called but FloPoCo was not built with ScaLP library";
+    //without the ILP, the tiling and the compressor tree are optimised one after the other:
+    //the tiling here by branch and bound, starting from the greedy tiling, the compressor tree in compressionAlgorithm()
+    TilingStrategy::solution = TilingBranchAndBound::solveFromGreedy(wX, wY, wOut, signedIO, baseMultiplierCollection, prefered_multiplier_, tiles, occupation_threshold_, max_pref_mult_, tileCollection_, target->getILPTimeout());
 #else
     cout << "using ILP solver " << target->getILPSolver() << endl;
     solver = new ScaLP::Solver(ScaLP::newSolverDynamic({target->getILPSolver(),"Gurobi","CPLEX","SCIP","LPSolve"}));
@@ -424,6 +434,36 @@ void TilingAndCompressionOptILP::constructProblem(int s_max)
         CompressionStrategy::solution = BitHeapSolution();
         CompressionStrategy::solution.setSolutionStatus(BitheapSolutionStatus::OPTIMAL_PARTIAL);
 
+#ifndef HAVE_SCALP
+        //for debugging it might be better to order the compressors by efficiency
+        orderCompressorsByCompressionEfficiency();
+        addFlipFlop();
+
+        //the final adder may be in any stage after the last bits arrive, the fewest stages are tried first
+        unsigned int lastArrival = 0;
+        for(unsigned int s = 0; s < bitAmount.size(); s++){
+            for(unsigned int c = 0; c < bitAmount[s].size(); c++){
+                if(bitAmount[s][c] > 0){
+                    lastArrival = s;
+                }
+            }
+        }
+        s_max = std::max(1u, lastArrival);
+        while(true){
+            CompressionBranchAndBound bnb(bitAmount, possibleCompressors, flipflop);
+            bool found = bnb.solve(s_max, false, bitheap->getOp()->getTarget()->getILPTimeout());
+            if(found){
+                cout << "Total compressor LUT-cost: " << bnb.getArea() << (bnb.isComplete() ? "" : " (best found within the timeout)") << endl;
+                resizeBitAmount(s_max);
+                bnb.fillSolution(CompressionStrategy::solution);
+                break;
+            }
+            if(!bnb.isComplete()){
+                THROWERROR("No feasible solution possible within given ILPTimeout.");
+            }
+            s_max++;
+        }
+#else
         float compressor_cost = 0;
         vector<vector<int>> zeroInputsVector(s_max, vector<int>((int)prodWidth,0));
         resizeBitAmount(s_max-1);
@@ -467,6 +507,7 @@ void TilingAndCompressionOptILP::constructProblem(int s_max)
         }
 
         cout << "Total compressor LUT-cost: " << compressor_cost << endl;
+#endif
 
         //reports the area in LUT-equivalents
         printSolutionStatistics();
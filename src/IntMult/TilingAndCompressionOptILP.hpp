@@ -40,6 +40,7 @@ public:
 
 private:
     base_multiplier_id_t small_tile_mult_;
+    base_multiplier_id_t prefered_multiplier_;
     size_t numUsedMults_;
     size_t max_pref_mult_;
     float occupation_threshold_;
@@ -47,11 +48,13 @@ private:
     unsigned prodWidth;
     vector<BaseMultiplierCategory*> tiles;
     BasicCompressor* flipflop;
+    bool addFlipFlop();
 #ifdef HAVE_SCALP
     void constructProblem(int s_max);
-    bool addFlipFlop();
 
     ScaLP::Solver *solver;
+#else
+    MultiplierTileCollection tileCollection_;   /**< for the greedy tiling that seeds TilingBranchAndBound */
 #endif
 
         void resizeBitAmount(unsigned int stages);
@@ -0,0 +1,448 @@
+#include "TilingBranchAndBound.hpp"
+#include "IntMultiplier.hpp"
+#include "TilingStrategyGreedy.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <thread>
+
+using namespace std;
+namespace flopoco {
+
+    TilingBranchAndBound::TilingBranchAndBound(
+            int wX,
+            int wY,
+            int wOut,
+            bool signedIO,
+            vector<BaseMultiplierCategory*> tiles,
+            float occupation_threshold,
+            size_t maxDSP):
+            wX_{wX},
+            wY_{wY},
+            signedIO_{signedIO},
+            tiles_{tiles},
+            maxDSP_{maxDSP},
+            best_{numeric_limits<double>::infinity()},
+            bestCost_{numeric_limits<double>::infinity()},
+            found_{false},
+            optimal_{false},
+            stop_{false},
+            hasDeadline_{false}
+    {
+        int cells = wX * wY;
+
+        //the positions below the truncation line may be left uncovered, up to a total weight of 2^truncationWeight (as in the ILP)
+        int prodWidth = IntMultiplier::prodsize(wX, wY);
+        int truncationWeight = prodWidth - wOut - 1;
+        optional_.assign(cells, false);
+        weight_.assign(cells, 0.0);
+        for(int y = 0; y < wY; y++) {
+            for(int x = 0; x < wX; x++) {
+                if(wOut < prodWidth && x + y <= truncationWeight) {
+                    optional_[y * wX + x] = true;
+                    weight_[y * wX + x] = ldexp(1.0, x + y - truncationWeight);
+                }
+            }
+        }
+
+        //the positions from the most significant one
+        order_.resize(cells);
+        for(int i = 0; i < cells; i++)
+            order_[i] = i;
+        std::sort(order_.begin(), order_.end(), [wX](int a, int b) -> bool {
+            int wa = a % wX + a / wX, wb = b % wX + b / wX;
+            return (wa != wb) ? wa > wb : a % wX > b % wX;
+        });
+        vector<int> rank(cells);
+        for(int i = 0; i < cells; i++)
+            rank[order_[i]] = i;
+
+        //all the placements of all the tiles, the dominated ones excepted
+        map<vector<int>, vector<int>> byCells;
+        for(int s = 0; s < (int)tiles_.size(); s++) {
+            BaseMultiplierCategory* t = tiles_[s];
+            if(t->getDSPCost() > (int)maxDSP)
+                continue;
+            for(int ys = 1 - (int)t->wY(); ys < wY; ys++) {
+                for(int xs = 1 - (int)t->wX(); xs < wX; xs++) {
+                    if(occupation_threshold == 1.0 && ((wX - xs) < (int)t->wX() || (wY - ys) < (int)t->wY()))
+                        continue;
+                    if(t->shape_utilisation(xs, ys, wX, wY, signedIO) < occupation_threshold)
+                        continue;
+                    Placement p;
+                    //one more position in each direction for the signed DSP extension, see shape_contribution()
+                    for(int y = std::max(0, ys); y < std::min(wY, ys + (int)t->wY() + 1); y++)
+                        for(int x = std::max(0, xs); x < std::min(wX, xs + (int)t->wX() + 1); x++)
+                            if(t->shape_contribution(x, y, xs, ys, wX, wY, signedIO))
+                                p.cells.push_back(y * wX + x);
+                    if(p.cells.empty())
+                        continue;
+                    p.tile = s;
+                    p.x = xs;
+                    p.y = ys;
+                    p.cost = t->getLUTCost(xs, ys, wX, wY);
+                    p.dspCost = t->getDSPCost();
+                    p.ratio = p.cost / p.cells.size();
+
+                    vector<int> &same = byCells[p.cells];
+                    bool dominated = false;
+                    for(auto it = same.begin(); it != same.end() && !dominated; ) {
+                        Placement &q = placements_[*it];
+                        if(q.cost <= p.cost && q.dspCost <= p.dspCost)
+                            dominated = true;
+                        else if(p.cost <= q.cost && p.dspCost <= q.dspCost)
+                            it = same.erase(it);
+                        else
+                            it++;
+                    }
+                    if(!dominated) {
+                        same.push_back(placements_.size());
+                        placements_.push_back(p);
+                    }
+                }
+            }
+        }
+        vector<bool> kept(placements_.size(), false);
+        for(auto &g: byCells)
+            for(int p: g.second)
+                kept[p] = true;
+        vector<Placement> undominated;
+        for(size_t p = 0; p < placements_.size(); p++)
+            if(kept[p])
+                undominated.push_back(placements_[p]);
+        placements_.swap(undominated);
+
+        minRatio_.assign(cells, numeric_limits<double>::infinity());
+        startingAt_.assign(cells, vector<int>());
+        for(int p = 0; p < (int)placements_.size(); p++) {
+            int first = placements_[p].cells[0];
+            for(int c: placements_[p].cells) {
+                minRatio_[c] = std::min(minRatio_[c], placements_[p].ratio);
+                if(rank[c] < rank[first])
+                    first = c;
+            }
+            startingAt_[first].push_back(p);
+        }
+        for(auto &l: startingAt_) {
+            std::stable_sort(l.begin(), l.end(), [this](int a, int b) -> bool {
+                if(placements_[a].ratio != placements_[b].ratio)
+                    return placements_[a].ratio < placements_[b].ratio;
+                return placements_[a].cells.size() > placements_[b].cells.size();
+            });
+        }
+
+        //symmetry: on a square multiplier, the transpose of a tiling is a tiling of the same cost
+        //if every placement has a transposed placement of the same cost
+        if(wX == wY) {
+            map<vector<int>, int> index;
+            for(int p = 0; p < (int)placements_.size(); p++)
+                index[placements_[p].cells] = p;
+            mirror_.resize(placements_.size());
+            for(int p = 0; p < (int)placements_.size() && !mirror_.empty(); p++) {
+                vector<int> transposed;
+                for(int c: placements_[p].cells)
+                    transposed.push_back((c % wX) * wX + c / wX);
+                std::sort(transposed.begin(), transposed.end());
+                auto it = index.find(transposed);
+                if(it == index.end()
+                   || fabs(placements_[it->second].cost - placements_[p].cost) > 1e-9
+                   || placements_[it->second].dspCost != placements_[p].dspCost)
+                    mirror_.clear();
+                else
+                    mirror_[p] = it->second;
+            }
+        }
+
+        cout << "branch and bound tiling: " << placements_.size() << " placements" << (mirror_.empty() ? "" : ", transposition symmetry") << endl;
+    }
+
+
+
+    void TilingBranchAndBound::place(Node &node, int p) {
+        Placement &P = placements_[p];
+        for(int c: P.cells) {
+            node.cells[c] = 1;
+            if(!optional_[c])
+                node.bound -= minRatio_[c];
+        }
+        node.cost += P.cost;
+        node.dspCost += P.dspCost;
+        node.chosen.push_back(p);
+    }
+
+
+    void TilingBranchAndBound::unplace(Node &node, int p) {
+        Placement &P = placements_[p];
+        for(int c: P.cells) {
+            node.cells[c] = 0;
+            if(!optional_[c])
+                node.bound += minRatio_[c];
+        }
+        node.cost -= P.cost;
+        node.dspCost -= P.dspCost;
+        node.chosen.pop_back();
+    }
+
+
+    bool TilingBranchAndBound::fits(Node &node, int p) {
+        Placement &P = placements_[p];
+        if(node.dspCost + P.dspCost > (int)maxDSP_)
+            return false;
+        double bound = node.bound;
+        for(int c: P.cells) {
+            if(node.cells[c] != 0)
+                return false;
+            if(!optional_[c])
+                bound -= minRatio_[c];
+        }
+        return node.cost + P.cost + bound < best_.load() - 1e-9;
+    }
+
+
+    void TilingBranchAndBound::offer(Node &node) {
+        std::lock_guard<std::mutex> lock(bestMutex_);
+        if(node.cost < bestCost_ - 1e-9 || !found_) {
+            bestCost_ = node.cost;
+            bestChosen_ = node.chosen;
+            found_ = true;
+            best_.store(node.cost);
+        }
+    }
+
+
+    bool TilingBranchAndBound::timeIsUp() {
+        if(stop_.load())
+            return true;
+        if(hasDeadline_ && std::chrono::steady_clock::now() > deadline_) {
+            stop_.store(true);
+            return true;
+        }
+        return false;
+    }
+
+
+    void TilingBranchAndBound::search(Node &node) {
+        if((++node.nodes & 0x3ff) == 0 && timeIsUp())
+            return;
+        if(stop_.load(std::memory_order_relaxed))
+            return;
+
+        size_t pos = node.pos;
+        while(pos < order_.size() && node.cells[order_[pos]] != 0)
+            pos++;
+        if(pos == order_.size()) {
+            offer(node);
+            return;
+        }
+        if(node.cost + node.bound >= best_.load() - 1e-9)
+            return;
+
+        int c = order_[pos];
+        size_t savedPos = node.pos;
+        node.pos = pos + 1;
+        for(int p: startingAt_[c]) {
+            if(!mirror_.empty() && pos == 0 && mirror_[p] < p)
+                continue;
+            if(!fits(node, p))
+                continue;
+            place(node, p);
+            search(node);
+            unplace(node, p);
+        }
+        if(optional_[c] && node.uncoveredWeight + weight_[c] <= 1.0) {
+            node.cells[c] = 2;
+            node.uncoveredWeight += weight_[c];
+            search(node);
+            node.uncoveredWeight -= weight_[c];
+            node.cells[c] = 0;
+        }
+        node.pos = savedPos;
+    }
+
+
+    void TilingBranchAndBound::split(Node &node, unsigned depth, vector<Node> &nodes) {
+        size_t pos = node.pos;
+        while(pos < order_.size() && node.cells[order_[pos]] != 0)
+            pos++;
+        if(pos == order_.size()) {
+            offer(node);
+            return;
+        }
+        if(node.cost + node.bound >= best_.load() - 1e-9)
+            return;
+        if(depth == 0) {
+            nodes.push_back(node);
+            return;
+        }
+
+        int c = order_[pos];
+        size_t savedPos = node.pos;
+        node.pos = pos + 1;
+        for(int p: startingAt_[c]) {
+            if(!mirror_.empty() && pos == 0 && mirror_[p] < p)
+                continue;
+            if(!fits(node, p))
+                continue;
+            place(node, p);
+            split(node, depth - 1, nodes);
+            unplace(node, p);
+        }
+        if(optional_[c] && node.uncoveredWeight + weight_[c] <= 1.0) {
+            node.cells[c] = 2;
+            node.uncoveredWeight += weight_[c];
+            split(node, depth - 1, nodes);
+            node.uncoveredWeight -= weight_[c];
+            node.cells[c] = 0;
+        }
+        node.pos = savedPos;
+    }
+
+
+
+    bool TilingBranchAndBound::seed(list<TilingStrategy::mult_tile_t> &tiling) {
+        Node node;
+        node.cells.assign(wX_ * wY_, 0);
+        node.pos = 0;
+        node.cost = 0.0;
+        node.dspCost = 0;
+        node.bound = 0.0;
+        node.uncoveredWeight = 0.0;
+        node.nodes = 0;
+
+        for(auto &tile: tiling) {
+            BaseMultiplierParametrization &param = tile.first;
+            int xs = tile.second.first, ys = tile.second.second;
+            vector<int> cells;
+            for(int y = std::max(0, ys); y < wY_; y++)
+                for(int x = std::max(0, xs); x < wX_; x++)
+                    if(param.shapeValid(x - xs, y - ys))
+                        cells.push_back(y * wX_ + x);
+            int match = -1;
+            for(int p = 0; p < (int)placements_.size(); p++) {
+                Placement &P = placements_[p];
+                if(P.x == xs && P.y == ys && P.cells == cells && tiles_[P.tile]->getType() == param.getMultType()
+                   && (match < 0 || P.cost < placements_[match].cost))
+                    match = p;
+            }
+            if(match < 0)
+                return false;
+            for(int c: cells)
+                if(node.cells[c] != 0)
+                    return false;
+            place(node, match);
+        }
+        if(node.dspCost > (int)maxDSP_)
+            return false;
+        for(int c = 0; c < wX_ * wY_; c++) {
+            if(node.cells[c] == 0) {
+                if(!optional_[c])
+                    return false;
+                node.uncoveredWeight += weight_[c];
+            }
+        }
+        if(node.uncoveredWeight > 1.0)
+            return false;
+        offer(node);
+        return true;
+    }
+
+
+
+    bool TilingBranchAndBound::solve(int timeout) {
+        hasDeadline_ = (timeout > 0);
+        deadline_ = std::chrono::steady_clock::now() + std::chrono::seconds(timeout);
+        stop_.store(false);
+
+        Node root;
+        root.cells.assign(wX_ * wY_, 0);
+        root.pos = 0;
+        root.cost = 0.0;
+        root.dspCost = 0;
+        root.bound = 0.0;
+        for(int c = 0; c < wX_ * wY_; c++) {
+            if(!optional_[c])
+                root.bound += minRatio_[c]; // infinite if a mandatory position cannot be covered
+        }
+        root.uncoveredWeight = 0.0;
+        root.nodes = 0;
+
+        //expand the first levels until there are enough subtrees for the threads
+        unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+        vector<Node> nodes;
+        unsigned depth = 0;
+        do {
+            depth++;
+            nodes.clear();
+            split(root, depth, nodes);
+        } while(threads > 1 && nodes.size() > 0 && nodes.size() < 8 * threads && depth < 8);
+
+        std::atomic<size_t> next(0);
+        auto worker = [this, &nodes, &next]() {
+            for(size_t i = next++; i < nodes.size() && !stop_.load(); i = next++)
+                search(nodes[i]);
+        };
+        threads = std::min<size_t>(threads, nodes.size());
+        if(threads <= 1) {
+            worker();
+        }
+        else {
+            vector<std::thread> pool;
+            for(unsigned int t = 0; t < threads; t++)
+                pool.push_back(std::thread(worker));
+            for(auto &t: pool)
+                t.join();
+        }
+
+        optimal_ = !stop_.load();
+        cout << "branch and bound tiling: " << (found_ ? "" : "no ") << "solution" << (found_ ? (optimal_ ? " (optimal)" : " (timeout, not proven optimal)") : "")
+             << (found_ ? " of cost " + to_string(bestCost_) : "") << endl;
+        return found_;
+    }
+
+
+
+    list<TilingStrategy::mult_tile_t> TilingBranchAndBound::getSolution() {
+        list<TilingStrategy::mult_tile_t> solution;
+        for(int p: bestChosen_) {
+            Placement &P = placements_[p];
+            auto coord = make_pair(P.x, P.y);
+            solution.push_back(make_pair(tiles_[P.tile]->getParametrisation().tryDSPExpand(P.x, P.y, wX_, wY_, signedIO_), coord));
+        }
+        return solution;
+    }
+
+
+
+    list<TilingStrategy::mult_tile_t> TilingBranchAndBound::solveFromGreedy(
+            int wX,
+            int wY,
+            int wOut,
+            bool signedIO,
+            BaseMultiplierCollection* bmc,
+            base_multiplier_id_t prefered_multiplier,
+            vector<BaseMultiplierCategory*> tiles,
+            float occupation_threshold,
+            size_t maxDSP,
+            MultiplierTileCollection& tileCollection,
+            int timeout) {
+        TilingBranchAndBound bnb(wX, wY, wOut, signedIO, tiles, occupation_threshold, maxDSP);
+        TilingStrategyGreedy greedy(wX, wY, wOut, signedIO, bmc, prefered_multiplier, occupation_threshold, maxDSP, false, false, false, false, tileCollection);
+        greedy.solve();
+        if(!bnb.seed(greedy.getSolution())){
+            cout << "the greedy tiling is not a solution of the problem, starting without it" << endl;
+        }
+
+        cout << "starting branch and bound, this might take a while..." << endl;
+        if(bnb.solve(timeout)){
+            return bnb.getSolution();
+        }
+        if(!greedy.getSolution().empty()){
+            cout << "no tiling found within the timeout, using the greedy tiling" << endl;
+            return greedy.getSolution();
+        }
+        throw "Error, TilingBranchAndBound::solveFromGreedy(): no tiling found within the timeout";
+    }
+
+}   //end namespace flopoco
@@ -0,0 +1,137 @@
+#ifndef FLOPOCO_TILINGBRANCHANDBOUND_HPP
+#define FLOPOCO_TILINGBRANCHANDBOUND_HPP
+
+#include <atomic>
+#include <mutex>
+#include <chrono>
+
+#include "TilingStrategy.hpp"
+#include "MultiplierTileCollection.hpp"
+
+namespace flopoco {
+
+/*!
+ * An exact solver for the tile-coverage problem of TilingStrategyOptimalILP, used when FloPoCo is built without ScaLP.
+ *
+ * The problem is the one of the ILP formulation: choose tile placements of minimal LUT cost,
+ * such that every position of the wX x wY multiplier is covered exactly once,
+ * except the positions below the truncation line, which may be left uncovered as long as their total weight stays within the error budget,
+ * and such that at most maxDSP DSP blocks are used.
+ *
+ * It is a depth-first branch and bound over the positions, from the most significant one:
+ * the first undecided position is covered by a placement whose first position it is, or left uncovered if it is optional.
+ * - Placements covering the same positions as a cheaper placement (and using no fewer DSPs) are discarded beforehand.
+ * - For a square multiplier whose tiles all come with their transposed parametrisation, only one of each pair of mirrored placements is tried on the first position.
+ * - The bound adds to the current cost, for each mandatory position still uncovered, the lowest cost per covered position of the placements that cover it.
+ * - The incumbent may be seeded with a heuristic tiling, see seed().
+ * - The subtrees below the first decisions are searched by all the hardware threads, which share the incumbent.
+ */
+    class TilingBranchAndBound {
+    public:
+        TilingBranchAndBound(
+                int wX,
+                int wY,
+                int wOut,
+                bool signedIO,
+                vector<BaseMultiplierCategory*> tiles,
+                float occupation_threshold,
+                size_t maxDSP);
+
+        /**
+         * Uses a tiling as the initial incumbent
+         * @param tiling a tiling found by a heuristic, e.g. TilingStrategyGreedy
+         * @return true if every tile of the tiling is a placement of the problem and the tiling is feasible
+         */
+        bool seed(list<TilingStrategy::mult_tile_t> &tiling);
+
+        /**
+         * Runs the search
+         * @param timeout in seconds, 0 for no timeout (as Target::getILPTimeout())
+         * @return true if a tiling was found (possibly the seed)
+         */
+        bool solve(int timeout);
+
+        /** true if the search completed, so that the tiling found is optimal */
+        bool isOptimal() { return optimal_; }
+
+        /** the LUT cost of the tiling found */
+        double getCost() { return bestCost_; }
+
+        /** the tiling found, in the format of TilingStrategy::solution */
+        list<TilingStrategy::mult_tile_t> getSolution();
+
+        /**
+         * The tiling of the ILP strategies without ScaLP: the branch and bound, seeded with the greedy tiling,
+         * which is also the result if no tiling is found within the timeout
+         * @param tileCollection the collection of the tiles, for the greedy tiling
+         * @param timeout in seconds, 0 for no timeout (as Target::getILPTimeout())
+         */
+        static list<TilingStrategy::mult_tile_t> solveFromGreedy(
+                int wX,
+                int wY,
+                int wOut,
+                bool signedIO,
+                BaseMultiplierCollection* bmc,
+                base_multiplier_id_t prefered_multiplier,
+                vector<BaseMultiplierCategory*> tiles,
+                float occupation_threshold,
+                size_t maxDSP,
+                MultiplierTileCollection& tileCollection,
+                int timeout);
+
+    private:
+        struct Placement {
+            int tile;                   /**< index in tiles_ */
+            int x, y;                   /**< anchor of the tile */
+            double cost;                /**< LUT cost */
+            int dspCost;
+            vector<int> cells;          /**< the covered positions of the multiplier, as indices y*wX+x */
+            double ratio;               /**< cost per covered position */
+        };
+
+        /** The state of a partial tiling, also used to hand a subtree to a thread */
+        struct Node {
+            vector<char> cells;         /**< 0: undecided, 1: covered, 2: left uncovered */
+            vector<int> chosen;         /**< the placements of the partial tiling */
+            size_t pos;                 /**< the positions before order_[pos] are decided */
+            double cost;
+            int dspCost;
+            double bound;               /**< sum of the lowest cost per position of the mandatory positions still undecided */
+            double uncoveredWeight;     /**< sum of the weights of the positions left uncovered */
+            unsigned long nodes;        /**< nodes searched by the thread, to check the deadline from time to time */
+        };
+
+        void place(Node &node, int p);
+        void unplace(Node &node, int p);
+        bool fits(Node &node, int p);
+        void offer(Node &node);
+        void search(Node &node);
+        void split(Node &node, unsigned depth, vector<Node> &nodes);
+        bool timeIsUp();
+
+        int wX_, wY_;
+        bool signedIO_;
+        vector<BaseMultiplierCategory*> tiles_;
+        size_t maxDSP_;
+
+        vector<Placement> placements_;
+        vector<int> order_;                     /**< the positions, from the most significant */
+        vector<vector<int>> startingAt_;        /**< for each position, the placements whose first position in order_ it is, best ratio first */
+        vector<bool> optional_;                 /**< for each position, true if it is below the truncation line */
+        vector<double> weight_;                 /**< for each optional position, its weight relative to the error budget */
+        vector<double> minRatio_;               /**< for each position, the lowest cost per position of the placements covering it */
+        vector<int> mirror_;                    /**< for each placement, its transposed placement, empty if the problem is not symmetric */
+
+        std::mutex bestMutex_;
+        std::atomic<double> best_;              /**< cost of the incumbent, read by all threads */
+        double bestCost_;
+        vector<int> bestChosen_;
+        bool found_;
+        bool optimal_;
+
+        std::atomic<bool> stop_;
+        bool hasDeadline_;
+        std::chrono::steady_clock::time_point deadline_;
+    };
+}
+#endif //FLOPOCO_TILINGBRANCHANDBOUND_HPP
@@ -0,0 +1,180 @@
+#include "TilingCache.hpp"
+#include "OperatorCache.hpp"
+#include "UserInterface.hpp"
+#include "Target.hpp"
+
+#include <sstream>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <thread>
+#include <cstdio>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifndef FLOPOCO_VERSION
+#define FLOPOCO_VERSION "unknown"
+#endif
+
+namespace flopoco {
+
+    // The first line of an entry file: change it when the format of the entries changes
+    static const string entryHeader = "FloPoCo tiling cache entry, format 1";
+
+    std::mutex TilingCache::mutex_;
+    std::map<string, string> TilingCache::entries_;
+
+
+
+    string TilingCache::keyDescription(int wX, int wY, int wOut, bool signedIO, string method, vector<string> options, MultiplierTileCollection& tiles, Target* target) {
+        ostringstream s;
+        s << "flopoco " << FLOPOCO_VERSION << " " << OperatorCache::executableStamp() << endl;
+        s << "target " << target->getID() << endl;
+        s << "tiling " << method << " " << wX << " " << wY << " " << wOut << " " << (signedIO ? "signed" : "unsigned") << endl;
+        for(auto o: options) {
+            s << o << endl;
+        }
+        s << "tiles";
+        for(auto t: tiles.MultTileCollection) {
+            s << " " << t->getType() << ":" << t->wX() << "x" << t->wY() << ":" << t->getDSPCost();
+        }
+        return s.str();
+    }
+
+
+
+    bool TilingCache::parse(string entry, MultiplierTileCollection& tiles, list<TilingStrategy::mult_tile_t>& solution) {
+        istringstream s(entry);
+        string word;
+        size_t count;
+        if(!(s >> word >> count) || word != "tiles") {
+            return false;
+        }
+
+        list<TilingStrategy::mult_tile_t> tiling;
+        for(size_t i = 0; i < count; i++) {
+            size_t index, weightCount;
+            string type;
+            int tileWX, tileWY, signedX, signedY, shapePara, x, y;
+            if(!(s >> index >> type >> tileWX >> tileWY >> signedX >> signedY >> shapePara >> x >> y >> weightCount)) {
+                return false;
+            }
+            vector<int> weights(weightCount);
+            for(auto& w: weights) {
+                if(!(s >> w)) {
+                    return false;
+                }
+            }
+            if(index >= tiles.MultTileCollection.size() || tiles.MultTileCollection[index]->getType() != type) {
+                return false;
+            }
+            BaseMultiplierParametrization param = tiles.MultTileCollection[index]->parametrize(tileWX, tileWY, signedX, signedY, shapePara, type, true, weights);
+            tiling.push_back(make_pair(param, make_pair(x, y)));
+        }
+
+        solution = tiling;
+        return true;
+    }
+
+
+
+    bool TilingCache::lookup(string description, MultiplierTileCollection& tiles, Target* target, list<TilingStrategy::mult_tile_t>& solution) {
+        string entry;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = entries_.find(description);
+            if(it != entries_.end()) {
+                entry = it->second;
+            }
+        }
+
+        string dir = target->getCacheDir();
+        if(entry == "" && dir != "") {
+            // Any inconsistency is a miss: the entry will be overwritten by the new one
+            ifstream file(dir + "/" + OperatorCache::keyHash(description) + ".tiling");
+            string line, word;
+            int descriptionLines = 0;
+            if(file.is_open() && getline(file, line) && line == entryHeader
+               && getline(file, line) && (istringstream(line) >> word >> descriptionLines) && word == "key") {
+                ostringstream storedDescription;
+                for(int i = 0; i < descriptionLines && getline(file, line); i++) {
+                    storedDescription << (i == 0 ? "" : "\n") << line;
+                }
+                if(storedDescription.str() == description) {
+                    ostringstream rest;
+                    rest << file.rdbuf();
+                    entry = rest.str();
+                }
+            }
+        }
+
+        if(entry == "" || !parse(entry, tiles, solution)) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_[description] = entry;
+        return true;
+    }
+
+
+
+    void TilingCache::store(string description, MultiplierTileCollection& tiles, Target* target, list<TilingStrategy::mult_tile_t>& solution) {
+        ostringstream entry;
+        entry << "tiles " << solution.size() << endl;
+        for(auto& tile: solution) {
+            // The category of the tile is identified by its type, which must be that of a single tile of the collection
+            BaseMultiplierParametrization& param = tile.first;
+            string type = param.getMultType();
+            size_t index = tiles.MultTileCollection.size();
+            for(size_t i = 0; i < tiles.MultTileCollection.size(); i++) {
+                if(tiles.MultTileCollection[i]->getType() == type) {
+                    if(index != tiles.MultTileCollection.size()) {
+                        return;
+                    }
+                    index = i;
+                }
+            }
+            if(index == tiles.MultTileCollection.size() || param.isFlippedXY() || type.find_first_of(" \t\n") != string::npos) {
+                return;
+            }
+
+            vector<int> weights = param.getOutputWeights();
+            entry << index << " " << type << " " << param.getMultXWordSize() << " " << param.getMultYWordSize() << " "
+                  << (param.isSignedMultX() ? 1 : 0) << " " << (param.isSignedMultY() ? 1 : 0) << " " << param.getShapePara() << " "
+                  << tile.second.first << " " << tile.second.second << " " << weights.size();
+            for(auto w: weights) {
+                entry << " " << w;
+            }
+            entry << endl;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            entries_[description] = entry.str();
+        }
+
+        string dir = target->getCacheDir();
+        if(dir == "") {
+            return;
+        }
+
+        // Write to a file private to this thread, then rename it atomically
+        string hash = OperatorCache::keyHash(description);
+        mkdir(dir.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+        ostringstream tmpName;
+        tmpName << dir << "/" << hash << "." << getpid() << "." << std::hash<std::thread::id>()(std::this_thread::get_id()) << ".tmp";
+        ofstream file(tmpName.str());
+        file << entryHeader << endl;
+        file << "key " << count(description.begin(), description.end(), '\n') + 1 << endl;
+        file << description << endl;
+        file << entry.str();
+        file.close();
+        if(!file || rename(tmpName.str().c_str(), (dir + "/" + hash + ".tiling").c_str()) != 0) {
+            remove(tmpName.str().c_str());
+            if(UserInterface::verbose >= INFO) {
+                cerr << "> TilingCache: could not write a tiling in " << dir << endl;
+            }
+        }
+    }
+}
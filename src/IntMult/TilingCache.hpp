@@ -0,0 +1,61 @@
+#ifndef FLOPOCO_TILINGCACHE_HPP
+#define FLOPOCO_TILINGCACHE_HPP
+
+#include <mutex>
+#include <map>
+
+#include "TilingStrategy.hpp"
+#include "MultiplierTileCollection.hpp"
+
+namespace flopoco {
+
+/*!
+ * A cache of the tilings computed by IntMultiplier, so that a multiplier instantiated several times is tiled once.
+ *
+ * The key describes everything the tiling depends on: the multiplier shape (wX, wY, wOut, which implies the truncation),
+ * the signedness, the tiling method and its parameters, the tiles of the MultiplierTileCollection, the target, and the FloPoCo version.
+ * The entries are kept in memory for the whole run and, if the cacheDir generic option is set, stored in this directory
+ * next to the OperatorCache entries, so that e.g. an optimal tiling is computed once for all runs.
+ *
+ * A tile of a cached tiling is stored as the index of its BaseMultiplierCategory in MultiplierTileCollection::MultTileCollection,
+ * and reparametrized on lookup with the categories of the current collection.
+ */
+    class TilingCache {
+    public:
+        /**
+         * The description of a tiling problem from which the cache key is computed
+         * @param method the tiling method
+         * @param options the parameters of the tiling method, as name=value strings
+         * @param tiles the tiles available to the tiling strategy
+         */
+        static string keyDescription(int wX, int wY, int wOut, bool signedIO, string method, vector<string> options, MultiplierTileCollection& tiles, Target* target);
+
+        /**
+         * Looks up a tiling, in memory then in the cache directory of the target
+         * @param description the key description, see keyDescription()
+         * @param tiles the collection from which the tiles of the tiling are taken
+         * @param target the target, which gives the cache directory
+         * @param solution filled with the cached tiling on a hit
+         * @return true on a hit
+         */
+        static bool lookup(string description, MultiplierTileCollection& tiles, Target* target, list<TilingStrategy::mult_tile_t>& solution);
+
+        /**
+         * Stores a tiling, in memory and in the cache directory of the target if it is set.
+         * A tiling using a tile that is not in the collection (created by the tiling strategy itself) is not cached.
+         * @param description the key description, see keyDescription()
+         * @param tiles the collection given to the tiling strategy
+         * @param target the target, which gives the cache directory
+         * @param solution the tiling found by the tiling strategy
+         */
+        static void store(string description, MultiplierTileCollection& tiles, Target* target, list<TilingStrategy::mult_tile_t>& solution);
+
+    private:
+        /** Parses an entry (the tiles, after the key) into solution, false if it does not match the collection */
+        static bool parse(string entry, MultiplierTileCollection& tiles, list<TilingStrategy::mult_tile_t>& solution);
+
+        static std::mutex mutex_;
+        static std::map<string, string> entries_;   /**< the entries of this run, by key description */
+    };
+}
+#endif //FLOPOCO_TILINGCACHE_HPP
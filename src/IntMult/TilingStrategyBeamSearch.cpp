@@ -1,4 +1,6 @@
 #include <utility>
+#include <atomic>
+#include <thread>
 
 #include "TilingStrategyBeamSearch.hpp"
 #include "LineCursor.hpp"
@@ -54,6 +56,20 @@ namespace flopoco {
         usedDSPBlocks = 0;
         vector<tuple<BaseMultiplierCategory*, BaseMultiplierParametrization, multiplier_coordinates_t>> dspBlocks;
 
+        //the candidates of a step are evaluated concurrently, the first thread on the base field, the others on replicas of it
+        unsigned int threads = std::max(1u, std::min(std::thread::hardware_concurrency(), 2 * range));
+        vector<unique_ptr<FieldReplica>> replicas;
+        vector<BaseFieldState*> laneBaseState(1, &baseState);
+        vector<NearestPointCursor*> laneTempState(1, &tempState);
+        for(unsigned int t = 1; t < threads; t++) {
+            replicas.push_back(unique_ptr<FieldReplica>(new FieldReplica(wX, wY, signedIO)));
+            if(truncated_) {
+                replicas.back()->field.setTruncated(truncatedRange_, replicas.back()->baseState);
+            }
+            laneBaseState.push_back(&replicas.back()->baseState);
+            laneTempState.push_back(&replicas.back()->tempState);
+        }
+
         while(baseState.getMissing() > 0) {
             unsigned int minIndex = std::max(0, (int)next - (int)range);
             unsigned int maxIndex = std::min((unsigned int)tiles_.size() - 1, next + range);
@@ -64,30 +80,74 @@ namespace flopoco {
             lastPath = next;
             BaseMultiplierCategory* tile = tiles_[next];
 
-            for (unsigned int i = minIndex; i <= maxIndex; i++) {
-                //check if we got the already calculated greedy path
-                if (i == lastPath) {
-                    continue;
-                }
+            unsigned int candidates = maxIndex - minIndex + 1;
+            vector<char> valid(candidates, 0);
+            vector<double> costs(candidates, 0.0);
+            vector<unsigned int> areas(candidates, 0);
+            vector<queue<unsigned int>> paths(candidates);
+
+            //cost of the best rollout so far, to abort the others early
+            std::atomic<double> sharedBestCost(bestCost);
+            std::atomic<unsigned int> nextCandidate(minIndex);
+
+            auto evaluate = [&](unsigned int lane) {
+                for (unsigned int i = nextCandidate++; i <= maxIndex; i = nextCandidate++) {
+                    //check if we got the already calculated greedy path
+                    if (i == lastPath) {
+                        continue;
+                    }
 
-                BaseMultiplierCategory* t = tiles_[i];
+                    BaseMultiplierCategory* t = tiles_[i];
 
-                tempState.reset(baseState);
-                queue<unsigned int> tempPath;
-                unsigned int tempUsedDSPBlocks = usedDSPBlocks;
-                double tempCost = currentTotalCost;
-                unsigned int tempArea = currentArea;
+                    NearestPointCursor& state = *laneTempState[lane];
+                    state.reset(*laneBaseState[lane]);
+                    unsigned int tempUsedDSPBlocks = usedDSPBlocks;
+                    double tempCost = currentTotalCost;
+                    unsigned int tempArea = currentArea;
+                    double cmpCost = sharedBestCost.load();
 
-                vector<tuple<BaseMultiplierCategory*, BaseMultiplierParametrization, multiplier_coordinates_t>> localDSPBlocks = dspBlocks;
+                    vector<tuple<BaseMultiplierCategory*, BaseMultiplierParametrization, multiplier_coordinates_t>> localDSPBlocks = dspBlocks;
 
-                if (placeSingleTile(tempState, tempUsedDSPBlocks, nullptr, neededX, neededY, t, tempCost, tempArea, bestCost, localDSPBlocks)) {
-                    if(greedySolution(tempState, nullptr, &tempPath, tempCost, tempArea, tempUsedDSPBlocks, bestCost, &localDSPBlocks)) {
-                        bestCost = tempCost;
-                        bestArea = tempArea;
-                        path = move(tempPath);
-                        tile = t;
+                    if (placeSingleTile(state, tempUsedDSPBlocks, nullptr, neededX, neededY, t, tempCost, tempArea, cmpCost, localDSPBlocks)) {
+                        if(greedySolution(state, nullptr, &paths[i - minIndex], tempCost, tempArea, tempUsedDSPBlocks, cmpCost, &localDSPBlocks)) {
+                            valid[i - minIndex] = 1;
+                            costs[i - minIndex] = tempCost;
+                            areas[i - minIndex] = tempArea;
+
+                            double current = sharedBestCost.load();
+                            while(tempCost < current && !sharedBestCost.compare_exchange_weak(current, tempCost));
+                        }
                     }
                 }
+            };
+
+            unsigned int lanes = std::min(threads, candidates);
+            vector<std::thread> pool;
+            for(unsigned int lane = 1; lane < lanes; lane++) {
+                pool.push_back(std::thread(evaluate, lane));
+            }
+            evaluate(0);
+            for(auto& thread: pool) {
+                thread.join();
+            }
+
+            //same choice as evaluating the candidates one after another: the cheapest one, the last one on a tie
+            for (unsigned int i = minIndex; i <= maxIndex; i++) {
+                if(valid[i - minIndex] && costs[i - minIndex] <= bestCost) {
+                    bestCost = costs[i - minIndex];
+                    bestArea = areas[i - minIndex];
+                    path = move(paths[i - minIndex]);
+                    tile = tiles_[i];
+                }
+            }
+
+            //keep the replicas identical to the base field
+            for(auto& replica: replicas) {
+                unsigned int replicaUsedDSPBlocks = usedDSPBlocks;
+                double replicaCost = currentTotalCost;
+                unsigned int replicaArea = currentArea;
+                vector<tuple<BaseMultiplierCategory*, BaseMultiplierParametrization, multiplier_coordinates_t>> replicaDSPBlocks;
+                placeSingleTile(replica->baseState, replicaUsedDSPBlocks, nullptr, neededX, neededY, tile, replicaCost, replicaArea, FLT_MAX, replicaDSPBlocks);
             }
 
             //place single tile
@@ -108,7 +168,7 @@ namespace flopoco {
 
                 solution.push_back(make_pair(std::get<1>(tile).tryDSPExpand(x, y, wX, wY, signedIO), std::get<2>(tile)));
 
-                currentTotalCost += std::get<0>(tile)->getLUTCost(x, y, wX, wY);
+                currentTotalCost += tileCollection_.getLUTCost(std::get<0>(tile), x, y, wX, wY);
             }
         }
 
@@ -209,7 +269,7 @@ namespace flopoco {
             return true;
         }
 
-        cost += tile->getLUTCost(next.first, next.second, wX, wY);
+        cost += tileCollection_.getLUTCost(tile, next.first, next.second, wX, wY);
 
         if(dspBlockCnt == 0) {
             area += tile->getArea();
@@ -6,8 +6,10 @@
 #define FLOPOCO_TILINGSTRATEGYBEAMSEARCH_HPP
 
 #include "Field.hpp"
+#include "NearestPointCursor.hpp"
 #include "TilingStrategyGreedy.hpp"
 #include <queue>
+#include <memory>
 
 namespace flopoco {
     class TilingStrategyBeamSearch : public TilingStrategyGreedy {
@@ -30,6 +32,18 @@ namespace flopoco {
         void solve();
 
     private:
+        /**
+         * A copy of the field, on which a thread evaluates beam candidates.
+         * The same tiles as on the base state are placed on its base state, so both stay identical.
+         */
+        struct FieldReplica {
+            FieldReplica(unsigned int wX, unsigned int wY, bool signedIO) : field(wX, wY, signedIO, baseState) {}
+
+            NearestPointCursor baseState;
+            NearestPointCursor tempState;
+            Field field;
+        };
+
         unsigned int beamRange_;
         bool placeSingleTile(BaseFieldState& fieldState, unsigned int& usedDSPBlocks, list<mult_tile_t>* solution, const unsigned int neededX, const unsigned int neededY, BaseMultiplierCategory* tile, double& cost, unsigned int& area, double cmpCost, vector<tuple<BaseMultiplierCategory*, BaseMultiplierParametrization, multiplier_coordinates_t>>& dspBlocks);
     };
@@ -257,7 +257,7 @@ namespace flopoco {
                 tempArea += bm->getArea();
             }
 
-            tempCost += bm->getLUTCost(placementPos.first, placementPos.second, wX, wY);
+            tempCost += tileCollection_.getLUTCost(bm, placementPos.first, placementPos.second, wX, wY);
 
             if(tempCost > cmpCost) {
                 return false;
@@ -285,7 +285,7 @@ namespace flopoco {
                     solution->push_back(make_pair(std::get<1>(tile).tryDSPExpand(x, y, wX, wY, signedIO), std::get<2>(tile)));
                 }
 
-                tempCost += std::get<0>(tile)->getLUTCost(x, y, wX, wY);
+                tempCost += tileCollection_.getLUTCost(std::get<0>(tile), x, y, wX, wY);
 
                 if(tempCost > cmpCost) {
                     return false;
@@ -357,7 +357,7 @@ namespace flopoco {
                     solution->push_back(make_pair(tile->getParametrisation(), baseCoord));
                 }
 
-                cost += tile->getLUTCost(baseCoord.first, baseCoord.second, wX, wY);
+                cost += tileCollection_.getLUTCost(tile, baseCoord.first, baseCoord.second, wX, wY);
                 if(cost > cmpCost) {
                     return false;
                 }
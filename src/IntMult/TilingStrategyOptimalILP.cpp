@@ -2,6 +2,9 @@
 #include "IntMultiplier.hpp"
 #include "BaseMultiplierLUT.hpp"
 #include "MultiplierTileCollection.hpp"
+#ifndef HAVE_SCALP
+#include "TilingBranchAndBound.hpp"
+#endif
 
 using namespace std;
 namespace flopoco {
@@ -22,10 +25,14 @@ TilingStrategyOptimalILP::TilingStrategyOptimalILP(
 			signedIO_,
 			bmc),
 		small_tile_mult_{1}, //Most compact LUT-Based multiplier
+		prefered_multiplier_{prefered_multiplier},
 		numUsedMults_{0},
 		max_pref_mult_ {maxPrefMult},
 		occupation_threshold_{occupation_threshold},
 		tiles{mtc_.MultTileCollection}
+#ifndef HAVE_SCALP
+		, tileCollection_{mtc_}
+#endif
 	{
         for(auto &p:tiles)
         {
@@ -37,7 +44,8 @@ void TilingStrategyOptimalILP::solve()
 {
 
 #ifndef HAVE_SCALP
-    throw "Error, TilingStrategyOptimalILP::solve() was called but FloPoCo was not built with ScaLP library";
+    //same problem as the ILP below, solved by branch and bound, starting from the greedy tiling
+    solution = TilingBranchAndBound::solveFromGreedy(wX, wY, wOut, signedIO, baseMultiplierCollection, prefered_multiplier_, tiles, occupation_threshold_, max_pref_mult_, tileCollection_, target->getILPTimeout());
 #else
     cout << "using ILP solver " << target->getILPSolver() << endl;
     solver = new ScaLP::Solver(ScaLP::newSolverDynamic({target->getILPSolver(),"Gurobi","CPLEX","SCIP","LPSolve"}));
@@ -38,6 +38,7 @@ public:
 
 private:
     base_multiplier_id_t small_tile_mult_;
+    base_multiplier_id_t prefered_multiplier_;
     size_t numUsedMults_;
     size_t max_pref_mult_;
     float occupation_threshold_;
@@ -48,6 +49,8 @@ private:
     void constructProblem();
 
     ScaLP::Solver *solver;
+#else
+    MultiplierTileCollection tileCollection_;   /**< for the greedy tiling that seeds TilingBranchAndBound */
 #endif
 };
 
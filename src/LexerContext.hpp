@@ -30,6 +30,27 @@ public:
 		comment
 	} LexMode;
 
+	/** The role of a name found by the lexer, used by the second pass (Operator::doApplySchedule()) */
+	typedef enum {
+		lhsSignalName,  // left-hand side of an assignment
+		rhsSignalName,  // right-hand side of an assignment, including the selector of a with ... select
+		statementLabel, // label of a statement, e.g. the name of an instance
+		componentName,  // component of an instance
+		formalPortName, // port of the component in a port map (before the =>)
+		actualPortName  // signal connected to this port (after the =>)
+	} NameKind;
+
+	/**
+	 * A name found by the lexer: a span of the lexed code, with its role and its statement.
+	 * The vector of these names is the statement IR of the second pass: the code itself is output unmarked.
+	 */
+	typedef struct {
+		size_t position;  // offset of the name in the output stream
+		size_t length;    // length of the name in the output stream
+		NameKind kind;
+		size_t statement; // index of the statement: statements are separated by ;
+	} LexedName;
+
 	Operator* op;
 	void* scanner;
 	istream* is;
@@ -38,6 +59,8 @@ public:
 	string *lhsName;
 	vector<string> *extraRhsNames;
 	vector<triplet<string, string, int>> *dependenceTable;
+	vector<LexedName> *names;
+	size_t *statementCount;
 
 	LexMode *lexingMode;
 	LexMode *lexingModeOld;
@@ -47,6 +70,7 @@ public:
 public:
 	LexerContext(Operator* op_, istream* is, ostream* os,
 			string *lhsName_, vector<string> *extraRhsNames_, vector<triplet<string, string, int>> *dependenceTable_,
+			vector<LexedName> *names_, size_t *statementCount_,
 			LexMode *lexingMode_, LexMode *lexingModeOld_, bool *isLhsSet_) {
 		op=op_;
 		init_scanner();
@@ -56,6 +80,8 @@ public:
 		this->lhsName = lhsName_;
 		this->extraRhsNames = extraRhsNames_;
 		this->dependenceTable = dependenceTable_;
+		this->names = names_;
+		this->statementCount = statementCount_;
 		this->lexingMode = lexingMode_;
 		this->lexingModeOld = lexingModeOld_;
 		this->isLhsSet = isLhsSet_;
@@ -63,8 +89,20 @@ public:
 
 	//these methods are generated in VHDLLexer.cpp 
 
+	/** lex the input stream until its end. The scanner is restarted, so lex() may be called again once more input is available */
 	void lex();
 
+	/** write a name to the output stream, and record it with its role for the second pass */
+	void outputName(const char* text, size_t length, NameKind kind) {
+		LexedName name;
+		name.position = os->tellp();
+		name.length = length;
+		name.kind = kind;
+		name.statement = *statementCount;
+		names->push_back(name);
+		(*os) << text;
+	}
+
 	virtual ~LexerContext() { destroy_scanner();}
 
 protected:
@@ -42,6 +42,7 @@
 #include <sstream>
 #include <cstdlib>
 #include <set>
+#include <deque>
 #include "Operator.hpp"  // Useful only for reporting. TODO split out the REPORT and THROWERROR #defines from Operator to another include.
 #include "utils.hpp"
 #include <boost/random/mersenne_twister.hpp>
@@ -58,7 +59,7 @@ namespace flopoco{
 
 	// global variables used through most of FloPoCo,
 	// to be encapsulated in something, someday?
-	int Operator::uid = dist(rng);//init of the uid static member of Operator
+	std::atomic<int> Operator::uid(dist(rng));//init of the uid static member of Operator
 	int verbose=0;
 
 	Operator::Operator(Target* target): Operator(nullptr, target){
@@ -81,6 +82,7 @@ namespace flopoco{
 		isLibraryComponent_         = false;
 		noParseNoSchedule_          = false;
 		isOperatorScheduled_        = false;
+		signalsSeenByScheduler_     = 0;
 
  		parentOp_                   = parentOp;
 		isOperatorApplyScheduleDone_= false;
@@ -122,13 +124,7 @@ namespace flopoco{
 
 	void Operator::addSubComponent(OperatorPtr op) {
 		// Check it is already present
-		OperatorPtr alreadyPresent=nullptr;
-		for (auto i: subComponentList_){
-			if( op->getName() == i->getName() ) {
-				alreadyPresent=i;
-				// REPORT(DEBUG,"Operator::addToGlobalOpList(): " << op->getName() <<" already present in globalOpList");
-			}
-		}
+		OperatorPtr alreadyPresent = getSubComponent(op->getName());
 
 		if(alreadyPresent) {
 			if( op->isShared() )
@@ -138,6 +134,7 @@ namespace flopoco{
 		}
 		else{
 			subComponentList_.push_back(op);
+			subComponentMap_[op->getName()] = op;
 			if(op->isShared() )
 				UserInterface::addToGlobalOpList(op);
 		}
@@ -145,11 +142,26 @@ namespace flopoco{
 
 
 	OperatorPtr Operator::getSubComponent(string name){
-		for (auto op: subComponentList_) {
-			if (op->getName()==name)
-				return op;
-		}
-		return NULL;
+		auto it = subComponentMap_.find(name);
+		if(it == subComponentMap_.end())
+			return NULL;
+		return it->second;
+	}
+
+
+	void Operator::indexSubComponents(){
+		subComponentMap_.clear();
+		for (auto op: subComponentList_)
+			subComponentMap_[op->getName()] = op;
+	}
+
+
+	void Operator::renameSubComponent(Operator* op, string oldName){
+		auto it = subComponentMap_.find(oldName);
+		if(it == subComponentMap_.end() || it->second != op)
+			return;
+		subComponentMap_.erase(it);
+		subComponentMap_[op->getName()] = op;
 	}
 
 
@@ -464,13 +476,14 @@ namespace flopoco{
 		}
 
 		//search for the signal in the list of signals
-		if(!isSignalDeclared(name)) {
+		auto it = signalMap_.find(name);
+		if(it == signalMap_.end()) {
 			//signal not found, throw an error
 			THROWERROR("In getSignalByName, signal " << name << " not declared (operator " << this << ").");
 		}
 
 		//signal found, return the reference to it
-		return signalMap_[name];
+		return it->second;
 	}
 
 	bool Operator::isSignalDeclared(string name) {
@@ -493,7 +506,10 @@ namespace flopoco{
 
 
 	void Operator::setName(std::string operatorName){
+		string oldName = uniqueName_;
 		uniqueName_ = operatorName;
+		if(parentOp_ != nullptr)
+			parentOp_->renameSubComponent(this, oldName);
 	}
 
 	void Operator::setNameWithFreqAndUID(std::string operatorName){
@@ -501,12 +517,12 @@ namespace flopoco{
 		o <<  operatorName <<  "_" ;
 		o << "F"<<target_->frequencyMHz() ;
 		o << "_uid" << getNewUId();
-		uniqueName_ = o.str();
+		setName(o.str());
 	}
 
 	void  Operator::changeName(std::string operatorName){
 		commentedName_ = uniqueName_;
-		uniqueName_ = operatorName;
+		setName(operatorName);
 	}
 
 	string Operator::getName() const{
@@ -514,8 +530,9 @@ namespace flopoco{
 	}
 
 	int Operator::getNewUId(){
-        printf("UUID=%d\n", Operator::uid);
-		return Operator::uid++;
+		int newUId = Operator::uid++;
+        printf("UUID=%d\n", newUId);
+		return newUId;
 	}
 
 	OperatorPtr Operator::setParentOperator(OperatorPtr parentOp){
@@ -1196,7 +1213,6 @@ namespace flopoco{
 		s->setCriticalPath(0.0);
 		s->setCriticalPathContribution(0.0);
 		s->setHasBeenScheduled(true);
-		alreadyScheduled.insert(s);
 
 		// add the newly created signal to signalMap and signalList
 		signalList_.push_back(s);
@@ -1856,12 +1872,35 @@ namespace flopoco{
 			}
 		}
 		// Get correct outputs
-		emulate(tc);
+		emulateTestCase(tc);
 
 		// add to the test case list
 		return tc;
 	}
 
+	void Operator::emulateFast(FastTestCase * tc){
+		THROWERROR("emulateFast() is not implemented for this operator");
+	}
+
+	bool Operator::hasEmulateFast(){
+		return false;
+	}
+
+	void Operator::emulateTestCase(TestCase * tc){
+		if(hasEmulateFast()) {
+			FastTestCase ftc(this);
+			ftc.setInputs(tc);
+			emulateFast(&ftc);
+			ftc.addExpectedOutputsTo(tc);
+		}
+		else
+			emulate(tc);
+	}
+
+	bool Operator::isEmulateThreadSafe(){
+		return false;
+	}
+
 	Target* Operator::getTarget(){
 		return target_;
 	}
@@ -1891,7 +1930,7 @@ namespace flopoco{
 		return cost;
 	}
 
-	map<string, Signal*> Operator::getSignalMap(){
+	unordered_map<string, Signal*> Operator::getSignalMap(){
 		return signalMap_;
 	}
 
@@ -1994,415 +2033,156 @@ namespace flopoco{
 
 
 
-	// Comment by F2D: this whas parse2().
-	// This code is suspected to be OK except for the handling of functional delays
-	// It could probably be simplified: it is a lexer
-	void Operator::doApplySchedule()
-	{
-		ostringstream newStr;
-		string oldStr, workStr;
-		size_t currentPos, nextPos, tmpCurrentPos, tmpNextPos;
-		int count, lhsNameLength, rhsNameLength;
-		bool unknownLHSName = false, unknownRHSName = false;
-
-		REPORT(DEBUG, "doApplySchedule(): entering operator " << getName());
-		REPORT(FULL, "doApplySchedule: vhdl stream after first lexing " << endl << vhdl.str());
-		//reset the new vhdl code buffer
-		newStr.str("");
-
-		//set the old code to the vhdl code stored in the FlopocoStream
-		oldStr = vhdl.str();
-
-		//iterate through the old code, one statement at the time
-		// code that doesn't need to be modified: goes directly to the new vhdl code buffer
-		// code that needs to be modified: ?? should be removed from lhs_name, $$ should be removed from rhs_name,
-		//		delays of the type rhs_name_dxxx should be added for the right-hand side signals
-		bool isSelectedAssignment = (oldStr.find('?') > oldStr.find('$'));
-		currentPos = 0;
-		nextPos = (isSelectedAssignment ? oldStr.find('$') : oldStr.find('?'));
-		while(nextPos !=  string::npos)
-			{
-				string lhsName, rhsName;
-				size_t auxPosition, auxPosition2;
-				Signal *lhsSignal, *rhsSignal;
-
-				unknownLHSName = false;
-				unknownRHSName = false;
-
-				//copy the code from the beginning to this position directly to the new vhdl buffer
-				newStr << oldStr.substr(currentPos, nextPos-currentPos);
-
-				//now get a new line to parse
-				workStr = oldStr.substr(nextPos+2, oldStr.find(';', nextPos)+1-nextPos-2);
-
-				REPORT(FULL, "doApplySchedule: processing " << workStr);
-				//extract the lhs_name
-				if(isSelectedAssignment == true)
-					{
-						int lhsNameStart, lhsNameStop;
-
-						lhsNameStart = workStr.find('?');
-						lhsNameStop  = workStr.find('?', lhsNameStart+2);
-						lhsName = workStr.substr(lhsNameStart+2, lhsNameStop-lhsNameStart-2);
-						auxPosition = lhsNameStop+2;
-					}else
-					{
-						lhsName = workStr.substr(0, workStr.find('?'));
-
-						//copy lhsName to the new vhdl buffer
-						newStr << lhsName;
-
-						auxPosition = lhsName.size()+2;
-					}
-				lhsNameLength = lhsName.size();
-
-				//check for component instances
-				//	the first parse marks the name of the component as a lhsName
-				//	must remove the markings
-				//the rest of the code contains pairs of ??lhsName?? => $$rhsName$$ pairs
-				//	for which the helper signals must be removed and delays _dxxx must be added
-				auxPosition2 = workStr.find("port map"); // not checking capitalization is OK because this string can only be created by flopoco
-
-				if(auxPosition2 != string::npos)	{
-					// we have the position of "port map"; we need the name of the instance name.
-					// It is the word before the ":"; all this looks terribly fragile and depends on the fact that this VHDL is created here in flopoco.
-					size_t i=nextPos;
-					while(oldStr[i]!=':')
-						i--;
-					size_t endInstanceName = i;
-					while(oldStr[i]!=' ')
-						i--;
-					size_t beginInstanceName = i+1;
-					string instanceName = oldStr.substr(beginInstanceName, endInstanceName-beginInstanceName);
-					REPORT(FULL,"doApplySchedule found instance name >>>>"<<instanceName<<"<<<<");
-				
-					string subOpName=lhsName;
-					OperatorPtr subop = getSubComponent(subOpName);
-					if(subop==nullptr)
-						THROWERROR("doApplySchedule(): " << subOpName << " does not seem to be a subcomponent of " << getName());
-					REPORT(DEBUG, "doApplySchedule: found instance: " << subOpName);//workStr.substr(auxPosition, auxPosition2));
-					//try to parse the names of the signals in the port mapping
-					if(workStr.find("?", auxPosition2) == string::npos) {
-						//empty port mapping
-						newStr << workStr.substr(auxPosition, workStr.size());
-					} else {
-						//parse a list of ??lhsName?? => $$rhsName$$
-						//	or ??lhsName?? => 'x' or ??lhsName?? => "xxxx"
-						size_t tmpCurrentPos, tmpNextPos;
-
-						//copy the code up to the port mappings
-						newStr << workStr.substr(auxPosition, workStr.find("?", auxPosition2)-auxPosition);
-
-						tmpCurrentPos = workStr.find("?", auxPosition2);
-						while(tmpCurrentPos != string::npos)	{
-							bool singleQuoteSep = false, doubleQuoteSep = false, open = false;
-							bool rhsIsSignal=false;
-							//extract a lhsName
-							tmpNextPos = workStr.find("?", tmpCurrentPos+2);
-							lhsName = workStr.substr(tmpCurrentPos+2, tmpNextPos-tmpCurrentPos-2);
-							REPORT(FULL, "doApplySchedule: instance lhsName=" << lhsName);
-
-							//copy lhsName (the formal input/output) to the new vhdl buffer
-							newStr << lhsName;
-
-							//copy the code up to the next rhsName to the new vhdl buffer
-							tmpCurrentPos = tmpNextPos+2;
-							tmpNextPos = workStr.find("$", tmpCurrentPos);
-
-							//check for constant as rhs name
-							if(workStr.find("\'", tmpCurrentPos) < tmpNextPos)	{
-								tmpNextPos = workStr.find("\'", tmpCurrentPos);
-								singleQuoteSep = true;
-							}
-							else if(workStr.find("\"", tmpCurrentPos) < tmpNextPos)  {
-								tmpNextPos = workStr.find("\"", tmpCurrentPos);
-								doubleQuoteSep = true;
-							}
-							else if(workStr.find("open", tmpCurrentPos) < tmpNextPos)	{
-								tmpNextPos = workStr.find("open", tmpCurrentPos);
-								open = true;
-							}
-
-							REPORT(FULL, "doApplySchedule/instance skipping: " << workStr.substr(tmpCurrentPos, tmpNextPos-tmpCurrentPos));
-							newStr << workStr.substr(tmpCurrentPos, tmpNextPos-tmpCurrentPos);
-
-							//extract a rhsName
-							//	this might be a constant
-							if(singleQuoteSep) {
-								//a 1-bit constant
-								tmpCurrentPos = tmpNextPos+1;
-								tmpNextPos = workStr.find("\'", tmpCurrentPos);
-							}
-							else if(doubleQuoteSep) {
-								//a multiple bit constant
-								tmpCurrentPos = tmpNextPos+1;
-								tmpNextPos = workStr.find("\"", tmpCurrentPos);
-							}
-							else if(open) {
-								//a open output
-								tmpNextPos = workStr.find("open", tmpCurrentPos)-1; //has to be one less as we want the 'o' of "open"
-								tmpCurrentPos = tmpNextPos+1;
-							}
-							else {
-								//a regular signal name
-								tmpCurrentPos = tmpNextPos+2;
-								tmpNextPos = workStr.find("$", tmpCurrentPos);
-								rhsIsSignal = true;
-							}
-
-							rhsName = workStr.substr(tmpCurrentPos, tmpNextPos-tmpCurrentPos);
-							REPORT(FULL, "doApplySchedule/instance rhsname= " << rhsName);
-
-							//						rhsSignal = NULL;
-							//						lhsSignal = NULL;
-
-							//copy rhsName to the new vhdl buffer
-							if(!open)
-								newStr << (singleQuoteSep ? "\'" : doubleQuoteSep ? "\"" : "") << rhsName << (singleQuoteSep ? "\'" : doubleQuoteSep ? "\"" : "");
-							//                        else
-							//                            newStr << "open";
-
-							// All the inputs should be synchronized.
-							// We do this by comparing their cycle to the cycle of the first output of the instance. 
-							try {
-								//	delay it if necessary, i.e. if it is a shared instance with a dependency to a later signal
-								if(isSequential()
-									 && rhsIsSignal // rhs is not a constant
-									 && subop->isShared() // otherwise the dependency graph takes care of all the pipelining
-									 && subop->getSignalByName(lhsName)->type() == Signal::in
-									 ) {// the lhs is a input of the subcomponent
-									// In this case, we have in the dep graph the dependencies (actualIn->actualOut): extract the first one
-									Signal* subopInput = getSignalByName(rhsName);
-									//look for the first output
-									int i=0; 
-									while((*subop->getIOList())[i]->type() != Signal::out)
-										i++;
-									vector<string> actualIO = instanceActualIO_[instanceName];
-									Signal* subopOutput = getSignalByName(actualIO[i]);
-								
-									// was								subopOutput = (*subopInput->successors())[0].first; // but bug if the actual input has other successors
-									REPORT(DEBUG, "doApplySchedule: shared instance: " << instanceName << " has input " << subopInput->getName() << " and output " << subopOutput->getName());//workStr.substr(auxPosition, auxPosition2));
-									int deltaCycle =subopOutput->getCycle() - subopInput->getCycle();
-									if( deltaCycle> 0) {
-										newStr << "_d" << vhdlize(deltaCycle);
-										subopInput -> updateLifeSpan(deltaCycle);
-									}
-								}
-							}
-							catch(string &e) {
-								REPORT(FULL, "doApplySchedule caught " << e << " and is ignoring it.");
-							}
-							catch(char const *e) {
-								REPORT(FULL, "doApplySchedule caught " << e << " and is ignoring it.");
-							}
-
-							//prepare to parse a new pair
-							tmpCurrentPos = workStr.find("?", tmpNextPos+2);
-
-							//copy the rest of the code to the new vhdl buffer
-							if(tmpCurrentPos != string::npos)
-								newStr << workStr.substr(tmpNextPos+(singleQuoteSep||doubleQuoteSep||open ? 1 : 2),
-																				 tmpCurrentPos-tmpNextPos-(singleQuoteSep||doubleQuoteSep||open ? 1 : 2));
-							else
-								newStr << workStr.substr(tmpNextPos+(singleQuoteSep||doubleQuoteSep||open ? 1 : 2), workStr.size());
-						}
-					}
-
-					//prepare for a new instruction to be parsed
-					currentPos = nextPos + workStr.size() + 2;
-					nextPos = oldStr.find('?', currentPos);
-					//special case for the selected assignment statements
-					isSelectedAssignment = false;
-					if(oldStr.find('$', currentPos) < nextPos)
-						{
-							nextPos = oldStr.find('$', currentPos);
-							isSelectedAssignment = true;
-						}
-
-					continue;
-				}
-
-				//the lhsName could be of the form (lhsName1, lhsName2, ...)
-				//	extract the first name in the list
-				if(lhsName[0] == '(')
-					{
-						count = 1;
-						while((lhsName[count] != ' ') && (lhsName[count] != '\t')
-									&& (lhsName[count] != ',') && (lhsName[count] != ')'))
-							count++;
-						lhsName = lhsName.substr(1, count-1);
-					}
-
-				//this could be a user-defined name
-				try			{
-			    lhsSignal = getSignalByName(lhsName);
-				}
-				catch(string &e)	{
-			    lhsSignal = NULL;
-			    unknownLHSName = true;
-				}
-				//check for "select" signal assignments
-				//	with signal_name select... etc
-				//	the problem is there is a signal belonging to the right hand side
-				//	on the left-hand side, before the left hand side signal, which breaks the regular flow
-				if(isSelectedAssignment == true)		{
-					//extract the first rhs signal name
-					tmpCurrentPos = 0;
-					tmpNextPos = workStr.find('$');
-
-					assert(tmpNextPos != string::npos);
-
-					rhsName = workStr.substr(tmpCurrentPos, tmpNextPos);
-
-					//remove the possible parentheses around the rhsName
-					string newRhsName = rhsName;
-					if(rhsName.find("(") != string::npos)	{
-						newRhsName = newRhsName.substr(rhsName.find("(")+1, rhsName.find(")")-rhsName.find("(")-1);
-					}
-					// No functional register possible here
-					try			{
-						rhsSignal = getSignalByName(newRhsName);
-					}
-					catch(...){
-						//this i must be user-defined name
-						rhsSignal = NULL;
-						unknownRHSName = true;
-					}
-
-					//output the rhs signal name
-					newStr << rhsName;
-
-					if(isSequential() && !unknownLHSName  && !unknownRHSName) {
-						int deltaCycle = lhsSignal->getCycle()-rhsSignal->getCycle();
-						if( deltaCycle> 0)
-							newStr << "_d" << vhdlize(deltaCycle);
-					}
-					//copy the code up until the lhs signal name
-					tmpCurrentPos = tmpNextPos+2;
-					tmpNextPos = workStr.find('?', tmpCurrentPos);
+	/* Copy the lexed code between the positions from and to */
+	static void copyLexedCode(stringstream& code, size_t from, size_t to, ostream& out) {
+		char buffer[4096];
+		code.seekg(from);
+		while(from < to) {
+			size_t chunk = std::min<size_t>(to-from, sizeof(buffer));
+			code.read(buffer, chunk);
+			out.write(buffer, chunk);
+			from += chunk;
+		}
+	}
 
-					newStr << workStr.substr(tmpCurrentPos, tmpNextPos-tmpCurrentPos);
 
-					//copy the lhs signal name
-					newStr << lhsName;
+	/* Read back a name recorded by the lexer */
+	static string readLexedName(stringstream& code, const LexerContext::LexedName& name) {
+		string s(name.length, ' ');
+		code.seekg(name.position);
+		code.read(&s[0], name.length);
+		return s;
+	}
 
-					//prepare to parse a new rhs name
-					tmpCurrentPos = tmpNextPos+4+lhsNameLength;
-					tmpNextPos = workStr.find('$', tmpCurrentPos);
 
-					//if there are is more code that needs preparing, then just pass
-					//to the next instruction
-					if(tmpNextPos == string::npos)
-						{
-							//copy the rest of the code
-							assert(workStr.size()-tmpCurrentPos > 0);
-							newStr << workStr.substr(tmpCurrentPos, workStr.size()-tmpCurrentPos);
-
-							//prepare for a new instruction to be parsed
-							currentPos = nextPos + workStr.size() + 2;
-							nextPos = oldStr.find('?', currentPos);
-							//special case for the selected assignment statements
-							isSelectedAssignment = false;
-							if(oldStr.find('$', currentPos) < nextPos)
-								{
-									nextPos = oldStr.find('$', currentPos);
-									isSelectedAssignment = true;
-								}
-
-							continue;
-						}
-				}
-				//extract the rhsNames and annotate them find the position of the rhsName, and copy
-				// the vhdl code up to the rhsName in the new vhdl code buffer
-				// There was a bug here  if one variable is had select in its name
-				// Took me 2hours to figure out
-				// Bug fixed by having the lexer add spaces around select (so no need to test for all the space/tab/enter possibilibits.
-				// I wonder how many such bugs remain
-				if(workStr.find(" select ") == string::npos	 )			{
-					tmpCurrentPos = lhsNameLength+2;
-					tmpNextPos = workStr.find('$', lhsNameLength+2);
-				}
-				while(tmpNextPos != string::npos)	{
-					unknownRHSName = false;
-
-					//copy into the new vhdl stream the code that doesn't need to be modified
-					newStr << workStr.substr(tmpCurrentPos, tmpNextPos-tmpCurrentPos);
-
-					//skip the '$$'
-					tmpNextPos += 2;
-
-					//extract a new rhsName
-					rhsName = workStr.substr(tmpNextPos, workStr.find('$', tmpNextPos)-tmpNextPos);
-					rhsNameLength = rhsName.size();
-					//remove the possible parentheses around the rhsName
-					string newRhsName = rhsName;
-					if(rhsName.find("(") != string::npos)	{
-						newRhsName = newRhsName.substr(rhsName.find("(")+1, rhsName.find(")")-rhsName.find("(")-1);
-					}
+	// Comment by F2D: this whas parse2().
+	// The first lexing leaves the code unchanged, and records in vhdl.lexedNames the names it contains with their role:
+	// this second pass walks through these names, one statement at a time, and outputs the final code in one pass,
+	// adding the delays _dxxx to the right-hand side names.
+	void Operator::doApplySchedule()
+	{
+		REPORT(DEBUG, "doApplySchedule(): entering operator " << getName());
+		vhdl.flushAndParseAndBuildDependencyTable();
+		REPORT(FULL, "doApplySchedule: vhdl stream after first lexing " << endl << vhdl.vhdlCode.str());
+
+		stringstream& code = vhdl.vhdlCode;
+		const vector<LexerContext::LexedName>& names = vhdl.lexedNames;
+		stringstream newCode;
+		size_t currentPos = 0; // the code before it has already been copied to newCode
+
+		size_t first = 0;
+		while(first < names.size()) {
+			//the names of the current statement are names[first] to names[last-1]
+			size_t last = first;
+			while(last < names.size() && names[last].statement == names[first].statement)
+				last++;
+
+			//read the names of the statement, and find its left-hand side signal, or its component if it is an instance.
+			//	In a selected assignment, the selector comes before the left-hand side
+			vector<string> nameStrings;
+			string lhsName, componentName, instanceName;
+			for(size_t i=first; i<last; i++) {
+				nameStrings.push_back(readLexedName(code, names[i]));
+				if(names[i].kind == LexerContext::lhsSignalName && lhsName == "")
+					lhsName = nameStrings.back();
+				else if(names[i].kind == LexerContext::statementLabel && componentName == "")
+					instanceName = nameStrings.back();
+				else if(names[i].kind == LexerContext::componentName)
+					componentName = nameStrings.back();
+			}
+			REPORT(FULL, "doApplySchedule: processing statement with lhs " << lhsName << " component " << componentName);
+
+			OperatorPtr subop = nullptr;
+			Signal* lhsSignal = nullptr;
+			if(componentName != "") {
+				subop = getSubComponent(componentName);
+				if(subop==nullptr)
+					THROWERROR("doApplySchedule(): " << componentName << " does not seem to be a subcomponent of " << getName());
+				REPORT(DEBUG, "doApplySchedule: found instance " << instanceName << " of " << componentName);
+			}
+			else if(isSignalDeclared(lhsName)) { // otherwise this is a user-defined name
+				lhsSignal = getSignalByName(lhsName);
+			}
+
+			string formalName;
+			for(size_t i=first; i<last; i++) {
+				const LexerContext::LexedName& name = names[i];
+				const string& nameString = nameStrings[i-first];
+
+				//copy the code up to this name, which doesn't need to be modified
+				copyLexedCode(code, currentPos, name.position, newCode);
+				currentPos = name.position + name.length;
+
+				if(name.kind == LexerContext::rhsSignalName) {
 					//this could also be a delayed signal name
-					int functionalDelay=0;
-					if(newRhsName.find('^') != string::npos){
-						string sdelay = newRhsName.substr(newRhsName.find('^') + 1, string::npos-1);
-						newRhsName = newRhsName.substr(0, newRhsName.find('^'));
-						REPORT(FULL, "doApplySchedule: Found funct. delayed signal  : " << newRhsName << " delay:" << sdelay );
-						functionalDelay = stoi(sdelay);
-					}
-
-					try			{
-						rhsSignal = getSignalByName(newRhsName);
-					}
-					catch(...){
-						//this i must be user-defined name
-						rhsSignal = NULL;
-						unknownRHSName = true;
+					string rhsName = nameString;
+					int functionalDelay = 0;
+					if(rhsName.find('^') != string::npos) {
+						functionalDelay = stoi(rhsName.substr(rhsName.find_last_of('^')+1));
+						rhsName = rhsName.substr(0, rhsName.find('^'));
+						REPORT(FULL, "doApplySchedule: Found funct. delayed signal  : " << rhsName << " delay:" << functionalDelay);
 					}
 
-
-					//copy the rhsName with the delay information into the new vhdl buffer
-					//	rhsName becomes rhsName_dxxx, if the rhsName signal is declared at a previous cycle
-					newStr << newRhsName;
-					if(isSequential() && !unknownLHSName && !unknownRHSName) {
+					//rhsName becomes rhsName_dxxx, if the rhsName signal is declared at a previous cycle
+					newCode << rhsName;
+					if(isSequential() && lhsSignal != nullptr && isSignalDeclared(rhsName)) {
+						Signal* rhsSignal = getSignalByName(rhsName);
 						// Should we insert a pipeline register ?
 						int deltaCycle = lhsSignal->getCycle() - rhsSignal->getCycle();
 						if(deltaCycle>0)
-							newStr << "_d" << vhdlize(deltaCycle);
-					
+							newCode << "_d" << vhdlize(deltaCycle);
+
 						// Should we insert a functional register ? This case is exclusive with the previous as long as functional delays are introduced only by the functionalRegister method.
 						if(functionalDelay>0) {
-							getSignalByName(newRhsName) -> updateLifeSpan(functionalDelay); // wonder where it is done for pipeline registers???
-							newStr << "_d" << vhdlize(functionalDelay);
+							rhsSignal -> updateLifeSpan(functionalDelay); // wonder where it is done for pipeline registers???
+							newCode << "_d" << vhdlize(functionalDelay);
 						}
 					}
-					
-					//find the next rhsName, if there is one
-					tmpCurrentPos = tmpNextPos + rhsNameLength + 2;
-					tmpNextPos = workStr.find('$', tmpCurrentPos);
 				}
-
-				//copy the code that is left up until the end of the line in
-				//	the new vhdl code buffer, without changing it
-				newStr << workStr.substr(tmpCurrentPos, workStr.size()-tmpCurrentPos);
-
-				//get a new line to parse
-				currentPos = nextPos + workStr.size() + 2;
-				nextPos = oldStr.find('?', currentPos);
-				//special case for the selected assignment statements
-				isSelectedAssignment = false;
-				if(oldStr.find('$', currentPos) < nextPos)
-					{
-						nextPos = oldStr.find('$', currentPos);
-						isSelectedAssignment = true;
+				else if(name.kind == LexerContext::actualPortName && subop != nullptr) {
+					newCode << nameString;
+					// All the inputs should be synchronized.
+					// We do this by comparing their cycle to the cycle of the first output of the instance.
+					//	Delay it if necessary, i.e. if it is a shared instance with a dependency to a later signal:
+					//	otherwise the dependency graph takes care of all the pipelining
+					if(isSequential()
+						 && subop->isShared()
+						 && subop->isSignalDeclared(formalName)
+						 && subop->getSignalByName(formalName)->type() == Signal::in
+						 && isSignalDeclared(nameString)) {
+						// In this case, we have in the dep graph the dependencies (actualIn->actualOut): extract the first one
+						Signal* subopInput = getSignalByName(nameString);
+						//look for the first output
+						size_t o=0;
+						while(o < subop->getIOList()->size() && (*subop->getIOList())[o]->type() != Signal::out)
+							o++;
+						vector<string>& actualIO = instanceActualIO_[instanceName];
+						if(o < actualIO.size() && isSignalDeclared(actualIO[o])) {
+							Signal* subopOutput = getSignalByName(actualIO[o]);
+							REPORT(DEBUG, "doApplySchedule: shared instance: " << instanceName << " has input " << subopInput->getName() << " and output " << subopOutput->getName());
+							int deltaCycle = subopOutput->getCycle() - subopInput->getCycle();
+							if(deltaCycle > 0) {
+								newCode << "_d" << vhdlize(deltaCycle);
+								subopInput -> updateLifeSpan(deltaCycle);
+							}
+						}
 					}
+				}
+				else {
+					//left-hand side, label, component or formal port: copied unchanged
+					if(name.kind == LexerContext::formalPortName)
+						formalName = nameString;
+					newCode << nameString;
+				}
 			}
 
-		//the remaining code might contain identifiers that were marked
-		//	with ??; these must also be removed
-		//if(nextPos == string::npos) && (oldStr.find )
+			first = last;
+		}
 
-		//copy the remaining code to the vhdl code buffer
-		newStr << oldStr.substr(currentPos, oldStr.size()-currentPos);
+		//copy the remaining code
+		copyLexedCode(code, currentPos, code.tellp(), newCode);
 
-		vhdl.setSecondLevelCode(newStr.str());
+		vhdl.setSecondLevelCode(newCode);
 
 		REPORT(DEBUG, "doApplySchedule: finished " << getName());
 	}
@@ -2468,10 +2248,13 @@ namespace flopoco{
 	}
 
 
-	// this is called by schedule() to transform the (string, string, int) dependencies produced by the lexer at each ;
+	// this is called by schedule() to transform the (string, string, int) dependencies produced by the lexer
 	// into signal dependencies in the graph.
 	void Operator::moveDependenciesToSignalGraph()
 	{
+		// lex the VHDL accumulated since the previous call, in one pass
+		vhdl.flushAndParseAndBuildDependencyTable();
+
 		//try to parse the unknown dependences first (we have identified a dependency A->B but A or B has not yet been declared)
 		// unresolvedDependenceTable is a global variable that holds this information
 		vector<triplet<string, string, int>> newURDTable;
@@ -2511,7 +2294,7 @@ namespace flopoco{
 			}
 		unresolvedDependenceTable = newURDTable;
 		// Now go through the dependence table built by the vhdl lexer, transfering the corresponding information into the Signal graph.
-		// dependenceTable is updated by the lexer between two VHDL statements / semicolons
+		// dependenceTable has just been updated by the lexer, see the beginning of this method
 		for(vector<triplet<string, string, int>>::iterator it=vhdl.dependenceTable.begin(); it!=vhdl.dependenceTable.end(); it++)
 			{
 				Signal *lhs, *rhs;
@@ -2568,23 +2351,80 @@ namespace flopoco{
 
 	}
 
-	void  Operator::buildAlreadyScheduledList(set<Signal*> & alreadyScheduled) {
-		for(auto i: signalList_)	{
-			if (i->predecessors()->size()==0) {
-				i->setHasBeenScheduled(true);
-			}
-			if (i->hasBeenScheduled()) {  // this captures the previous constant signals but also the functional register outputs
-				alreadyScheduled.insert(i);
-			}
+	thread_local bool Operator::schedulerRunning_ = false;
 
+	void Operator::addSchedulerSeed(Signal* s) {
+		if(!schedulerRunning_)
+			schedulerSeeds_.push_back(s);
+	}
+
+
+	void  Operator::collectNewSignalsToSchedule(vector<Signal*> & newSignals, vector<Signal*> & seeds) {
+		for(size_t i=signalsSeenByScheduler_; i<signalList_.size(); i++)	{
+			Signal* s = signalList_[i];
+			if (s->predecessors()->size()==0) {
+				s->setHasBeenScheduled(true); // this captures the constant signals but also the functional register outputs
+			}
+			newSignals.push_back(s);
 		}
+		signalsSeenByScheduler_ = signalList_.size();
+		seeds.insert(seeds.end(), schedulerSeeds_.begin(), schedulerSeeds_.end());
+		schedulerSeeds_.clear();
 		// and do the same recursively for all subcomponents
 		for(auto op: subComponentList_)	{
-			op->buildAlreadyScheduledList(alreadyScheduled);
+			op->collectNewSignalsToSchedule(newSignals, seeds);
 		}
 	}
 
 
+	/* Sets Operator::schedulerRunning_ for the duration of a schedule(), even if it throws */
+	struct SchedulerRunningGuard {
+		bool & flag;
+		SchedulerRunningGuard(bool & flag_) : flag(flag_) { flag = true; }
+		~SchedulerRunningGuard() { flag = false; }
+	};
+
+
+	/* A signal has just been scheduled: decrement the pending-predecessor counter of its successors,
+		 and push on the ready queue those for which it reaches zero. */
+	static void releaseSuccessors(Signal* s, deque<Signal*> & readyQueue) {
+		for(auto i : *s->successors()) {
+			Signal* successor = i.first;
+			if(successor->hasBeenScheduled())
+				continue;
+			int pending = successor->getUnscheduledPredecessors() - 1;
+			successor->setUnscheduledPredecessors(pending);
+			if(pending <= 0)
+				readyQueue.push_back(successor);
+		}
+	}
+
+
+	/* The exact count, used to (re)initialize the counter of a signal. */
+	static int countUnscheduledPredecessors(Signal* s) {
+		int count = 0;
+		for(auto i : *s->predecessors()) {
+			if(!i.first->hasBeenScheduled())
+				count++;
+		}
+		return count;
+	}
+
+
+	/*
+		 The scheduler is called before each subcomponent is built (from newInstance()), so it must not rescan the whole design at each call.
+		 It is an incremental topological sort:
+		 - each signal holds a counter of its predecessors not yet scheduled;
+		 - each Operator remembers how many of its signals have already been seen by the scheduler, so a call only visits the new ones;
+		 - a ready queue holds the signals whose counter dropped to zero.
+		 The counter is only a hint, since dependencies may be added to a signal after it has been counted:
+		 when a signal comes out of the ready queue, its predecessors are checked again, and the counter is refreshed if it is not ready after all.
+		 Edges may also be added from a signal that is already scheduled (e.g. to a subcomponent input port connected to a signal of its parent),
+		 and signals may be marked as scheduled outside schedule() (e.g. by the bit heap): their successors are recorded as seeds
+		 (see addSchedulerSeed()), and counted again by the next call.
+		 The result is the same as that of the previous wavefront algorithm: at the end of each call,
+		 every unscheduled signal has at least one unscheduled predecessor.
+	*/
 	void Operator::schedule()
 	{
 		REPORT(DEBUG, "Entering schedule() of operator " << getName() << " with isOperatorScheduled_="<< isOperatorScheduled_); 
@@ -2603,81 +2443,74 @@ namespace flopoco{
 		else { // We are the root parent op
 			REPORT(DEBUG, "schedule(): It seems I am a root Operator, starting scheduling");
 
+			SchedulerRunningGuard guard(schedulerRunning_);
+			deque<Signal*> readyQueue;
+			size_t visited=0, numberScheduled=0;
 
-			// Algorithm initialization
-			// We need a global list of all the signals of the graph
-			size_t numberScheduled;
-			set<Signal*> successorsFront;
 			// restate that inputs  are already scheduled for good measure (recall that we are in the top level)
 			for(auto i: ioList_)	{
-				if (i->type()==Signal::in) {
-					alreadyScheduled.insert(i); // TODO refactor into one call setScheduled(Signal*) ? 
+				if (i->type()==Signal::in && !i->hasBeenScheduled()) {
 					i->setHasBeenScheduled(true);
+					releaseSuccessors(i, readyQueue);
 				}
 			}
-			// recursively run through subcomponents looking for already scheduled signals such as constants signals, functional register outputs, etc
-			buildAlreadyScheduledList(alreadyScheduled);
-			
-			// then build the current wavefront (new successors may have been added to already scheduled signals)
-			for(auto i: alreadyScheduled)	{
-				for(auto successor : *i->successors()) {
-					if(successor.first->hasBeenScheduled()==false)
-						successorsFront.insert(successor.first);
+
+			// recursively run through subcomponents looking for the signals declared since the previous call
+			vector<Signal*> newSignals, seeds;
+			collectNewSignalsToSchedule(newSignals, seeds);
+			for(auto s: newSignals) {
+				visited++;
+				if(s->hasBeenScheduled()) {
+					// constants, functional register outputs, or signals scheduled by someone else (e.g. the bit heap)
+					releaseSuccessors(s, readyQueue);
+				}
+				else {
+					int pending = countUnscheduledPredecessors(s);
+					s->setUnscheduledPredecessors(pending);
+					if(pending==0)
+						readyQueue.push_back(s);
 				}
 			}
 
-			numberScheduled=0;
-			// The main loop only tries to schedule signals in the wavefront
-			while(alreadyScheduled.size() > numberScheduled) {
-				// Things are still moving
-				numberScheduled = alreadyScheduled.size();
-				set<Signal*> nextIterationFront;
-
-				// REPORTING
-				{
-					ostringstream s1,s2;
-					for(auto i: successorsFront)
-						s1 << i->getUniqueName() << " ";
-					REPORT(DEBUG, "schedule(): current wavefront is " << s1.str());
-					for(auto i: alreadyScheduled)
-						s2 << i->getUniqueName() << " ";
-					REPORT(DEBUG, "schedule(): currently scheduled: " << s2.str());
+			// The seeds got a scheduled predecessor since they were counted, or were never counted: count them again
+			for(auto s: seeds) {
+				visited++;
+				if(s->hasBeenScheduled())
+					continue;
+				int pending = countUnscheduledPredecessors(s);
+				s->setUnscheduledPredecessors(pending);
+				if(pending==0)
+					readyQueue.push_back(s);
+			}
+
+			// The main loop only looks at signals whose counter dropped to zero
+			while(!readyQueue.empty()) {
+				Signal* candidate = readyQueue.front();
+				readyQueue.pop_front();
+				visited++;
+				if(candidate->hasBeenScheduled())
+					continue; // it may have been pushed several times
+
+				// Can we really schedule this candidate? Dependencies may have been added since it was counted
+				int pending = countUnscheduledPredecessors(candidate);
+				if(pending > 0) {
+					REPORT(DEBUG, "schedule():   " << candidate->getUniqueName() << " cannot be scheduled yet, waiting for " << pending << " predecessor(s)");
+					candidate->setUnscheduledPredecessors(pending);
+					continue;
 				}
 
-				for(auto candidate: successorsFront) {
-					// Can we schedule this candidate?
-					//check if all the signal's predecessors have been scheduled
-					bool allPredecessorsScheduled = true;
-					for(auto i : *candidate->predecessors()) {
-						Signal* pred=i.first;
-						if(pred->hasBeenScheduled() == false) {
-							REPORT(DEBUG, "schedule():   " << candidate->getUniqueName() << " cannot be scheduled because of predecessor " << pred->getUniqueName());
-							allPredecessorsScheduled = false;
-						}
-					}
-					if(allPredecessorsScheduled) {
-						setSignalTiming(candidate); // also marks it as scheduled
-						alreadyScheduled.insert(candidate);
-						REPORT(DEBUG, "schedule(): :) " << candidate->getUniqueName()
-									 << " has been scheduled at lexicographic time (" << candidate->getCycle() << ", " << candidate->getCriticalPath() <<")"  );
-
-						nextIterationFront.erase(candidate);// it may have been already added to nextIterationFront in this iteration
-
-						for(auto i : *candidate->successors()) {
-							if(i.first->hasBeenScheduled() == false) {
-								REPORT(DEBUG, "schedule():     " << i.first->getUniqueName() << " added to the wavefront");
-								nextIterationFront.insert(i.first);
-							}
-						}
-					}
-					else { // not all the predecessors scheduled, keep this signal for next iteration
-						nextIterationFront.insert(candidate);
-					}
-				}
-				// copy the new wavefront
-				successorsFront = nextIterationFront;
+				setSignalTiming(candidate); // also marks it as scheduled
+				numberScheduled++;
+				REPORT(DEBUG, "schedule(): :) " << candidate->getUniqueName()
+							 << " has been scheduled at lexicographic time (" << candidate->getCycle() << ", " << candidate->getCriticalPath() <<")"  );
+				releaseSuccessors(candidate, readyQueue);
 			} // end main while loop
 
+			if(UserInterface::profileSchedule) {
+				cerr << "> schedule() profile: root " << getName() << ": " << newSignals.size() << " new signals, "
+						 << visited << " nodes visited, " << numberScheduled << " signals scheduled" << endl;
+			}
+
 			set<string> unscheduledOutputs;
 			for(auto i: ioList_)	{
 				if (i->type()==Signal::out) {
@@ -2896,10 +2729,17 @@ namespace flopoco{
 					s << ctabs.str() << tab << "Pipeline depth = " << getPipelineDepth() << endl;
 				else
 					s << ctabs.str() << tab << "Not pipelined"<< endl;
+				for(auto line: finalReportLines_)
+					s << ctabs.str() << tab << line << endl;
 			}
 	}
 
 
+	void Operator::addToFinalReport(string line) {
+		finalReportLines_.push_back(line);
+	}
+
+
 
 
 
@@ -3177,7 +3017,9 @@ namespace flopoco{
 			op->setNameWithFreqAndUID(getName());//accordingly set the name of the implementation
 
 			signalList_ = op->signalList_;
+			signalsSeenByScheduler_ = op->signalsSeenByScheduler_;
 			subComponentList_ = op->subComponentList_;
+			indexSubComponents();
 			ioList_ = op->ioList_;
 		}
 	}
@@ -3284,17 +3126,23 @@ namespace flopoco{
 		uniqueName_                 = op->getUniqueName();
 		architectureName_           = op->getArchitectureName();
 		testCaseSignals_            = op->getTestCaseSignals();
-		vhdl.vhdlCode.str(op->vhdl.vhdlCode.str());
+		// the code is replaced, not appended to: the spans of lexedNames are positions in the code of op
+		vhdl.vhdlCode.str("");
+		vhdl.vhdlCode << op->vhdl.vhdlCode.str(); // written rather than set by str(), so that the code goes on after it
 		vhdl.vhdlCodeBuffer.str(op->vhdl.vhdlCodeBuffer.str());
 
 		vhdl.dependenceTable        = op->vhdl.dependenceTable;
+		vhdl.lexedNames             = op->vhdl.lexedNames;
+		vhdl.lexStatementCount      = op->vhdl.lexStatementCount;
 
 		srcFileName                 = op->getSrcFileName();
 		cost                        = op->getOperatorCost();
 		subComponentList_           = op->getSubComponentList();
+		subComponentMap_            = op->subComponentMap_;
 		stdLibType_                 = op->getStdLibType();
 		isSequential_               = op->isSequential();
 		pipelineDepth_              = op->getPipelineDepth();
+		finalReportLines_           = op->finalReportLines_;
 		signalMap_                  = op->getSignalMap();
 		constants_                  = op->getConstants();
 		attributes_                 = op->getAttributes();
@@ -3308,6 +3156,8 @@ namespace flopoco{
 		indirectOperator_           = op->getIndirectOperator();
 		hasDelay1Feedbacks_         = op->hasDelay1Feedbacks();
 
+		signalsSeenByScheduler_     = op->signalsSeenByScheduler_;
+
 		isOperatorImplemented_      = op->isOperatorImplemented();
 		isTopLevelDotDrawn_ = op->isOperatorDrawn();
 
@@ -3354,6 +3204,8 @@ namespace flopoco{
 			}
 		signalList_.clear();
 		signalList_.insert(signalList_.begin(), newSignalList.begin(), newSignalList.end());
+		signalsSeenByScheduler_ = 0; // these are new Signal objects
+		schedulerSeeds_.clear();
 
 		//create deep copies of the inputs/outputs
 		vector<Signal*> newIOList;
@@ -3397,6 +3249,7 @@ namespace flopoco{
 			}
 		subComponentList_.clear();
 		subComponentList_ = newOpList;
+		indexSubComponents();
 
 		//recreate the signal dependences, for each of the signals
 		for(unsigned int i=0; i<signalList_.size(); i++)
@@ -3544,6 +3397,7 @@ namespace flopoco{
 		subComponentList_.clear();
 		for(unsigned int i=0; i<subComponentList_.size(); i++)
 			subComponentList_.push_back(subComponentList_[i]);
+		indexSubComponents();
 
 	}
 
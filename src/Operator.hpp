@@ -8,7 +8,9 @@
 #include <vector>
 #include <set>
 #include <map>
+#include <unordered_map>
 #include <memory>
+#include <atomic>
 #include <gmpxx.h>
 #include <float.h>
 #include <utility>
@@ -78,7 +80,7 @@ namespace flopoco {
 
 
 
-		static int uid;                  /**< The counter holding a unique id */
+		static std::atomic<int> uid;     /**< The counter holding a unique id, shared by the operators generated in parallel threads */
 
 	public:
 
@@ -116,6 +118,12 @@ namespace flopoco {
 		/** Retrieve a sub-operator by its name, NULL if not found */
 		OperatorPtr getSubComponent(string name);
 
+		/** Rebuild the index by name of the sub-operators, after subComponentList_ has been replaced or cleared */
+		void indexSubComponents();
+
+		/** Update the index by name of the sub-operators after op, formerly named oldName, has been renamed */
+		void renameSubComponent(Operator* op, string oldName);
+
 
 		/**
 		 * Add this operator to the global (first-level) list, which is stored in its Target (not really its place, sorry).
@@ -756,6 +764,29 @@ namespace flopoco {
 		 */
 		virtual void emulate(TestCase * tc);
 
+		/**
+		 * Fast path for emulate(), on native integers instead of mpz_class and MPFR.
+		 * It must compute exactly the same outputs as emulate(), which TestBench checks on a sample of inputs.
+		 * It must also be re-entrant, so that the test vectors may be generated on several threads.
+		 * Only called if hasEmulateFast() returns true.
+		 * @param tc the test case, filled with the input values, to be filled with the output values.
+		 * @see IntAdder for an example implementation
+		 */
+		virtual void emulateFast(FastTestCase * tc);
+
+		/**
+		 * Tells if emulateFast() is implemented for this operator with its current parameters
+		 * (typically, if its inputs and outputs are narrow enough).
+		 */
+		virtual bool hasEmulateFast();
+
+		/**
+		 * Completes a test case with the expected outputs, using emulateFast() if possible and emulate() otherwise.
+		 * buildRandomTestCase() should use it instead of emulate().
+		 * @param tc the test case, filled with the input values, to be filled with the output values.
+		 */
+		void emulateTestCase(TestCase * tc);
+
 		/**
 		 * Append standard test cases to a test case list. Standard test
 		 * cases are operator-dependent and should include any specific
@@ -772,6 +803,7 @@ namespace flopoco {
 		 * generator. For instance, in FPAdd, the random number generator
 		 * should be biased to favor exponents which are relatively close
 		 * so that an effective addition takes place.
+		 * The outputs should be computed by emulateTestCase().
 		 * This function create a new TestCase (to be free after use)
 		 * See FPExp.cpp for an example of overloading this method.
 		 * @param i the identifier of the test case to be generated
@@ -779,6 +811,13 @@ namespace flopoco {
 		 */
 		virtual TestCase* buildRandomTestCase(int i);
 
+		/**
+		 * Tells if buildRandomTestCase() and emulate() may be called concurrently from several threads.
+		 * This is false by default, since many emulate() methods use Sollya, which is not re-entrant.
+		 * Overload it to return true if your emulate() only uses GMP and MPFR without touching their global defaults.
+		 * The TestBench then generates the random test vectors in parallel.
+		 */
+		virtual bool isEmulateThreadSafe();
 
 
 
@@ -1061,6 +1100,12 @@ namespace flopoco {
 		 */
 		virtual void outputFinalReport(ostream& s, int level);	
 
+		/**
+		 * Adds a line to the final report of this operator, printed after its pipeline depth
+		 * @param line the line, without the end of line
+		 */
+		void addToFinalReport(string line);
+
 
 		/**
 		 * Returns the pipeline depth of this operator
@@ -1098,7 +1143,7 @@ namespace flopoco {
 
 		int getOperatorCost();
 
-		map<string, Signal*> getSignalMap();
+		unordered_map<string, Signal*> getSignalMap();
 
 		map<string, pair<string, string> > getConstants();
 
@@ -1163,14 +1208,28 @@ namespace flopoco {
 		 */
 		void moveDependenciesToSignalGraph();
 
-		/* auxillary recursive function */
-		void buildAlreadyScheduledList(set<Signal*> & alreadyScheduled);
+		/**
+		 * Auxiliary recursive function of schedule():
+		 * appends to newSignals the signals of this operator and its subcomponents that the scheduler has not seen yet.
+		 * Signals without predecessors are marked as scheduled on the way (constants, functional register outputs, etc).
+		 * Also moves the scheduler seeds of these operators to seeds.
+		 */
+		void collectNewSignalsToSchedule(vector<Signal*> & newSignals, vector<Signal*> & seeds);
 
 		/**
 		 * Performs as much as possible of an ASAP scheduling for the root operator of this operator.
+		 * The scheduling is incremental: each call only visits the signals that are new since the previous call,
+		 * and the successors of the signals it manages to schedule.
 		 */
 		void schedule();
 
+		/**
+		 * Records a successor of a signal of this operator that was marked as scheduled outside schedule(),
+		 * or a new successor of a signal already scheduled: the next call to schedule() will count its predecessors again.
+		 * Called by Signal::setHasBeenScheduled() and Signal::addSuccessor().
+		 */
+		void addSchedulerSeed(Signal* s);
+
 		/**
 		 * Set the timing of a signal.
 		 * Used also to share code between the different timing methods.
@@ -1709,6 +1768,7 @@ namespace flopoco {
 	////////////BEWARE: don't add anything below without adding it to cloneOperator, too
 	// TODO Most of these should be protected
 		vector<Operator*>      subComponentList_;				/**< The list of instantiated sub-components */
+		unordered_map<string, Operator*> subComponentMap_;		/**< The same sub-components, indexed by name. Kept up to date wherever the list is modified, and when a sub-component is renamed */
 		vector<Signal*>        signalList_;      				/**< The list of internal signals of the operator */
 		vector<Signal*>        ioList_;                 /**< The list of I/O signals of the operator */
 		set<string> allSignalsLowercased;        /**< a list of all lowercased signals, used for sanity checks */
@@ -1738,9 +1798,10 @@ private:
 	int                    stdLibType_;                     /**< 0 will use the Synopsys ieee.std_logic_unsigned, -1 uses std_logic_signed, 1 uses ieee numeric_std  (preferred) */
 	bool                   isSequential_;                   /**< True if the operator needs a clock signal */
 	int                    pipelineDepth_;                  /**< The pipeline depth of the operator. 0 for combinatorial circuits. A non-pipelined signal can still be sequential, e.g. a FIR. */
-	map<string, Signal*>   signalMap_;                      /**< A dictionary of signals, for recovering a signal based on it's name */
+	vector<string>         finalReportLines_;               /**< Additional lines for the final report, e.g. the registers of the bit heaps */
+	unordered_map<string, Signal*> signalMap_;              /**< A dictionary of signals, for recovering a signal based on it's name */
 	map<string, OperatorPtr> instanceOp_ ;                  /**< A map to get instance info   */
-	map<string, vector<string>> instanceActualIO_ ;         /**< A map to get instance info. This list is in the same order as the ioList of the subcomponent   */
+	unordered_map<string, vector<string>> instanceActualIO_; /**< A map to get instance info. This list is in the same order as the ioList of the subcomponent   */
 	map<string, pair<string, string>> constants_;           /**< The list of constants of the operator: name, <type, value> */
 	map<string, string>    attributes_;                     /**< The list of attribute declarations (name, type) */
 	map<pair<string,string>, string >  attributesValues_;   /**< attribute values <attribute name, object (component, signal, etc)> ,  value> */
@@ -1764,7 +1825,9 @@ private:
 
 	vector<triplet<string, string, int>> unresolvedDependenceTable;   /**< The list of dependence relations which contain on either the lhs or rhs an (still) unknown name */
 	std::ostringstream     dotDiagram;                          /**< The internal stream to which the drawing methods will output */
-	set<Signal*> alreadyScheduled;                          /**< only used by a top-level operator: the set of signals that are already scheduled. */
+	size_t                 signalsSeenByScheduler_;         /**< Number of signals of signalList_ already collected by schedule(), which only visits the new ones */
+	vector<Signal*>        schedulerSeeds_;                 /**< Signals whose predecessors have to be counted again by the next schedule(), see addSchedulerSeed() */
+	static thread_local bool schedulerRunning_;             /**< True inside schedule(), which releases itself the successors of the signals it schedules */
 
 	map<string, string>  tmpInPortMap_;                    /**< Input port map for the instance of this operator currently being built. Temporary variable, that will be pushed into portMaps_. Strings are used to allow to connect with ranges of a signal like, e.g., A => B(7) */
 	map<string, string>  tmpOutPortMap_;                   /**< Output port map for the instance of this operator currently being built. Temporary variable, that will be pushed into portMaps_ Strings are used to allow to connect with ranges of a signal like, e.g., A => B(7) */
@@ -0,0 +1,264 @@
+/*
+  A persistent cache of the operators built by FloPoCo, shared by successive runs.
+
+  This file is part of the FloPoCo project
+
+  Initial software.
+  Copyright © INSA-Lyon, INRIA, CNRS, UCBL,
+  2024.
+  All rights reserved.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <map>
+#include <thread>
+#include <cstdio>
+#include <cstdint>
+#include <cctype>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "OperatorCache.hpp"
+#include "UserInterface.hpp"
+
+#ifndef FLOPOCO_VERSION
+#define FLOPOCO_VERSION "unknown"
+#endif
+
+namespace flopoco{
+
+	// The first line of an entry: change it when the format of the entries changes
+	static const string entryHeader = "FloPoCo operator cache entry, format 1";
+
+
+
+	string OperatorCache::keyDescription(vector<string> opParams, vector<string> options, Target* target) {
+		ostringstream s;
+		s << "flopoco " << FLOPOCO_VERSION << " " << executableStamp() << endl;
+		s << "target " << target->getID() << " " << setprecision(17) << target->frequencyMHz() << endl;
+		for(auto o: options)
+			s << o << endl;
+		// The operator name and parameter names are case-insensitive, and the parameters may come in any order
+		string opName = opParams[0];
+		std::transform(opName.begin(), opName.end(), opName.begin(), ::tolower);
+		vector<string> params;
+		for(size_t i=1; i<opParams.size(); i++) {
+			size_t eqPos = opParams[i].find('=');
+			string key = opParams[i].substr(0, eqPos);
+			std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+			params.push_back(key + (eqPos==string::npos ? "" : opParams[i].substr(eqPos)));
+		}
+		sort(params.begin(), params.end());
+		s << opName;
+		for(auto p: params)
+			s << " " << p;
+		return s.str();
+	}
+
+
+
+	string OperatorCache::keyHash(string description) {
+		uint64_t h = 0xcbf29ce484222325ULL;
+		for(unsigned char c: description) {
+			h ^= c;
+			h *= 0x100000001b3ULL;
+		}
+		ostringstream s;
+		s << hex << setw(16) << setfill('0') << h;
+		return s.str();
+	}
+
+
+
+	string OperatorCache::executableStamp() {
+#ifdef __linux__
+		struct stat st;
+		if(stat("/proc/self/exe", &st) == 0) {
+			ostringstream s;
+			s << st.st_size << "_" << st.st_mtime;
+			return s.str();
+		}
+#endif
+		return "";
+	}
+
+
+
+	OperatorPtr OperatorCache::lookup(string dir, string description, Target* target) {
+		ifstream file(dir + "/" + keyHash(description) + ".entry");
+		if(!file.is_open())
+			return nullptr;
+
+		// Any inconsistency is a miss: the entry will be overwritten by the new one
+		string line, word;
+		if(!getline(file, line) || line != entryHeader)
+			return nullptr;
+		int descriptionLines=0;
+		if(!getline(file, line) || !(istringstream(line) >> word >> descriptionLines) || word != "key")
+			return nullptr;
+		ostringstream storedDescription;
+		for(int i=0; i<descriptionLines; i++) {
+			if(!getline(file, line))
+				return nullptr;
+			storedDescription << (i==0 ? "" : "\n") << line;
+		}
+		if(storedDescription.str() != description) // a hash collision
+			return nullptr;
+
+		string name;
+		int sequential, pipelineDepth, ioCount;
+		if(!(file >> word >> name) || word != "name"
+			 || !(file >> word >> sequential) || word != "sequential"
+			 || !(file >> word >> pipelineDepth) || word != "pipelineDepth"
+			 || !(file >> word >> ioCount) || word != "io")
+			return nullptr;
+
+		struct IO {
+			string direction, name, kind;
+			int width, isBus, wE, wF, possibleValues, cycle;
+			double criticalPath;
+		};
+		vector<IO> ios(ioCount);
+		for(auto& io: ios) {
+			if(!(file >> io.direction >> io.name >> io.width >> io.isBus >> io.kind >> io.wE >> io.wF >> io.possibleValues >> io.cycle >> io.criticalPath))
+				return nullptr;
+		}
+		getline(file, line); // end of the last IO line
+		if(!getline(file, line) || line != "vhdl")
+			return nullptr;
+		ostringstream vhdl;
+		vhdl << file.rdbuf();
+
+		CachedOperator* op = new CachedOperator(target, name, vhdl.str());
+		if(sequential)
+			op->setSequential();
+		else
+			op->setCombinatorial();
+		for(int i=0; i<ioCount; i++) {
+			IO& io = ios[i];
+			if(io.direction == "in") {
+				if(io.kind == "fp")
+					op->addFPInput(io.name, io.wE, io.wF);
+				else if(io.kind == "ieee")
+					op->addIEEEInput(io.name, io.wE, io.wF);
+				else
+					op->addInput(io.name, io.width, io.isBus);
+			}
+			else {
+				if(io.kind == "fp")
+					op->addFPOutput(io.name, io.wE, io.wF, io.possibleValues);
+				else if(io.kind == "ieee")
+					op->addIEEEOutput(io.name, io.wE, io.wF, io.possibleValues);
+				else
+					op->addOutput(io.name, io.width, io.possibleValues, io.isBus);
+			}
+			Signal* s = op->getIOListSignal(i);
+			s->setCycle(io.cycle);
+			s->setCriticalPath(io.criticalPath);
+			s->setHasBeenScheduled(true);
+		}
+		op->computePipelineDepths();
+		if(op->getPipelineDepth() != pipelineDepth)
+			return nullptr;
+		return op;
+	}
+
+
+
+	/* Collects the names of the operators of ops and of all their subcomponents */
+	static void collectNames(vector<OperatorPtr>& ops, vector<string>& names) {
+		for(auto op: ops) {
+			names.push_back(op->getName());
+			collectNames(op->getSubComponentListR(), names);
+		}
+	}
+
+
+
+	void OperatorCache::store(string dir, string description, vector<OperatorPtr> ops, bool keepTopName) {
+		OperatorPtr op = ops.back();
+		string hash = keyHash(description);
+
+		// The VHDL of all the entities, with their names suffixed by the hash
+		ostringstream vhdlStream;
+		set<string> alreadyOutput;
+		UserInterface::outputVHDLToFile(ops, vhdlStream, alreadyOutput);
+		string vhdl = vhdlStream.str();
+
+		vector<string> names;
+		collectNames(ops, names);
+		map<string, string> newNames;
+		for(auto n: names)
+			newNames[n] = n + "_" + hash.substr(0,8);
+		if(keepTopName)
+			newNames.erase(op->getName());
+		string topName = (keepTopName ? op->getName() : newNames[op->getName()]);
+
+		// Rename the identifiers in one pass
+		string renamed;
+		renamed.reserve(vhdl.size() + vhdl.size()/8);
+		size_t i=0;
+		while(i < vhdl.size()) {
+			if(isalnum((unsigned char)vhdl[i]) || vhdl[i]=='_') {
+				size_t j=i;
+				while(j < vhdl.size() && (isalnum((unsigned char)vhdl[j]) || vhdl[j]=='_'))
+					j++;
+				string id = vhdl.substr(i, j-i);
+				auto it = newNames.find(id);
+				renamed += (it == newNames.end() ? id : it->second);
+				i=j;
+			}
+			else
+				renamed += vhdl[i++];
+		}
+
+		ostringstream entry;
+		entry << entryHeader << endl;
+		entry << "key " << count(description.begin(), description.end(), '\n') + 1 << endl;
+		entry << description << endl;
+		entry << "name " << topName << endl;
+		entry << "sequential " << (op->isSequential() ? 1 : 0) << endl;
+		entry << "pipelineDepth " << op->getPipelineDepth() << endl;
+		entry << "io " << op->getIOListSize() << endl;
+		for(auto s: *op->getIOList()) {
+			entry << (s->type() == Signal::in ? "in " : "out ") << s->getName() << " " << s->width() << " " << (s->isBus() ? 1 : 0) << " "
+						<< (s->isIEEE() ? "ieee" : (s->isFP() ? "fp" : "plain")) << " " << s->wE() << " " << s->wF() << " "
+						<< (s->type() == Signal::in ? 1 : s->getNumberOfPossibleValues()) << " "
+						<< s->getCycle() << " " << setprecision(17) << s->getCriticalPath() << endl;
+		}
+		entry << "vhdl" << endl;
+		entry << renamed;
+
+		// Write to a file private to this thread, then rename it atomically
+		mkdir(dir.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+		ostringstream tmpName;
+		tmpName << dir << "/" << hash << "." << getpid() << "." << std::hash<std::thread::id>()(std::this_thread::get_id()) << ".tmp";
+		ofstream file(tmpName.str());
+		file << entry.str();
+		file.close();
+		if(!file || rename(tmpName.str().c_str(), (dir + "/" + hash + ".entry").c_str()) != 0) {
+			remove(tmpName.str().c_str());
+			if(UserInterface::verbose >= INFO)
+				cerr << "> OperatorCache: could not write the entry of " << op->getName() << " in " << dir << endl;
+		}
+	}
+
+
+
+	CachedOperator::CachedOperator(Target* target, string name, string vhdl):
+		Operator(nullptr, target), cachedVHDL_(vhdl)
+	{
+		srcFileName="CachedOperator";
+		setName(name);
+		setNoParseNoSchedule();
+	}
+
+
+	void CachedOperator::outputVHDL(std::ostream& o, std::string name) {
+		o << cachedVHDL_;
+	}
+
+}
@@ -0,0 +1,85 @@
+#ifndef OPERATORCACHE_HPP
+#define OPERATORCACHE_HPP
+
+#include "Operator.hpp"
+
+/**
+ * A persistent, content-addressed cache of the operators built from the command line.
+ * It is enabled by the cacheDir generic option, and shared by all the flopoco runs that use the same directory.
+ *
+ * An entry is keyed by a hash of everything the generation depends on: the factory name, the canonical parameters,
+ * the target, the frequency, the generic options, and the FloPoCo version.
+ * It holds the VHDL of the operator and of all the entities it instantiates,
+ * its pipeline depth, and its IO signature with the timing computed by the scheduler.
+ * On a hit, the construction (Sollya, ILP tiling, bit-heap compression, etc.) is skipped altogether:
+ * the operator is replaced by a CachedOperator that outputs this VHDL.
+ **/
+
+namespace flopoco{
+
+	class OperatorCache
+	{
+	public:
+		/**
+		 * The description of an operator from which the cache key is computed.
+		 * @param[in] opParams the operator name followed by its parameters, the generic options already removed
+		 * @param[in] options the generic options that influence the generation, as name=value strings
+		 * @param[in] target the target of the operator
+		 * @return a string that is the same for two generations that produce the same VHDL
+		 **/
+		static string keyDescription(vector<string> opParams, vector<string> options, Target* target);
+
+		/**
+		 * Looks up an operator in the cache.
+		 * @param[in] dir the cache directory
+		 * @param[in] description the key description, see keyDescription()
+		 * @param[in] target the target of the operator
+		 * @return a CachedOperator, or nullptr on a miss (or if the entry is unreadable)
+		 **/
+		static OperatorPtr lookup(string dir, string description, Target* target);
+
+		/**
+		 * Stores an operator in the cache.
+		 * The entry is written to a temporary file, then renamed, so that concurrent runs never read a partial entry.
+		 * The entities are renamed with a suffix derived from the key, so that a cached operator may be mixed
+		 * with operators built in another run without name clashes.
+		 * @param[in] dir the cache directory, created if needed
+		 * @param[in] description the key description, see keyDescription()
+		 * @param[in] ops the top-level operators built for this entry (the operator itself last, preceded by the shared operators it added to globalOpList)
+		 * @param[in] keepTopName if true, the top-level entity is not renamed (it was named by the user)
+		 **/
+		static void store(string dir, string description, vector<OperatorPtr> ops, bool keepTopName);
+
+		/** The 64-bit FNV-1a hash of the description, in hexadecimal: the file name of the entry (also used by TilingCache) */
+		static string keyHash(string description);
+
+		/** A stamp of the flopoco executable, so that a rebuild invalidates the cache even if the version is unchanged */
+		static string executableStamp();
+	};
+
+
+
+	/**
+	 * An operator retrieved from the OperatorCache.
+	 * It has the IOs and the timing of the original operator, and outputs its VHDL (including all the entities it instantiates)
+	 * but it has no signals and no subcomponents of its own.
+	 **/
+	class CachedOperator : public Operator
+	{
+	public:
+		/**
+		 * The CachedOperator constructor
+		 * @param[in] target the target device
+		 * @param[in] name the name of the top-level entity in vhdl
+		 * @param[in] vhdl the VHDL of the operator and of all the entities it instantiates
+		 **/
+		CachedOperator(Target* target, string name, string vhdl);
+
+		/** Outputs the cached VHDL */
+		void outputVHDL(std::ostream& o, std::string name);
+
+	private:
+		string cachedVHDL_; /**< The VHDL of the original operator and of all the entities it instantiates */
+	};
+}
+#endif
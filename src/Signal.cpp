@@ -379,6 +379,10 @@ namespace flopoco{
 		//safe to insert a new signal in the predecessor list
 		pair<Signal*, int> newSuccessorPair = make_pair(successor, delayCycles);
 		successors_.push_back(newSuccessorPair);
+
+		//the scheduler will not visit this signal again: tell it that the successor has one more scheduled predecessor
+		if(hasBeenScheduled_ && parentOp_ != nullptr)
+			parentOp_->addSchedulerSeed(successor);
 	}
 
 	void Signal::addSuccessors(vector<pair<Signal*, int>> successorList)
@@ -555,10 +559,23 @@ namespace flopoco{
 	}
 
 	void Signal::setHasBeenScheduled(bool newVal){
+		if(newVal && !hasBeenScheduled_ && parentOp_ != nullptr) {
+			for(auto i: successors_)
+				parentOp_->addSchedulerSeed(i.first); // ignored within schedule(), which releases them itself
+		}
 		hasBeenScheduled_ = newVal;
 	}
 
 
+	int Signal::getUnscheduledPredecessors(){
+		return unscheduledPredecessors_;
+	}
+
+	void Signal::setUnscheduledPredecessors(int n){
+		unscheduledPredecessors_ = n;
+	}
+
+
 	bool Signal::unscheduleSignal(){
 		bool allPredecessorsConstant = true;
 
@@ -490,6 +490,18 @@ class Operator;
 		 */
 		void setHasBeenScheduled(bool newVal);
 
+		/**
+		 * Return the number of predecessors the scheduler is still waiting for.
+		 * This counter is only a hint maintained by Operator::schedule():
+		 * the scheduler rechecks the actual predecessors when it drops to zero.
+		 */
+		int getUnscheduledPredecessors();
+
+		/**
+		 * Set the number of predecessors the scheduler is still waiting for
+		 */
+		void setUnscheduledPredecessors(int n);
+
 		/**
 		 * Mark the signal as un-scheduled, if necessary
 		 * @return the new value of hasBeenScheduled
@@ -564,6 +576,7 @@ class Operator;
 		bool          incompleteDeclaration_;          /**< signals generated by outPortMap are first incompletely declared, then  completed later on in the constructor */
 
 		bool          hasBeenScheduled_;               /**< Has the signal already been scheduled? */
+		int           unscheduledPredecessors_ = 0;    /**< Pending-predecessor counter of the incremental scheduler, see Operator::schedule() */
 		bool          hasBeenDrawn_;                   /**< Has the signal already been drawn? */
 
 		bool          isFP_;                           /**< If the signal is of the FloPoCo floating-point type */
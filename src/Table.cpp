@@ -17,8 +17,10 @@
 #include <iostream>
 #include <sstream>
 #include <cstdlib>
+#include <algorithm>
 #include "utils.hpp"
 #include "Table.hpp"
+#include "TableCompression.hpp"
 
 using namespace std;
 
@@ -171,42 +173,138 @@ namespace flopoco{
 		}
 
 		cpDelay = getTarget()->tableDelay(wIn, wOut, logicTable);
-		vhdl << tab << "with X select " << declare(cpDelay, "Y0", wOut) << " <= " << endl;;
-		
-		for(unsigned int i=minIn.get_ui(); i<=maxIn.get_ui(); i++)
-			vhdl << tab << tab << "\"" << unsignedBinary(values[i-minIn.get_ui()], wOut) << "\" when \"" << unsignedBinary(i, wIn) << "\"," << endl;
-		vhdl << tab << tab << "\"";
-		for(int i=0; i<wOut; i++)
-			vhdl << "-";
-		vhdl <<  "\" when others;" << endl;
 
-		// TODO there seems to be several possibilities to make a BRAM; the following seems ineffective
+		// A full logic table may be decomposed into smaller ones. The signals built by a with-select get the attributes below.
+		vector<string> tabulatedSignals;
+		bool decomposed = false;
+		if(logicTable && full && wOut <= 64 && getTarget()->useTableCompression()) {
+			vector<uint64_t> v(values.size(), 0);
+			for(size_t i=0; i<values.size(); i++)
+				mpz_export(&v[i], nullptr, -1, sizeof(uint64_t), 0, 0, values[i].get_mpz_t());
+			TableCompression c(getTarget(), v, wIn, wOut);
+			if(c.kind != TableCompression::plain) {
+				REPORT(DETAILED, (c.kind == TableCompression::split ? "Split" : "Differential") << " decomposition of the table, s=" << c.s
+							 << ": " << c.wHigh << " bits indexed by " << wIn-c.s << " bits at weight " << c.highLSB << ", " << c.wLow << " bits indexed by " << wIn
+							 << " bits, cost " << c.cost << " LUTs instead of " << c.plainCost);
+				decomposed = true;
+				vhdl << tab << declare("XH", wIn-c.s) << " <= X" << range(wIn-1, c.s) << ";" << endl;
+				string t = emitTable("XH", wIn-c.s, "TH", c.high, c.wHigh);
+				if(t != "")
+					tabulatedSignals.push_back(t);
+				if(c.wLow > 0) {
+					t = emitTable("X", wIn, "TL", c.low, c.wLow);
+					if(t != "")
+						tabulatedSignals.push_back(t);
+				}
+				if(c.kind == TableCompression::split) {
+					vhdl << tab << declare("Y0", wOut) << " <= TH" << (c.wLow > 0 ? " & TL" : "") << ";" << endl;
+				}
+				else {
+					vhdl << tab << declare("TDH", wOut) << " <= TH" << (c.highLSB > 0 ? " & " + zg(c.highLSB) : "") << ";" << endl;
+					if(c.wLow > 0) {
+						vhdl << tab << declare("TDL", wOut) << " <= " << (c.wLow < wOut ? zg(wOut-c.wLow) + " & " : "") << "TL;" << endl;
+						// with std_logic_arith, the unsigned + would be ambiguous; the std_logic_vector + of std_logic_(un)signed is modular anyway
+						vhdl << tab << declare(getTarget()->adderDelay(wOut-c.highLSB), "Y0", wOut) << " <= "
+								 << (getStdLibType() <= 0 ? "TDH + TDL" : "std_logic_vector(unsigned(TDH) + unsigned(TDL))") << ";" << endl;
+					}
+					else
+						vhdl << tab << declare("Y0", wOut) << " <= TDH;" << endl;
+				}
+			}
+		}
+		if(!decomposed) {
+			vhdl << tab << "with X select " << declare(cpDelay, "Y0", wOut) << " <= " << endl;;
+
+			for(unsigned int i=minIn.get_ui(); i<=maxIn.get_ui(); i++)
+				vhdl << tab << tab << "\"" << unsignedBinary(values[i-minIn.get_ui()], wOut) << "\" when \"" << unsignedBinary(i, wIn) << "\"," << endl;
+			vhdl << tab << tab << "\"";
+			for(int i=0; i<wOut; i++)
+				vhdl << "-";
+			vhdl <<  "\" when others;" << endl;
+			tabulatedSignals.push_back("Y0");
+		}
 
-		std::string tableAttributes;
-		//set the table attributes
-		if(getTarget()->getID() == "Virtex6")
-			tableAttributes =  "attribute ram_extract: string;\nattribute ram_style: string;\nattribute ram_extract of Y0: signal is \"yes\";\nattribute ram_style of Y0: signal is ";
-		else if(getTarget()->getID() == "Virtex5")
-			tableAttributes =  "attribute rom_extract: string;\nattribute rom_style: string;\nattribute rom_extract of Y0: signal is \"yes\";\nattribute rom_style of Y0: signal is ";
-		else
-			tableAttributes =  "attribute ram_extract: string;\nattribute ram_style: string;\nattribute ram_extract of Y0: signal is \"yes\";\nattribute ram_style of Y0: signal is ";
+		// TODO there seems to be several possibilities to make a BRAM; the following seems ineffective
 
+		std::string tableStyle;
 		if((logicTable == 1) || (wIn <= getTarget()->lutInputs())){
 			//logic
 			if(getTarget()->getID() == "Virtex6")
-				tableAttributes += "\"pipe_distributed\";";
+				tableStyle = "\"pipe_distributed\";";
 			else
-				tableAttributes += "\"distributed\";";
+				tableStyle = "\"distributed\";";
 		}else{
 			//block RAM
-			tableAttributes += "\"block\";";
+			tableStyle = "\"block\";";
+		}
+
+		//set the table attributes
+		for(auto t: tabulatedSignals) {
+			std::string tableAttributes;
+			if(getTarget()->getID() == "Virtex6")
+				tableAttributes =  "attribute ram_extract: string;\nattribute ram_style: string;\nattribute ram_extract of " + t + ": signal is \"yes\";\nattribute ram_style of " + t + ": signal is ";
+			else if(getTarget()->getID() == "Virtex5")
+				tableAttributes =  "attribute rom_extract: string;\nattribute rom_style: string;\nattribute rom_extract of " + t + ": signal is \"yes\";\nattribute rom_style of " + t + ": signal is ";
+			else
+				tableAttributes =  "attribute ram_extract: string;\nattribute ram_style: string;\nattribute ram_extract of " + t + ": signal is \"yes\";\nattribute ram_style of " + t + ": signal is ";
+			getSignalByName(t) -> setTableAttributes(tableAttributes + tableStyle);
 		}
-		getSignalByName("Y0") -> setTableAttributes(tableAttributes);
 
 		vhdl << tab << "Y <= Y0;" << endl;
 	}
 
 	
+	string Table::emitTable(string input, int wI, string output, const vector<uint64_t> &v, int wO)
+	{
+		// The output bits that are constant or copies of another one are not tabulated
+		vector<int> columns = TableCompression::sharedColumns(v, wO);
+		vector<int> tabulated;
+		for(int j=0; j<wO; j++)
+			if(columns[j] == j)
+				tabulated.push_back(j);
+		string t = ((int)tabulated.size() < wO ? output + "_t" : output);
+
+		if(!tabulated.empty()) {
+			int wT = tabulated.size();
+			vhdl << tab << "with " << input << " select " << declare(getTarget()->tableDelay(wI, wT, true), t, wT) << " <= " << endl;
+			for(size_t i=0; i<v.size(); i++) {
+				vhdl << tab << tab << "\"";
+				for(int k=wT-1; k>=0; k--)
+					vhdl << ((v[i] >> tabulated[k]) & 1);
+				vhdl << "\" when \"" << unsignedBinary(mpz_class((unsigned long)i), wI) << "\"," << endl;
+			}
+			vhdl << tab << tab << "\"";
+			for(int k=0; k<wT; k++)
+				vhdl << "-";
+			vhdl <<  "\" when others;" << endl;
+		}
+
+		if(t != output) {
+			vhdl << tab << declare(output, wO) << " <= ";
+			if(tabulated.empty()) { // a constant
+				vhdl << "\"";
+				for(int j=wO-1; j>=0; j--)
+					vhdl << (columns[j] == -2 ? "1" : "0");
+				vhdl << "\"";
+			}
+			else {
+				for(int j=wO-1; j>=0; j--) {
+					if(j < wO-1)
+						vhdl << " & ";
+					if(columns[j] == -1)
+						vhdl << "'0'";
+					else if(columns[j] == -2)
+						vhdl << "'1'";
+					else
+						vhdl << t << "(" << find(tabulated.begin(), tabulated.end(), columns[j]) - tabulated.begin() << ")";
+				}
+			}
+			vhdl << ";" << endl;
+		}
+		return (tabulated.empty() ? "" : t);
+	}
+
+
 	Table::Table(OperatorPtr parentOp, Target* target) :
 		Operator(parentOp, target){
 		setCopyrightString("Florent de Dinechin, Bogdan Pasca (2007, 2018)");
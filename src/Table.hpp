@@ -29,6 +29,9 @@
 
 	 A Table is, so far, always combinatorial. It does increase the critical path
 
+	 A full logic Table may be implemented as several smaller tables when it saves LUTs, see TableCompression.
+	 This is controlled by the compressTables generic option.
+
 	 On logic tables versus blockRam tables:
 	 This has unfortunately to be managed twice,
 	   firstly by passing the proper bool value to the logicTable argument of the constructor
@@ -85,6 +88,15 @@ namespace flopoco{
 		/** A function that returns an estimation of the size of the table in LUTs. Your mileage may vary thanks to boolean optimization */
 		int size_in_LUTs();
 	private:
+		/**
+		 * Writes the VHDL of a full logic table, without its constant and copied output bits, see TableCompression
+		 * @param[in] input   the name of the input signal, of wI bits
+		 * @param[in] output  the name of the output signal to declare, of wO bits
+		 * @param[in] v       the 2^wI values
+		 * @return the name of the signal built by the with-select (output, or output_t if it is narrower), empty if output is a constant
+		 */
+		string emitTable(string input, int wI, string output, const vector<uint64_t> &v, int wO);
+
 		bool full; 					/**< true if there is no "don't care" inputs, i.e. minIn=0 and maxIn=2^wIn-1 */
 		bool logicTable; 			/**< true: LUT-based table; false: BRAM-based */
 		double cpDelay;  				/**< For a LUT-based table, its delay; */
@@ -0,0 +1,221 @@
+/*
+  The decomposition of the contents of a Table into smaller tables
+
+  This file is part of the FloPoCo project
+
+  Initial software.
+  Copyright © INSA-Lyon, INRIA, CNRS, UCBL,
+  2024.
+  All rights reserved.
+
+ */
+
+#include <map>
+#include <cmath>
+#include <algorithm>
+
+#include "utils.hpp"
+#include "TableCompression.hpp"
+
+using namespace std;
+
+namespace flopoco{
+
+	// the number of bits of x, 0 for 0
+	static int bitLength(uint64_t x) {
+		int r = 0;
+		while(x != 0) {
+			x >>= 1;
+			r++;
+		}
+		return r;
+	}
+
+
+
+	TableCompression::TableCompression(Target* target, const vector<uint64_t> &values, int wIn, int wOut) :
+		kind(plain), s(0), highLSB(0), wHigh(0), wLow(wOut)
+	{
+		plainCost = tableCost(target, values, wIn, wOut);
+		cost = plainCost;
+		if(wIn < 2 || wOut < 2 || wOut > 64 || values.size() != (uint64_t(1) << wIn))
+			return;
+
+		// First the best decomposition of each kind, estimated without the sharing of output bits
+		Kind kinds[2] = {split, differential};
+		double estimate[2] = {INFINITY, INFINITY};
+		int bestS[2], bestHighLSB[2];
+		uint64_t n = uint64_t(1) << wIn;
+		for(int ss = 1; ss < wIn; ss++) {
+			uint64_t blocks = n >> ss;
+			vector<uint64_t> mins(blocks), maxs(blocks);
+			for(uint64_t b = 0; b < blocks; b++) {
+				mins[b] = maxs[b] = values[b << ss];
+				for(uint64_t i = (b << ss) + 1; i < ((b + 1) << ss); i++) {
+					mins[b] = std::min(mins[b], values[i]);
+					maxs[b] = std::max(maxs[b], values[i]);
+				}
+			}
+
+			// split: all the values of a block share the high bits that are common to their min and max
+			int h = wOut;
+			for(uint64_t b = 0; b < blocks; b++)
+				h = std::min(h, wOut - bitLength(mins[b] ^ maxs[b]));
+			if(h > 0) {
+				double e = h * lutCost(target, wIn - ss) + (wOut - h) * lutCost(target, wIn);
+				if(e < estimate[0]) {
+					estimate[0] = e;
+					bestS[0] = ss;
+					bestHighLSB[0] = wOut - h;
+				}
+			}
+
+			// differential: the l LSBs of the minimum are not stored, which enlarges the differences
+			for(int l = 0; l < wOut; l++) {
+				uint64_t maxDiff = 0;
+				for(uint64_t b = 0; b < blocks; b++)
+					maxDiff = std::max(maxDiff, maxs[b] - ((mins[b] >> l) << l));
+				int wD = bitLength(maxDiff);
+				if(wD >= wOut)
+					continue;
+				double e = (wOut - l) * lutCost(target, wIn - ss) + wD * lutCost(target, wIn) + (wD > l ? wOut - l : 0);
+				if(e < estimate[1]) {
+					estimate[1] = e;
+					bestS[1] = ss;
+					bestHighLSB[1] = l;
+				}
+			}
+		}
+
+		// Then their actual cost
+		Kind bestKind = plain;
+		int bestSS = 0, bestL = 0;
+		for(int k = 0; k < 2; k++) {
+			if(estimate[k] == INFINITY)
+				continue;
+			kind = kinds[k];
+			s = bestS[k];
+			highLSB = bestHighLSB[k];
+			double c = build(target, values, wIn, wOut);
+			if(c < cost) {
+				cost = c;
+				bestKind = kind;
+				bestSS = s;
+				bestL = highLSB;
+			}
+		}
+
+		kind = bestKind;
+		s = bestSS;
+		highLSB = bestL;
+		if(kind == plain) {
+			wHigh = 0;
+			wLow = wOut;
+			high.clear();
+			low.clear();
+		}
+		else
+			build(target, values, wIn, wOut);
+	}
+
+
+
+	double TableCompression::build(Target* target, const vector<uint64_t> &values, int wIn, int wOut)
+	{
+		uint64_t n = uint64_t(1) << wIn;
+		uint64_t blocks = n >> s;
+		uint64_t lowMask = (uint64_t(1) << highLSB) - 1;
+		high.assign(blocks, 0);
+		low.assign(n, 0);
+		wHigh = wOut - highLSB;
+		if(kind == split) {
+			for(uint64_t i = 0; i < n; i++) {
+				high[i >> s] = values[i] >> highLSB;
+				low[i] = values[i] & lowMask;
+			}
+			wLow = highLSB;
+		}
+		else {
+			for(uint64_t b = 0; b < blocks; b++)
+				high[b] = *min_element(values.begin() + (b << s), values.begin() + ((b + 1) << s)) >> highLSB;
+			uint64_t maxLow = 0;
+			for(uint64_t i = 0; i < n; i++) {
+				low[i] = values[i] - (high[i >> s] << highLSB);
+				maxLow = std::max(maxLow, low[i]);
+			}
+			wLow = bitLength(maxLow);
+		}
+
+		double c = tableCost(target, high, wIn - s, wHigh) + tableCost(target, low, wIn, wLow);
+		if(kind == differential && wLow > highLSB)
+			c += wOut - highLSB; // the carry propagation, one LUT per bit
+		return c;
+	}
+
+
+
+	vector<int> TableCompression::sharedColumns(const vector<uint64_t> &values, int wOut)
+	{
+		vector<int> r(wOut);
+		map<vector<uint64_t>, int> columns;
+		uint64_t n = values.size();
+		for(int j = 0; j < wOut; j++) {
+			// the column of bit j, packed
+			vector<uint64_t> column((n + 63) / 64, 0);
+			uint64_t ones = 0;
+			for(uint64_t i = 0; i < n; i++) {
+				uint64_t bit = (values[i] >> j) & 1;
+				column[i / 64] |= bit << (i % 64);
+				ones += bit;
+			}
+			if(ones == 0)
+				r[j] = -1;
+			else if(ones == n)
+				r[j] = -2;
+			else {
+				auto it = columns.find(column);
+				if(it != columns.end())
+					r[j] = it->second;
+				else {
+					columns[column] = j;
+					r[j] = j;
+				}
+			}
+		}
+		return r;
+	}
+
+
+
+	double TableCompression::tableCost(Target* target, const vector<uint64_t> &values, int wIn, int wOut)
+	{
+		if(wOut > 64) // more bits than the values can hold: no sharing
+			return wOut * lutCost(target, wIn);
+		vector<int> columns = sharedColumns(values, wOut);
+		int tabulated = 0;
+		for(int j = 0; j < wOut; j++)
+			if(columns[j] == j)
+				tabulated++;
+		return tabulated * lutCost(target, wIn);
+	}
+
+
+
+	double TableCompression::lutCost(Target* target, int wIn)
+	{
+		if(wIn <= 0)
+			return 0;
+		double c = target->lutConsumption(wIn);
+		if(c < 0) { // a tree of the largest LUTs, selected by the remaining input bits
+			int m = target->maxLutInputs();
+			c = target->lutConsumption(m);
+			if(c < 0) {
+				m = target->lutInputs();
+				c = 1;
+			}
+			c *= intpow2(wIn - m);
+		}
+		return c;
+	}
+
+}
@@ -0,0 +1,83 @@
+/*
+  The decomposition of the contents of a Table into smaller tables
+
+  This file is part of the FloPoCo project
+
+  Initial software.
+  Copyright © INSA-Lyon, INRIA, CNRS, UCBL,
+  2024.
+  All rights reserved.
+
+ */
+
+#ifndef TABLECOMPRESSION_HPP
+#define TABLECOMPRESSION_HPP
+
+#include <vector>
+#include <cstdint>
+
+#include "Target.hpp"
+
+/**
+ The decomposition of a logic table T of 2^wIn values of wOut bits into smaller tables.
+
+	 Two decompositions are explored, for each number s of input LSBs ignored by the high table H:
+	 - split: the h high output bits of T only depend on the input MSBs, so T(x) = H(x>>s) . L(x) where L holds the wOut-h low bits;
+	 - differential: T(x) = H(x>>s).2^l + L(x) where H(x>>s) is the minimum of T on the block of 2^s values, truncated to its wOut-l MSBs,
+	   and L(x) the difference, on fewer bits. This is the TIV compression of Hsiao et al., as in Multipartite, for any table.
+
+	 In any table, the output bits that are constant or copies of another output bit are not tabulated.
+
+	 The decomposition retained is the one of lowest LUT cost according to Target::lutConsumption(),
+	 including the carry-propagation of the differential one. It is lossless: T is rebuilt exactly.
+	 BRAM tables are not decomposed, as their cost is a number of blocks.
+
+	 Table::init() uses it, so all the logic tables, e.g. those of FixFunctionByTable, are compressed when it saves LUTs.
+*/
+
+namespace flopoco{
+
+	class TableCompression
+	{
+	public:
+		typedef enum {plain, split, differential} Kind;
+
+		/**
+		 * Looks for the cheapest decomposition of a table
+		 * @param[in] target  the target device, for the LUT costs
+		 * @param[in] values  the 2^wIn values of the table, of at most 64 bits
+		 * @param[in] wIn     the input width
+		 * @param[in] wOut    the output width
+		 */
+		TableCompression(Target* target, const std::vector<uint64_t> &values, int wIn, int wOut);
+
+		/**
+		 * The columns that have to be tabulated in a table
+		 * @return for each output bit j, j if it has to be tabulated, the previous bit it copies,
+		 * or -1 (resp. -2) if it is constant 0 (resp. 1)
+		 */
+		static std::vector<int> sharedColumns(const std::vector<uint64_t> &values, int wOut);
+
+		/** The LUT cost of a table, without its constant and copied output bits */
+		static double tableCost(Target* target, const std::vector<uint64_t> &values, int wIn, int wOut);
+
+		Kind kind;
+		int s;                        /**< the high table is indexed by the wIn-s input MSBs */
+		int highLSB;                  /**< the weight of the LSB of the high table in the output */
+		int wHigh;                    /**< the output width of the high table */
+		int wLow;                     /**< the output width of the low table */
+		std::vector<uint64_t> high;   /**< the 2^(wIn-s) values of the high table */
+		std::vector<uint64_t> low;    /**< the 2^wIn values of the low table */
+		double cost;                  /**< the LUT cost of the decomposition */
+		double plainCost;             /**< the LUT cost of the table, without its constant and copied output bits */
+
+	private:
+		/** The LUT cost of one output bit of a table with wIn inputs */
+		static double lutCost(Target* target, int wIn);
+
+		/** Fills high and low for the current kind, s and highLSB, and returns the cost */
+		double build(Target* target, const std::vector<uint64_t> &values, int wIn, int wOut);
+	};
+
+}
+#endif
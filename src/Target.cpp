@@ -27,6 +27,8 @@ namespace flopoco{
 
 	Target::Target()   {
 			generateFigures_=false;
+			useCompressorArrays_=false;
+			useTableCompression_=true;
             useTargetOptimizations_=true;
 			lutInputs_         = 4;
 			hasHardMultipliers_= true;
@@ -123,6 +125,22 @@ namespace flopoco{
       generateFigures_ = b;
     }
 
+	bool  Target::useCompressorArrays(){
+		return useCompressorArrays_;
+	}
+
+	void  Target::setUseCompressorArrays(bool b){
+		useCompressorArrays_ = b;
+	}
+
+	bool  Target::useTableCompression(){
+		return useTableCompression_;
+	}
+
+	void  Target::setUseTableCompression(bool b){
+		useTableCompression_ = b;
+	}
+
     bool  Target::useTargetOptimizations()
     {
       return useTargetOptimizations_;
@@ -174,6 +192,16 @@ namespace flopoco{
 		return tiling_;
 	}
 
+	void Target::setCacheDir(string dir)
+	{
+		cacheDir_ = dir;
+	}
+
+	string Target::getCacheDir()
+	{
+		return cacheDir_;
+	}
+
 
 
     bool Target::hasHardMultipliers(){
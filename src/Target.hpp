@@ -143,6 +143,18 @@ namespace flopoco{
 		/** should flopoco generate SVG figures */
 		void setGenerateFigures(bool b);
 
+		/** should the compressors of a bitheap stage that have the same type and timing be generated as arrays */
+		bool useCompressorArrays();
+
+		/** should the compressors of a bitheap stage that have the same type and timing be generated as arrays */
+		void setUseCompressorArrays(bool b);
+
+		/** should the logic tables be decomposed into smaller tables when it saves LUTs, see TableCompression */
+		bool useTableCompression();
+
+		/** should the logic tables be decomposed into smaller tables when it saves LUTs, see TableCompression */
+		void setUseTableCompression(bool b);
+
 		/** should target specific optimizations be performed */
 		bool  useTargetOptimizations();
 
@@ -173,6 +185,12 @@ namespace flopoco{
 		/** sets the compression method used for multiplier tiling */
 		void  setTilingMethod(string method);
 
+		/** sets the directory of the persistent caches (OperatorCache, TilingCache), empty for none */
+		void setCacheDir(string dir);
+
+		/** returns the directory of the persistent caches, empty if there is none */
+		string getCacheDir();
+
 		/** On LUT-based FPGAs, number of inputs of the basic architectural LUT.
 		  * Look-up tables with lutInput() input bits can be used independently
 		  * without constraint. When the architecture of a logic bloc allows to
@@ -759,12 +777,15 @@ namespace flopoco{
 																		1 means: any sub-multiplier, even very small ones, go to DSP*/
 		bool   plainVHDL_;     /**< True if we want the VHDL code to be concise and readable, with + and * instead of optimized FloPoCo operators. */
 		bool   generateFigures_;  /**< If true, some operators may generate some figures in SVG format */
+		bool   useCompressorArrays_; /**< If true, the compressors of a bitheap are generated as CompressorArray instances when possible */
+		bool   useTableCompression_; /**< If true, the logic tables are decomposed into smaller tables when it saves LUTs */
         bool   useTargetOptimizations_; /**< If true, target specific optimizations using primitives are performed. Vendor specific libraries are necessary for simulation. */
 
 		string compression_; /**< Defines the BitHeap compression method*/
 		string tiling_; /**< Defines the multiplier tiling method*/
 		string ilpSolverName_; /*** Defines the ILP solver for operators optimized by ILP. It has to match a solver name known by the ScaLP library */
 		int ilpTimeout_; /*** Defines the timeout in seconds for the ILP solver for operators optimized by ILP.*/
+		string cacheDir_; /**< The directory of the persistent caches, empty for none */
 	};
 
 }
@@ -18,6 +18,13 @@
 #include <sstream>
 #include <vector>
 #include <set>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <cstdint>
 #include <gmp.h>
 #include <mpfr.h>
 #include <gmpxx.h>
@@ -30,9 +37,16 @@ using namespace std;
 namespace flopoco{
 
 
-	TestBench::TestBench(Target* target, Operator* op, int n, bool fromFile):
+	TestBench::TestBench(Target* target, Operator* op, int n, bool fromFile, string format):
 		Operator(nullptr, target), op_(op), n_(n), fromFile_(fromFile)
 	{
+		if (format == "text")
+			hexFormat_ = false;
+		else if (format == "hex")
+			hexFormat_ = true;
+		else
+			THROWERROR("Unknown test file format " << format << ", expected text or hex");
+
 		//We do not set the parent operator to this operator
 		setNoParseNoSchedule();
 
@@ -52,9 +66,13 @@ namespace flopoco{
 		FloPoCoRandomState::init(n);
 		// Generate the standard and random test cases for this operator
 		op-> buildStandardTestCases(&tcl_);
+		int standardTestCases = tcl_.getNumberOfTestCases();
 		// initialization of randomstate generator with the seed base on the number of
 		// random testcase to be generated
 		if (!fromFile) op-> buildRandomTestCaseList(&tcl_, n);
+		// done after the random test cases, so that it does not change them
+		if (op->hasEmulateFast())
+			checkEmulateFast(standardTestCases);
 
 
 		// The instance
@@ -82,6 +100,7 @@ namespace flopoco{
 		// The VHDL for the instance
 		vhdl << endl << instance(op, "test", false) << endl;
 		subComponentList_.clear(); // it is unfortunately set by instance()
+		indexSubComponents();
 
 		vhdl << tab << "-- Ticking clock signal" <<endl;
 		vhdl << tab << "process" <<endl;
@@ -124,7 +143,7 @@ namespace flopoco{
 		};
 
 		// declaration of test time
-		int currentOutputTime = 0;
+		int64_t currentOutputTime = 0;
 
 		// In order to generate the file containing inputs and expected output in a correct order
 		// we will store the use order for file decompression
@@ -153,6 +172,10 @@ namespace flopoco{
 			/*if (s->width() != 1)*/ vhdl << " : bit_vector("<< s->width() - 1 << " downto 0);" << endl;
 			//else vhdl << " : bit;" << endl;
 		}
+		if (hexFormat_) {
+			for(Signal* s: inputSignalVector)
+				vhdl << tab << tab << "variable H_" << s->getName() << " : std_logic_vector("<< s->width() - 1 << " downto 0);" << endl;
+		}
 
 		/* Process Beginning */
 		vhdl << tab << "begin" << endl;
@@ -170,18 +193,32 @@ namespace flopoco{
 		/* All inputs and the corresponding expected outputs will be on the same line
 		 * so we begin by reading this line, once and for all (once by test) */
 		vhdl << tab << tab << tab << "readline(inputsFile,inline);" << endl;
+		if (hexFormat_) { // skip the header
+			vhdl << tab << tab << tab << "if inline'length > 0 and inline(1) = '#' then" << endl;
+			vhdl << tab << tab << tab << tab << "next;" << endl;
+			vhdl << tab << tab << tab << "end if;" << endl;
+		}
 
 		// input reading and forwarding to the operator
 		for(unsigned int i=0; i < inputSignalVector.size(); i++){
 			Signal* s = inputSignalVector[i];
-			vhdl << tab << tab << tab << "read(inline ,V_"<< s->getName() << ");" << endl;
+			string value;
+			if (hexFormat_) {
+				vhdl << tab << tab << tab << "read_hex(inline ,H_"<< s->getName() << ");" << endl;
+				value = "H_" + s->getName();
+			}
+			else {
+				vhdl << tab << tab << tab << "read(inline ,V_"<< s->getName() << ");" << endl;
+				value = "to_stdlogicvector(V_" + s->getName() + ")";
+			}
 			vhdl << tab << tab << tab << "read(inline,tmpChar);" << endl; // we consume the character between each inputs
-			if ((s->width() == 1) && (!s->isBus())) vhdl << tab << tab << tab << s->getName() << " <= to_stdlogicvector(V_" << s->getName() << ")(0);" << endl;
-			else vhdl << tab << tab << tab << s->getName() << " <= to_stdlogicvector(V_" << s->getName() << ");" << endl;
+			if ((s->width() == 1) && (!s->isBus())) vhdl << tab << tab << tab << s->getName() << " <= " << value << "(0);" << endl;
+			else vhdl << tab << tab << tab << s->getName() << " <= " << value << ";" << endl;
 			// adding the IO to IOorder
 			IOorderInput.push_back(s->getName());
 		}
-		vhdl << tab << tab << tab << "readline(inputsFile,inline);" << endl;  // it consume output line
+		if (!hexFormat_)
+			vhdl << tab << tab << tab << "readline(inputsFile,inline);" << endl;  // it consume output line
 		vhdl << tab << tab << tab << "wait for 10 ns;" << endl; // let 10 ns between each input
 		vhdl << tab << tab << "end loop;" << endl;
 		vhdl << tab << tab << "wait for 10000 ns; -- wait for simulation to finish" << endl; // TODO : tune correctly with pipeline depth
@@ -216,6 +253,12 @@ namespace flopoco{
 			vhdl << tab << tab << "variable expected_"  << s->getName() << ": string (1 to 1000);" << endl; // will be a copy of inline
 			vhdl << tab << tab << "variable expected_size_"  << s->getName() << " : integer;" << endl;
 		}
+		if (hexFormat_) {
+			for(Signal* s: inputSignalVector)
+				vhdl << tab << tab << "variable H_" << s->getName() << " : std_logic_vector("<< s->width() - 1 << " downto 0);" << endl;
+			for(Signal* s: outputSignalVector)
+				vhdl << tab << tab << "variable H_" << s->getName() << " : std_logic_vector("<< s->width() - 1 << " downto 0);" << endl;
+		}
 
 		/* Process Beginning */
 		vhdl << tab << "begin" << endl;
@@ -237,8 +280,22 @@ namespace flopoco{
 
 		/* All inputs and the corresponding expected outputs will be on the same line
 		 * so we begin by reading this line, once and for all (once by test) */
-		vhdl << tab << tab << tab << "readline(inputsFile,inline0);" << endl; // it consumes input line
-		vhdl << tab << tab << tab << "readline(inputsFile,inline);" << endl;
+		if (hexFormat_) {
+			// a single line per test: skip the header, then the inputs
+			vhdl << tab << tab << tab << "readline(inputsFile,inline);" << endl;
+			vhdl << tab << tab << tab << "if inline'length > 0 and inline(1) = '#' then" << endl;
+			vhdl << tab << tab << tab << tab << "counter := counter + 1;" << endl;
+			vhdl << tab << tab << tab << tab << "next;" << endl;
+			vhdl << tab << tab << tab << "end if;" << endl;
+			for(Signal* s: inputSignalVector){
+				vhdl << tab << tab << tab << "read_hex(inline ,H_"<< s->getName() << ");" << endl;
+				vhdl << tab << tab << tab << "read(inline,tmpChar);" << endl;
+			}
+		}
+		else {
+			vhdl << tab << tab << tab << "readline(inputsFile,inline0);" << endl; // it consumes input line
+			vhdl << tab << tab << tab << "readline(inputsFile,inline);" << endl;
+		}
 
 		// vhdl << tab << tab << tab << "wait for "<< op_->getPipelineDepth()*10 <<" ns; -- wait for pipeline to flush" <<endl;
 		for(Signal* s: outputSignalVector){
@@ -248,19 +305,31 @@ namespace flopoco{
 			vhdl << tab << tab << tab << "expected_size_"<< s->getName() << " := inline'Length;"<< endl; // the remainder is the vector of expected outputs: remember how long it is
 			vhdl << tab << tab << tab << "expected_"<< s->getName() << " := inline.all & (expected_size_"<< s->getName() << "+1 to 1000 => ' ');"<< endl; // because we have to pad it to 1000 chars
 			string expectedString = "expected_" +  s->getName() + "(1 to expected_size_" + s->getName() + ")"; //  will be used several times below, so better have a Single Source of Bug
+			// how to read one expected value, and how to refer to it once read
+			string readExpected, expected;
+			bool isBit = (s->width() == 1) && (!s->isBus());
+			if (hexFormat_) {
+				readExpected = "read_hex(inline ,H_" + s->getName() + ");";
+				expected = "H_" + s->getName() + (isBit ? "(0)" : "");
+			}
+			else {
+				readExpected = "read(inline ,V_" + s->getName() + ");";
+				expected = (isBit ? "to_stdlogic(V_" : "to_stdlogicvector(V_") + s->getName() + ")";
+			}
+			string expectedFP = (hexFormat_ ? "H_" + s->getName() : "to_stdlogicvector(V_" + s->getName() + ")");
 			vhdl << tab << tab << tab << "if possibilityNumber = 0 then" << endl;
 			vhdl << tab << tab << tab << tab << "localErrorCounter := 0;" << endl;//read(inline,tmpChar);" << endl; // we consume the character between each outputs
 			vhdl << tab << tab << tab << "elsif possibilityNumber = 1 then " << endl;
-			vhdl << tab << tab << tab << tab << "read(inline ,V_"<< s->getName() << ");" << endl;
+			vhdl << tab << tab << tab << tab << readExpected << endl;
 			vhdl << tab << tab << tab << tab << "if ";
 			if (s->isFP()) {
-				vhdl << "not fp_equal(fp"<< s->width() << "'(" << s->getName() << ") ,to_stdlogicvector(V_" <<  s->getName() << "))";
+				vhdl << "not fp_equal(fp"<< s->width() << "'(" << s->getName() << ") ," << expectedFP << ")";
 			} else if (s->isIEEE()) {
-			    vhdl << "not fp_equal_ieee(" << s->getName() << " ,to_stdlogicvector(V_" <<  s->getName() << "),"<<s->wE()<<" , "<<s->wF()<<")";
+			    vhdl << "not fp_equal_ieee(" << s->getName() << " ," << expectedFP << ","<<s->wE()<<" , "<<s->wF()<<")";
 			} else if ((s->width() == 1) && (!s->isBus())) {
-				vhdl << "not (" << s->getName() << "= to_stdlogic(V_" << s->getName() << "))";
+				vhdl << "not (" << s->getName() << "= " << expected << ")";
 			} else {
-				vhdl << "not (" << s->getName() << "= to_stdlogicvector(V_" << s->getName() << "))";
+				vhdl << "not (" << s->getName() << "= " << expected << ")";
 			}
 			vhdl << " then " << endl;
 			vhdl << tab << tab << tab << tab << tab << " errorCounter := errorCounter + 1;" << endl;
@@ -272,16 +341,16 @@ namespace flopoco{
 
 			vhdl << tab << tab << tab << "else" << endl;
 			vhdl << tab << tab << tab << tab << "for i in possibilityNumber downto 1 loop " << endl;
-			vhdl << tab << tab << tab << tab << tab << "read(inline ,V_"<< s->getName() << ");" << endl;
+			vhdl << tab << tab << tab << tab << tab << readExpected << endl;
 			vhdl << tab << tab << tab << tab << tab << "read(inline,tmpChar);" << endl; // we consume the character between each outputs
 			if (s->isFP()) {
-				vhdl << tab << tab << tab << tab << tab << "if fp_equal(fp"<< s->width() << "'(" << s->getName() << ") ,to_stdlogicvector(V_" <<  s->getName() << ")) " << "  then localErrorCounter := 1; end if; " << endl;
+				vhdl << tab << tab << tab << tab << tab << "if fp_equal(fp"<< s->width() << "'(" << s->getName() << ") ," << expectedFP << ") " << "  then localErrorCounter := 1; end if; " << endl;
 			} else if (s->isIEEE()) {
-				vhdl << tab << tab << tab << tab << tab << "if fp_equal_ieee(" << s->getName() << " ,to_stdlogicvector(V_" <<  s->getName() << "),"<<s->wE()<<" , "<<s->wF()<<")" << " then localErrorCounter := 1; end if;" << endl;
+				vhdl << tab << tab << tab << tab << tab << "if fp_equal_ieee(" << s->getName() << " ," << expectedFP << ","<<s->wE()<<" , "<<s->wF()<<")" << " then localErrorCounter := 1; end if;" << endl;
 			} else if ((s->width() == 1) && (!s->isBus())) {
-				vhdl << tab << tab << tab << tab << tab << "if (" << s->getName() << "= to_stdlogic(V_" << s->getName() << ")) " << " then localErrorCounter := 1; end if;" << endl;
+				vhdl << tab << tab << tab << tab << tab << "if (" << s->getName() << "= " << expected << ") " << " then localErrorCounter := 1; end if;" << endl;
 			} else {
-				vhdl << tab << tab << tab << tab << tab << "if (" << s->getName() << "= to_stdlogicvector(V_" << s->getName() << ")) " << " then localErrorCounter := 1; end if;" << endl;
+				vhdl << tab << tab << tab << tab << tab << "if (" << s->getName() << "= " << expected << ") " << " then localErrorCounter := 1; end if;" << endl;
 			}
 			vhdl << tab << tab << tab << tab << "end loop;" << endl;
 			vhdl << tab << tab << tab << tab << " if (localErrorCounter = 0) then " << endl;
@@ -301,7 +370,10 @@ namespace flopoco{
 		};
 		vhdl << tab << tab << tab << " wait for 10 ns; -- wait for pipeline to flush" << endl;
 		currentOutputTime += 10 * (tcl_.getNumberOfTestCases()+n_); // time for simulation
-		vhdl << tab << tab << tab << "counter := counter + 2;" << endl; // incrementing by 2 because a testcase takes two lines (one for input, one for output)
+		if (hexFormat_)
+			vhdl << tab << tab << tab << "counter := counter + 1;" << endl; // a testcase takes a single line
+		else
+			vhdl << tab << tab << tab << "counter := counter + 2;" << endl; // incrementing by 2 because a testcase takes two lines (one for input, one for output)
 		vhdl << tab << tab << "end loop;" << endl;
 		vhdl << tab << tab << "report (integer'image(errorCounter) & \" error(s) encoutered.\");" << endl;
 		vhdl << tab << tab << "report \"End of simulation\" severity note;" <<endl;
@@ -318,29 +390,14 @@ namespace flopoco{
 			ofstream fileOut(inputFileName.c_str(),ios::out);
 			// if error at opening, let's mention it !
 			if (!fileOut) cerr << "FloPoCo was not abe to open " << inputFileName << " in order to write down inputs. " << endl;
+			if (fileOut) writeFileHeader(fileOut, IOorderInput, IOorderOutput);
 			for (int i = 0; i < tcl_.getNumberOfTestCases(); i++)	{
 				TestCase* tc = tcl_.getTestCase(i);
-				if (fileOut) fileOut << tc->generateInputString(IOorderInput,IOorderOutput);
+				if (fileOut) fileOut << testCaseString(tc, IOorderInput, IOorderOutput);
 			}
 
-			//let's not reinvent the wheel
-			/*
-			// generation on the fly of random test case
-			for (int i = 0; i < n_; i++) {
-				TestCase* tc = op_->buildRandomTestCase(i);
-				if (fileOut) fileOut << tc->generateInputString(IOorderInput,IOorderOutput);
-				delete tc;
-			};
-			*/
-			TestCaseList *tcl = new TestCaseList();
-
-			op_->buildRandomTestCaseList(tcl, n_);
-			for (int i = 0; i < n_; i++) {
-				TestCase* tc = tcl->getTestCase(i);
-				if (fileOut) fileOut << tc->generateInputString(IOorderInput,IOorderOutput);
-				delete tc;
-			};
-			delete tcl;
+			// generation on the fly of random test cases, streamed to the file chunk by chunk
+			generateRandomTestFile(fileOut, IOorderInput, IOorderOutput);
 
 			// closing input file
 			fileOut.close();
@@ -356,24 +413,8 @@ namespace flopoco{
 				THROWERROR("Not able to open " << inputFileName << " in order to write inputs. ");
 
 			REPORT(LIST,"Generating the exhaustive test bench, this may take some time");
-			// exhaustive test
-			int length = inputSignalVector.size();
-			//			REPORT(0, "Found " << length << "inputs"); 
-			int* InWidth = new int[length];
-			// getting signal width
-			for (int i = 0; i < length; i++) InWidth[i] = inputSignalVector[i]->width();
-			mpz_class* bound = new mpz_class[length];
-			mpz_class* counters = new mpz_class[length];
-			int number = 1;
-			for (int i = 0; i < length; i++) {
-				bound[i] = (mpz_class(1) << InWidth[i]);// * tmp;
-				counters[i] = 0;
-				number *= intpow2(InWidth[i]);
-			}
-			// getting signal name
-			string* IOname = new string[length];
-			for (int i = 0; i < length; i++) IOname[i] = inputSignalVector[i]->getName();
-			TestCase* tc;
+			writeFileHeader(fileOut, IOorderInput, IOorderOutput);
+			uint64_t number = generateExhaustiveTestFile(fileOut, inputSignalVector, IOorderInput, IOorderOutput);
 
 			// simulation time computation
 			currentOutputTime = 0;
@@ -385,28 +426,247 @@ namespace flopoco{
 			currentOutputTime += 2;
 			simulationTime=currentOutputTime;
 
+			fileOut.close();
+		}
+	}
+
+
+	void TestBench::checkEmulateFast(int standardTestCases) {
+		// The reference is emulate(): first on the standard test cases, which it has already completed
+		vector<TestCase*> reference;
+		for (int i = 0; i < standardTestCases; i++)
+			reference.push_back(tcl_.getTestCase(i));
+		// then on uniformly random inputs
+		const int randomChecks = 1000;
+		for (int i = 0; i < randomChecks; i++) {
+			TestCase* tc = new TestCase(op_);
+			for (int j = 0; j < op_->getIOListSize(); j++) {
+				Signal* s = op_->getIOListSignal(j);
+				if (s->type() == Signal::in)
+					tc->addInput(s->getName(), getLargeRandom(s->width()));
+			}
+			op_->emulate(tc);
+			reference.push_back(tc);
+		}
+
+		string error;
+		FastTestCase ftc(op_);
+		for (auto tc : reference) {
+			ftc.reset();
+			ftc.setInputs(tc);
+			op_->emulateFast(&ftc);
+			string diff = ftc.compareExpectedOutputs(tc);
+			if (diff != "" && error == "") {
+				ostringstream o;
+				o << "for inputs";
+				for (int j = 0; j < op_->getIOListSize(); j++) {
+					Signal* s = op_->getIOListSignal(j);
+					if (s->type() == Signal::in)
+						o << " " << s->getName() << "=" << tc->getInputValue(s->getName());
+				}
+				error = o.str() + ": " + diff;
+			}
+		}
+		for (int i = standardTestCases; i < (int)reference.size(); i++)
+			delete reference[i];
+		if (error != "")
+			THROWERROR("emulateFast() and emulate() disagree " << error);
+		REPORT(DETAILED, "emulateFast() agrees with emulate() on " << reference.size() << " test cases, using it");
+	}
+
+
+	void TestBench::writeFileHeader(ostream& fileOut, list<string> &IOorderInput, list<string> &IOorderOutput) {
+		// The text format has no header, its reader expects exactly two lines per test
+		if (!hexFormat_)
+			return;
+		fileOut << "# FloPoCo test vectors, hex format: one line per test, with the inputs, then for each output the number of possible values followed by these values" << endl;
+		fileOut << "# inputs:";
+		for (auto name : IOorderInput)
+			fileOut << " " << name << ":" << op_->getSignalByName(name)->width();
+		fileOut << endl << "# outputs:";
+		for (auto name : IOorderOutput)
+			fileOut << " " << name << ":" << op_->getSignalByName(name)->width();
+		fileOut << endl;
+	}
+
+
+	string TestBench::testCaseString(TestCase* tc, list<string> &IOorderInput, list<string> &IOorderOutput) {
+		if (hexFormat_)
+			return tc->generateHexInputString(IOorderInput, IOorderOutput);
+		else
+			return tc->generateInputString(IOorderInput, IOorderOutput);
+	}
+
+
+	void TestBench::generateRandomTestFile(ostream& fileOut, list<string> &IOorderInput, list<string> &IOorderOutput) {
+		// Each chunk of random test cases uses its own random stream, derived from n_ and the chunk index.
+		// The file content therefore only depends on n_, not on the number of threads.
+		const int chunkSize = 1024;
+		const size_t chunks = (n_ + chunkSize - 1) / chunkSize;
+
+		// the random test cases are completed by emulateTestCase(), hence by emulateFast() if it exists
+		bool parallel = (op_->isEmulateThreadSafe() && mpfr_buildopt_tls_p()) || op_->hasEmulateFast();
+		writeChunksInOrder(fileOut, chunks, parallel, [&](size_t k) {
+				FloPoCoRandomState::initStream(n_, k);
+				ostringstream o;
+				int first = k * chunkSize;
+				int last = min(n_, first + chunkSize);
+				for (int i = first; i < last; i++) {
+					TestCase* tc = op_->buildRandomTestCase(i);
+					o << testCaseString(tc, IOorderInput, IOorderOutput);
+					delete tc;
+				}
+				return o.str();
+			});
+	}
+
+
+	uint64_t TestBench::generateExhaustiveTestFile(ostream& fileOut, vector<Signal*> &inputSignalVector, list<string> &IOorderInput, list<string> &IOorderOutput) {
+		// The input space is enumerated as a single 64-bit index:
+		// the first input holds the least significant bits, so that it varies fastest
+		int length = inputSignalVector.size();
+		vector<string> IOname(length);
+		vector<int> offset(length);
+		vector<uint64_t> mask(length);
+		int totalWidth = 0;
+		for (int i = 0; i < length; i++) {
+			Signal* s = inputSignalVector[i];
+			IOname[i] = s->getName();
+			offset[i] = totalWidth;
+			mask[i] = (s->width() >= 64 ? ~uint64_t(0) : (uint64_t(1) << s->width()) - 1);
+			totalWidth += s->width();
+		}
+		if (totalWidth > 63)
+			THROWERROR("Exhaustive test requested for " << totalWidth << " input bits, only up to 63 are supported");
+		const uint64_t number = uint64_t(1) << totalWidth;
+
+		const uint64_t chunkSize = 4096;
+		const size_t chunks = (number + chunkSize - 1) / chunkSize;
+
+		if (op_->hasEmulateFast()) {
+			// native integers all the way, see checkEmulateFast() for the correctness of emulateFast()
+			writeChunksInOrder(fileOut, chunks, true, [&](size_t k) {
+					string o;
+					FastTestCase tc(op_);
+					uint64_t first = k * chunkSize;
+					uint64_t last = std::min(number, first + chunkSize);
+					for (uint64_t v = first; v < last; v++) {
+						tc.reset();
+						for (int i = 0; i < length; i++)
+							tc.setInput(i, (v >> offset[i]) & mask[i]);
+						op_->emulateFast(&tc);
+						o += (hexFormat_ ? tc.generateHexInputString() : tc.generateInputString());
+					}
+					return o;
+				});
+			return number;
+		}
+
+		bool parallel = op_->isEmulateThreadSafe() && mpfr_buildopt_tls_p();
+		writeChunksInOrder(fileOut, chunks, parallel, [&](size_t k) {
+				ostringstream o;
+				// One TestCase per chunk, reused for all its vectors
+				TestCase tc(op_);
+				uint64_t first = k * chunkSize;
+				uint64_t last = std::min(number, first + chunkSize);
+				for (uint64_t v = first; v < last; v++) {
+					tc.reset();
+					for (int i = 0; i < length; i++)
+						tc.addInput(IOname[i], mpz_class((unsigned long)((v >> offset[i]) & mask[i])));
+					op_->emulate(&tc);
+					o << testCaseString(&tc, IOorderInput, IOorderOutput);
+				}
+				return o.str();
+			});
+		return number;
+	}
 
+
+	void TestBench::writeChunksInOrder(ostream& fileOut, size_t chunks, bool parallel, function<string(size_t)> buildChunk) {
+		size_t workers = 1;
+		if (parallel)
+			workers = std::max(1u, thread::hardware_concurrency());
+		workers = std::min(workers, chunks);
+
+		if (workers <= 1) {
+			for (size_t k = 0; k < chunks; k++) {
+				string s = buildChunk(k);
+				if (fileOut) fileOut << s;
+			}
+			return;
+		}
+
+		REPORT(DETAILED, "Generating " << chunks << " chunks of test cases on " << workers << " threads");
+		// The workers produce chunks out of order, this thread writes them in order.
+		// At most window chunks are kept in memory at any time.
+		const size_t window = 4 * workers;
+		mutex m;
+		condition_variable cv;
+		map<size_t, string> ready;
+		size_t nextChunk = 0;
+		size_t nextWritten = 0;
+		bool failed = false;
+		exception_ptr error; // an exception must not escape a thread: it is rethrown by this one
+
+		auto worker = [&]() {
 			while (true) {
-				for (int i = 0; i < length-1; i++) {
-            		if (counters[i] >= bound[i]) {
-						counters[i] = 0;
-						counters[i+1] += 1;
+				size_t k;
+				{
+					unique_lock<mutex> lock(m);
+					cv.wait(lock, [&]{ return failed || nextChunk >= chunks || nextChunk < nextWritten + window; });
+					if (failed || nextChunk >= chunks)
+						return;
+					k = nextChunk++;
+				}
+				string s;
+				try {
+					s = buildChunk(k);
+				}
+				catch (...) {
+					lock_guard<mutex> lock(m);
+					if (!failed) {
+						failed = true;
+						error = current_exception();
 					}
+					cv.notify_all();
+					return;
 				}
-				// if the max counter overflows, break
-				if (counters[length-1] >= bound[length-1]) break;
-				// Test Case inputs
-				tc = new TestCase(op_);
-				for (int i = 0; i < length; i++) {
-					tc->addInput(IOname[i],counters[i]);
+				{
+					lock_guard<mutex> lock(m);
+					ready[k] = std::move(s);
 				}
-				op_->emulate(tc);
-				if (fileOut) fileOut << tc->generateInputString(IOorderInput,IOorderOutput);
-				// incrementation
-				counters[0]++;
-				delete tc;
+				cv.notify_all();
+			}
+		};
+
+		vector<thread> pool;
+		for (size_t t = 0; t < workers; t++)
+			pool.push_back(thread(worker));
+
+		{
+			unique_lock<mutex> lock(m);
+			while (nextWritten < chunks) {
+				cv.wait(lock, [&]{ return failed || ready.count(nextWritten) != 0; });
+				if (failed)
+					break;
+				string s = std::move(ready[nextWritten]);
+				ready.erase(nextWritten);
+				nextWritten++;
+				cv.notify_all();
+				lock.unlock();
+				if (fileOut) fileOut << s;
+				lock.lock();
+			}
+		}
+		for (auto &t : pool)
+			t.join();
+		if (failed) {
+			try {
+				rethrow_exception(error);
+			}
+			catch (const string &e) {
+				THROWERROR("while generating test cases: " << e);
 			}
-			fileOut.close();
 		}
 	}
 
@@ -435,7 +695,7 @@ namespace flopoco{
 		vhdl << tab << "end process;" <<endl;
 		vhdl <<endl;
 
-		int currentOutputTime = 0;
+		int64_t currentOutputTime = 0;
 		vhdl << tab << "-- Checking the outputs" <<endl;
 		vhdl << tab << "process" <<endl;
 		vhdl << tab << "begin" <<endl;
@@ -580,6 +840,36 @@ namespace flopoco{
 
 		o << endl << endl << endl;
 
+		if (fromFile_ && hexFormat_) {
+			o << tab << "-- reads a hexadecimal field of test.input into a std_logic_vector" << endl
+			  << tab << "procedure read_hex(l: inout line; v: out std_logic_vector) is" << endl
+			  << tab << tab << "variable c : character;" << endl
+			  << tab << tab << "variable d : integer;" << endl
+			  << tab << tab << "variable r : std_logic_vector(4*((v'length+3)/4)-1 downto 0);" << endl
+			  << tab << "begin" << endl
+			  << tab << tab << "c := ' ';" << endl
+			  << tab << tab << "while c = ' ' loop" << endl
+			  << tab << tab << tab << "read(l, c);" << endl
+			  << tab << tab << "end loop;" << endl
+			  << tab << tab << "for i in r'length/4-1 downto 0 loop" << endl
+			  << tab << tab << tab << "case c is" << endl
+			  << tab << tab << tab << tab << "when '0' to '9' => d := character'pos(c) - character'pos('0');" << endl
+			  << tab << tab << tab << tab << "when 'a' to 'f' => d := character'pos(c) - character'pos('a') + 10;" << endl
+			  << tab << tab << tab << tab << "when 'A' to 'F' => d := character'pos(c) - character'pos('A') + 10;" << endl
+			  << tab << tab << tab << tab << "when others => d := 0;" << endl
+			  << tab << tab << tab << "end case;" << endl
+			  << tab << tab << tab << "for b in 0 to 3 loop" << endl
+			  << tab << tab << tab << tab << "if (d / 2**b) mod 2 = 1 then r(4*i+b) := '1'; else r(4*i+b) := '0'; end if;" << endl
+			  << tab << tab << tab << "end loop;" << endl
+			  << tab << tab << tab << "if i > 0 then" << endl
+			  << tab << tab << tab << tab << "read(l, c);" << endl
+			  << tab << tab << tab << "end if;" << endl
+			  << tab << tab << "end loop;" << endl
+			  << tab << tab << "v := r(v'length-1 downto 0);" << endl
+			  << tab << "end read_hex;" << endl;
+			o << endl << endl << endl;
+		}
+
 
 		/* If op_ is an IEEE operator (IEEE input and output, we define) the function
 		 * fp_equal for the considered precision in the ieee case
@@ -670,7 +960,7 @@ namespace flopoco{
 
 
 		/** Return the total simulation time*/
-		int TestBench::getSimulationTime(){
+		int64_t TestBench::getSimulationTime(){
 			//			cerr << endl << endl<< simulationTime << endl << endl ;
 			return simulationTime;
 		}
@@ -682,6 +972,7 @@ namespace flopoco{
 	OperatorPtr TestBench::parseArguments(OperatorPtr parentOp, Target *target, vector<string> &args) {
 		int n;
 		bool file;
+		string format;
 
 		if(UserInterface::globalOpList.empty()){
 			throw(string("TestBench has no operator to wrap (it should come after the operator it wraps)"));
@@ -689,8 +980,9 @@ namespace flopoco{
 
 		UserInterface::parseInt(args, "n", &n);
 		UserInterface::parseBoolean(args, "file", &file);
+		UserInterface::parseString(args, "format", &format);
 		Operator* toWrap = UserInterface::globalOpList.back();
-		Operator* newOp = new TestBench(target, toWrap, n, file);
+		Operator* newOp = new TestBench(target, toWrap, n, file, format);
 		// the instance in newOp has added toWrap as a subcomponent of newOp,
 		// so we may remove it from globalOpList
 		//UserInterface::globalOpList.pop_back();
@@ -703,7 +995,8 @@ namespace flopoco{
 											 "TestBenches",
 											 "fixed-point function evaluator; fixed-point", // categories
 											 "n(int)=-2: number of random tests. If n=-2, an exhaustive test is generated (use only for small operators);\
-                        file(bool)=true:Inputs and outputs are stored in file test.input (lower VHDL compilation time). If false, they are stored in the VHDL;",
+                        file(bool)=true:Inputs and outputs are stored in file test.input (lower VHDL compilation time). If false, they are stored in the VHDL;\
+                        format(string)=text:format of test.input, text or hex (hexadecimal values, one line per test: smaller file and faster simulation);",
 											 "",
 											 TestBench::parseArguments
 											 ) ;
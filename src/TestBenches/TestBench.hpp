@@ -1,6 +1,9 @@
 #ifndef __TESTBENCH_HPP
 #define __TESTBENCH_HPP
 
+#include <cstdint>
+#include <functional>
+
 /**
  * Creates a TestBench, which tests a certain Operator.
  * The test cases are generated by the unit under test (UUT).
@@ -16,8 +19,10 @@ namespace flopoco{
 		 * @param target The target architecture
 		 * @param op The operator which is the UUT
 		 * @param n Number of tests
+		 * @param fromFile if true, the tests are read from the file test.input
+		 * @param format the format of test.input: "text" (two lines of binary strings per test) or "hex" (one line of hexadecimal fields per test, after a header)
 		 */
-		TestBench(Target *target, Operator *op, int n, bool fromFile = false);
+		TestBench(Target *target, Operator *op, int n, bool fromFile = false, string format = "text");
 
 		/** Destructor */
 		~TestBench();
@@ -40,7 +45,7 @@ namespace flopoco{
 		void generateTestInVhdl();
 
 		/** Return the total simulation time*/
-		int getSimulationTime();
+		int64_t getSimulationTime();
 
 
 		/** Factory method that parses arguments and calls the constructor */
@@ -51,11 +56,38 @@ namespace flopoco{
 
 		
 	private:
+		/** Generates the n_ random test cases and writes them to fileOut, in parallel if the UUT allows it
+		 * (see Operator::isEmulateThreadSafe()).
+		 */
+		void generateRandomTestFile(ostream& fileOut, list<string> &IOorderInput, list<string> &IOorderOutput);
+
+		/** Generates all the input combinations of the UUT and writes them to fileOut, in parallel if the UUT allows it.
+		 * @return the number of test cases written
+		 */
+		uint64_t generateExhaustiveTestFile(ostream& fileOut, vector<Signal*> &inputSignalVector, list<string> &IOorderInput, list<string> &IOorderOutput);
+
+		/** Calls buildChunk(0) to buildChunk(chunks-1), on several threads if parallel is true,
+		 * and writes their results to fileOut in this order.
+		 */
+		void writeChunksInOrder(ostream& fileOut, size_t chunks, bool parallel, function<string(size_t)> buildChunk);
+
+		/** Checks that the emulateFast() of the UUT computes the same outputs as its emulate(),
+		 * on the first standardTestCases test cases of tcl_ and on random inputs. Throws an error otherwise.
+		 */
+		void checkEmulateFast(int standardTestCases);
+
+		/** Writes the header of test.input, which describes the IO order (hex format only) */
+		void writeFileHeader(ostream& fileOut, list<string> &IOorderInput, list<string> &IOorderOutput);
+
+		/** Formats one test case in the format of test.input */
+		string testCaseString(TestCase* tc, list<string> &IOorderInput, list<string> &IOorderOutput);
+
 		Operator *op_; /**< The unit under test UUT */
 		int       n_;   /**< The parameter from the constructor */
 		TestCaseList tcl_; /**< Test case list */
-		int simulationTime; /**< Total simulation time */
+		int64_t simulationTime; /**< Total simulation time */
 		bool fromFile_; /**< Flag for external file I/O */
+		bool hexFormat_; /**< Flag for the hex format of test.input */
 	};
 
 }
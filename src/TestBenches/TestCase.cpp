@@ -1,5 +1,6 @@
 #include "TestBenches/TestCase.hpp"
 #include "Operator.hpp"
+#include <algorithm>
 
 namespace flopoco{
 
@@ -155,6 +156,10 @@ namespace flopoco{
 		return inputs[s];
 	}
 
+	vector<mpz_class> TestCase::getExpectedOutputValues(string s){
+		return outputs[s];
+	}
+
 	void TestCase::setInputValue(string s, mpz_class v){
 		inputs[s]=v;
 	}
@@ -273,16 +278,16 @@ namespace flopoco{
 		return o.str();
 	}
 
-        std::string TestCase::generateInputString(list<string> IOorderInput, list<string> IOorderOutput) {
+        std::string TestCase::generateInputString(const list<string> &IOorderInput, const list<string> &IOorderOutput) {
                 ostringstream o;
                 /* iterate trough input signals */
-                for (list<string>::iterator it = IOorderInput.begin(); it != IOorderInput.end(); it++) {
+                for (list<string>::const_iterator it = IOorderInput.begin(); it != IOorderInput.end(); it++) {
 			  Signal* s = op_->getSignalByName(*it);
 			  mpz_class v = inputs[*it];
 			  o << s->valueToVHDL(v,false) << " ";
                 }
 		o << "\n";
-                for (list<string>::iterator it = IOorderOutput.begin();it != IOorderOutput.end(); it++) {
+                for (list<string>::const_iterator it = IOorderOutput.begin();it != IOorderOutput.end(); it++) {
 			Signal* s = op_->getSignalByName(*it);
 			vector<mpz_class> vs = outputs[*it];
 
@@ -302,6 +307,30 @@ namespace flopoco{
 
 
 
+	std::string TestCase::generateHexInputString(const list<string> &IOorderInput, const list<string> &IOorderOutput) {
+		ostringstream o;
+		for (auto name : IOorderInput) {
+			Signal* s = op_->getSignalByName(name);
+			o << s->valueToVHDLHex(inputs[name], false) << " ";
+		}
+		for (auto name : IOorderOutput) {
+			Signal* s = op_->getSignalByName(name);
+			vector<mpz_class> &vs = outputs[name];
+			o << vs.size() << " ";
+			for (auto v : vs)
+				o << s->valueToVHDLHex(v, false) << " ";
+		}
+		o << endl;
+		return o.str();
+	}
+
+
+	void TestCase::reset() {
+		for (auto &it : outputs)
+			it.second.clear();
+		comment = "";
+	}
+
 	void TestCase::addComment(string c) {
 		comment = c;
 	}
@@ -325,5 +354,114 @@ namespace flopoco{
         msg << std::endl;
         return msg.str();
       }
-}
 
+	/* Conversions between mpz_class and uint64_t that do not depend on the size of long */
+	static uint64_t mpzToUint64(mpz_class v) {
+		return (uint64_t(mpz_class(v >> 32).get_ui()) << 32) | uint64_t(mpz_class(v & 0xFFFFFFFFUL).get_ui());
+	}
+
+	static mpz_class uint64ToMpz(uint64_t v) {
+		return (mpz_class((unsigned long)(v >> 32)) << 32) + mpz_class((unsigned long)(v & 0xFFFFFFFF));
+	}
+
+	/* The binary or hexadecimal string of a value, as produced by Signal::valueToVHDL() and Signal::valueToVHDLHex() */
+	static void appendBinary(string &o, uint64_t v, int width) {
+		for (int i = width-1; i >= 0; i--)
+			o += ((v >> i) & 1) ? '1' : '0';
+	}
+
+	static void appendHex(string &o, uint64_t v, int width) {
+		static const char digits[] = "0123456789abcdef";
+		for (int i = (width+3)/4 - 1; i >= 0; i--)
+			o += digits[(v >> (4*i)) & 15];
+	}
+
+
+	FastTestCase::FastTestCase(Operator* op) {
+		for (int i = 0; i < op->getIOListSize(); i++) {
+			Signal* s = op->getIOListSignal(i);
+			if (s->width() > 64)
+				throw string("FastTestCase: signal " + s->getName() + " is wider than 64 bits");
+			if (s->type() == Signal::in)
+				inputSignals_.push_back(s);
+			else if (s->type() == Signal::out)
+				outputSignals_.push_back(s);
+		}
+		inputs.resize(inputSignals_.size(), 0);
+		outputs.resize(outputSignals_.size());
+	}
+
+	void FastTestCase::reset() {
+		for (auto &o : outputs)
+			o.clear();
+	}
+
+	void FastTestCase::setInputs(TestCase* tc) {
+		for (unsigned i = 0; i < inputSignals_.size(); i++)
+			inputs[i] = mpzToUint64(tc->getInputValue(inputSignals_[i]->getName()));
+	}
+
+	void FastTestCase::addExpectedOutputsTo(TestCase* tc) {
+		for (unsigned i = 0; i < outputSignals_.size(); i++)
+			for (auto v : outputs[i])
+				tc->addExpectedOutput(outputSignals_[i]->getName(), uint64ToMpz(v));
+	}
+
+	string FastTestCase::compareExpectedOutputs(TestCase* tc) {
+		ostringstream o;
+		for (unsigned i = 0; i < outputSignals_.size(); i++) {
+			vector<mpz_class> reference = tc->getExpectedOutputValues(outputSignals_[i]->getName());
+			vector<mpz_class> fast;
+			for (auto v : outputs[i])
+				fast.push_back(uint64ToMpz(v));
+			sort(reference.begin(), reference.end());
+			sort(fast.begin(), fast.end());
+			if (reference != fast) {
+				o << outputSignals_[i]->getName() << ": expected";
+				for (auto v : reference)
+					o << " " << v;
+				o << ", got";
+				for (auto v : fast)
+					o << " " << v;
+				o << "; ";
+			}
+		}
+		return o.str();
+	}
+
+	std::string FastTestCase::generateInputString() {
+		string o;
+		for (unsigned i = 0; i < inputSignals_.size(); i++) {
+			appendBinary(o, inputs[i], inputSignals_[i]->width());
+			o += ' ';
+		}
+		o += '\n';
+		for (unsigned i = 0; i < outputSignals_.size(); i++) {
+			o += to_string(outputs[i].size()) + " ";
+			for (auto v : outputs[i]) {
+				appendBinary(o, v, outputSignals_[i]->width());
+				o += ' ';
+			}
+		}
+		o += '\n';
+		return o;
+	}
+
+	std::string FastTestCase::generateHexInputString() {
+		string o;
+		for (unsigned i = 0; i < inputSignals_.size(); i++) {
+			appendHex(o, inputs[i], inputSignals_[i]->width());
+			o += ' ';
+		}
+		for (unsigned i = 0; i < outputSignals_.size(); i++) {
+			o += to_string(outputs[i].size()) + " ";
+			for (auto v : outputs[i]) {
+				appendHex(o, v, outputSignals_[i]->width());
+				o += ' ';
+			}
+		}
+		o += '\n';
+		return o;
+	}
+
+}
@@ -7,6 +7,7 @@
 #include <list>
 #include <ostream>
 #include <sstream>
+#include <cstdint>
 
 #include "Signal.hpp"
 #include "TestBenches/FPNumber.hpp"
@@ -93,6 +94,12 @@ namespace flopoco{
 		 */
 		mpz_class getInputValue(string s);
 
+		/**
+		 * recover the possible values expected for an output
+		 * @param s The name of the output
+		 */
+		vector<mpz_class> getExpectedOutputValues(string s);
+
 		void setInputValue(string s, mpz_class v);
 
 		/**
@@ -142,7 +149,18 @@ namespace flopoco{
                  * expected outputs, one by line too.
                  * and the order for outputing these IO is given by IOorder
                  */
-                std::string generateInputString(list<string> IOorderInput, list<string> IOorderOutput);
+                std::string generateInputString(const list<string> &IOorderInput, const list<string> &IOorderOutput);
+
+		/**
+		 * same as generateInputString, but on a single line and with the values in hexadecimal
+		 */
+		std::string generateHexInputString(const list<string> &IOorderInput, const list<string> &IOorderOutput);
+
+		/**
+		 * Prepares this TestCase for reuse with new input values: the expected outputs and the comment are emptied,
+		 * but the storage of the inputs and outputs is kept, which saves allocations in loops over many test cases.
+		 */
+		void reset();
 
                 /**
                  *    Define the test case integer identifiant
@@ -166,6 +184,52 @@ namespace flopoco{
 
 
 
+	/**
+		A test case on native integers, used by the fast emulation path (see Operator::emulateFast()).
+		The inputs and outputs are indexed in the order of their declaration in the Operator,
+		and are all at most 64 bits wide.
+	*/
+	class FastTestCase {
+	public:
+
+		/** Creates an empty FastTestCase for operator op */
+		FastTestCase(Operator* op);
+
+		/** The value of the i-th input */
+		uint64_t getInput(int i) const { return inputs[i]; }
+
+		void setInput(int i, uint64_t v) { inputs[i] = v; }
+
+		/** Adds one possible value for the i-th output */
+		void addExpectedOutput(int i, uint64_t v) { outputs[i].push_back(v); }
+
+		/** Empties the expected outputs, keeping their storage */
+		void reset();
+
+		/** Copies the inputs of a TestCase */
+		void setInputs(TestCase* tc);
+
+		/** Adds the expected outputs of this FastTestCase to a TestCase */
+		void addExpectedOutputsTo(TestCase* tc);
+
+		/** Returns a description of the differences between the expected outputs of this and of a TestCase, or an empty string if they are the same sets */
+		string compareExpectedOutputs(TestCase* tc);
+
+		/** Same as TestCase::generateInputString(), for the IO order of the Operator */
+		std::string generateInputString();
+
+		/** Same as TestCase::generateHexInputString(), for the IO order of the Operator */
+		std::string generateHexInputString();
+
+	private:
+		vector<Signal*> inputSignals_;
+		vector<Signal*> outputSignals_;
+		vector<uint64_t> inputs;
+		vector<vector<uint64_t> > outputs;
+	};
+
+
+
 	/**
 	 * Represents a list of test cases that an Operator has to pass.
 	 */
@@ -3,11 +3,17 @@
 #include "TestBenches/TestBench.hpp"
 
 #include "AutoTest/AutoTest.hpp"
+#include "OperatorCache.hpp"
+#include "FixFunctions/SollyaWorkers.hpp"
 
 #include <algorithm>
 #include <sys/stat.h>
 #include <iostream>
 #include <iomanip>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <atomic>
 
 // TODO check the hard mult threshold
 
@@ -26,28 +32,40 @@ namespace flopoco
 	//	const char* defaultFPGA="Zynq7000";
 	const char* defaultFPGA="kintex7";
 
-	// Allocation of the global objects
-	string UserInterface::outputFileName;
-	string UserInterface::entityName=""; // used for the -name option
-	int    UserInterface::verbose;
-	string UserInterface::targetFPGA;
-	double UserInterface::targetFrequencyMHz;
-	bool   UserInterface::clockEnable;
-	bool   UserInterface::useHardMult;
-	bool   UserInterface::plainVHDL;
-	bool   UserInterface::generateFigures;
-	double UserInterface::unusedHardMultThreshold;
-	bool   UserInterface::useTargetOptimizations;
-	string   UserInterface::compression;
-	string   UserInterface::tiling;
-	string UserInterface::ilpSolver;
-	int    UserInterface::ilpTimeout;
-	int    UserInterface::resourceEstimation;
-	bool   UserInterface::floorplanning;
-	bool   UserInterface::reDebug;
-	bool   UserInterface::flpDebug;
-
-	string UserInterface::depGraphDrawing="";
+	// Allocation of the global objects: the generation context of each thread
+	thread_local string UserInterface::outputFileName;
+	thread_local string UserInterface::entityName=""; // used for the -name option
+	thread_local int    UserInterface::verbose;
+	thread_local string UserInterface::targetFPGA;
+	thread_local double UserInterface::targetFrequencyMHz;
+	thread_local bool   UserInterface::pipeline;
+	thread_local bool   UserInterface::clockEnable;
+	thread_local bool   UserInterface::useHardMult;
+	thread_local bool   UserInterface::plainVHDL;
+	thread_local bool   UserInterface::generateFigures;
+	thread_local bool   UserInterface::compressorArrays;
+	thread_local bool   UserInterface::compressTables;
+	thread_local double UserInterface::unusedHardMultThreshold;
+	thread_local bool   UserInterface::useTargetOptimizations;
+	thread_local string UserInterface::compression;
+	thread_local string UserInterface::tiling;
+	thread_local string UserInterface::ilpSolver;
+	thread_local int    UserInterface::ilpTimeout;
+	thread_local int    UserInterface::resourceEstimation;
+	thread_local bool   UserInterface::floorplanning;
+	thread_local bool   UserInterface::reDebug;
+	thread_local bool   UserInterface::flpDebug;
+	thread_local bool   UserInterface::profileSchedule;
+	thread_local bool   UserInterface::reportRegisters;
+	thread_local string UserInterface::batchFileName;
+	thread_local int    UserInterface::jobs;
+	thread_local string UserInterface::cacheDir;
+
+	thread_local string UserInterface::depGraphDrawing="";
+
+	// The operator constructors may use Sollya, which is not thread-safe:
+	// in batch mode, they are called one at a time, while the scheduling and VHDL output of the jobs are parallel
+	static mutex constructionMutex;
 
 
 	const vector<pair<string,string>> UserInterface::categories = []()->vector<pair<string,string>>{
@@ -114,12 +132,17 @@ namespace flopoco
 				v.push_back(option_t("clockEnable", values));
 				v.push_back(option_t("plainVHDL", values));
 				v.push_back(option_t("generateFigures", values));
+				v.push_back(option_t("compressorArrays", values));
+				v.push_back(option_t("compressTables", values));
 				v.push_back(option_t("useHardMults", values));
 				v.push_back(option_t("useTargetOptimizations", values));
 				v.push_back(option_t("ilpSolver", values));
 				v.push_back(option_t("ilpTimeout", values));
 				v.push_back(option_t("compression", values));
 				v.push_back(option_t("tiling", values));
+				v.push_back(option_t("profileSchedule", values));
+				v.push_back(option_t("reportRegisters", values));
+				v.push_back(option_t("jobs", values));
 
 				//free options, using an empty vector of values
 				values.clear();
@@ -127,6 +150,8 @@ namespace flopoco
 				v.push_back(option_t("outputFile", values));
 				v.push_back(option_t("hardMultThreshold", values));
 				v.push_back(option_t("frequency", values));
+				v.push_back(option_t("batch", values));
+				v.push_back(option_t("cacheDir", values));
 
 				//verbosity level
 				values.clear();
@@ -161,6 +186,11 @@ namespace flopoco
 			// This creates all the Operators and the dependency graph.
 			buildAll(argc, argv);
 
+			if(batchFileName != "") { // each line of the batch has been output to its own file
+				sollya_lib_close();
+				return;
+			}
+
 			if(depGraphDrawing != "no")
 			{
 				mkdir("dot", S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
@@ -192,6 +222,8 @@ namespace flopoco
 		parseFloat(args, "hardMultThreshold", &unusedHardMultThreshold, true); // sticky option
 		parseBoolean(args, "useHardMult", &useHardMult, true);
 		parseBoolean(args, "generateFigures", &generateFigures, true);
+		parseBoolean(args, "compressorArrays", &compressorArrays, true);
+		parseBoolean(args, "compressTables", &compressTables, true);
 		parseBoolean(args, "useTargetOptimizations", &useTargetOptimizations, true);
 		parseString(args, "ilpSolver", &ilpSolver, true); // sticky option
 		parsePositiveInt(args, "ilpTimeout", &ilpTimeout, true); // sticky option
@@ -200,6 +232,11 @@ namespace flopoco
 		parseBoolean(args, "floorplanning", &floorplanning, true);
 		//		parseBoolean(args, "reDebug", &reDebug, true );
 		parseString(args, "dependencyGraph", &depGraphDrawing, true);
+		parseBoolean(args, "profileSchedule", &profileSchedule, true);
+		parseBoolean(args, "reportRegisters", &reportRegisters, true);
+		parseString(args, "batch", &batchFileName, true);
+		parseStrictlyPositiveInt(args, "jobs", &jobs, true);
+		parseString(args, "cacheDir", &cacheDir, true); // sticky option
 		//	parseBoolean(args, "", &  );
 	}
 
@@ -208,11 +245,11 @@ namespace flopoco
 	// Global objects: factory list
 	vector<pair<string,OperatorFactoryPtr>> UserInterface::factoryList;
 
-	vector<OperatorPtr>  UserInterface::globalOpList;  /**< Level-0 operators. Each of these can have sub-operators */
+	thread_local vector<OperatorPtr>  UserInterface::globalOpList;  /**< Level-0 operators. Each of these can have sub-operators */
 
-	vector<vector<OperatorPtr>>  UserInterface::globalOpListStack;
+	thread_local vector<vector<OperatorPtr>>  UserInterface::globalOpListStack;
 
-	int UserInterface::pipelineActive_;
+	thread_local int UserInterface::pipelineActive_;
 
 
 
@@ -249,14 +286,14 @@ namespace flopoco
 	}
 
 
-	void UserInterface::outputVHDLToFile(ofstream& file){
+	void UserInterface::outputVHDLToFile(ostream& file){
 		set<string> alreadyOutput; // to avoid redundant output
 		outputVHDLToFile(UserInterface::globalOpList, file, alreadyOutput);
 	}
 
 
 	/* The recursive method */
-	void UserInterface::outputVHDLToFile(vector<OperatorPtr> &oplist, ofstream& file, set<string> &alreadyOutput )
+	void UserInterface::outputVHDLToFile(vector<OperatorPtr> &oplist, ostream& file, set<string> &alreadyOutput )
 	{
 
 		for(auto i: oplist) {
@@ -341,8 +378,15 @@ namespace flopoco
 
 	void UserInterface::initialize(){
         registerFactories();  //implemented in Factories.cpp
+		initializeGenericOptions();
+	}
+
+	void UserInterface::initializeGenericOptions(){
+		globalOpList.clear();
+		globalOpListStack.clear();
 		// Initialize all the command-line options
 		verbose=1;
+		entityName="";
 		outputFileName="flopoco.vhdl";
 		targetFPGA=defaultFPGA;
 		targetFrequencyMHz=400;
@@ -356,6 +400,23 @@ namespace flopoco
 
 		depGraphDrawing = "full";
 		pipelineActive_ = true;
+		profileSchedule = false;
+		reportRegisters = false;
+		batchFileName = "";
+		jobs = 1;
+		cacheDir = "";
+
+		pipeline = false;
+		clockEnable = false;
+		plainVHDL = false;
+		generateFigures = false;
+		compressorArrays = false;
+		compressTables = true;
+		useTargetOptimizations = false;
+		resourceEstimation = 0;
+		floorplanning = false;
+		reDebug = false;
+		flpDebug = false;
 
 	}
 
@@ -375,17 +436,40 @@ namespace flopoco
 			exit(EXIT_SUCCESS);
 		}
 
+		vector<string> args;
+		// convert all the char* to strings
+		for (int i=1; i<argc; i++) // start with 1 to skip executable name
+			args.push_back(string(argv[i]));
+
 		// First convert for convenience the input arg list into
 		// 1/ a (possibly empty) vector of global args / initial options,
 		// 2/ a vector of operator specification, each being itself a vector of strings
 		vector<string> initialOptions;
 		vector<vector<string>> operatorSpecs;
+		splitCommandLine(args, initialOptions, operatorSpecs);
+
+		// Now we have organized our input: do the parsing itself. All the sub-parsers erase the data they consume from the string vectors
+		try {
+			vector<string> batchOptions = initialOptions; // before they are consumed
+			parseGenericOptions(initialOptions);
+			if(batchFileName != "") {
+				batch(batchOptions);
+				return;
+			}
+			buildOperators(initialOptions, operatorSpecs);
+		}catch(std::string &s){
+			std::cerr<<"Error : "<<s<<"\n";
+			//factory->Usage(std::cerr);
+			exit(EXIT_FAILURE);
+		}catch(std::exception &s){
+			std::cerr<<"Exception : "<<s.what()<<"\n";
+			//factory->Usage(std::cerr);
+			exit(EXIT_FAILURE);
+		}
+	}
 
-		vector<string> args;
-		// convert all the char* to strings
-		for (int i=1; i<argc; i++) // start with 1 to skip executable name
-			args.push_back(string(argv[i]));
 
+	void UserInterface::splitCommandLine(vector<string> args, vector<string>& initialOptions, vector<vector<string>>& operatorSpecs) {
 		// Build the global option list
 		initialOptions.push_back("$$initialOptions$$");
 		while(args.size() > 0 // there remains something to parse
@@ -405,89 +489,206 @@ namespace flopoco
 			}
 			operatorSpecs.push_back(opSpec);
 		}
+	}
 
 
-		// Now we have organized our input: do the parsing itself. All the sub-parsers erase the data they consume from the string vectors
-		try {
-			parseGenericOptions(initialOptions);
-			initialOptions.erase(initialOptions.begin());
-			if(initialOptions.size()>0){
-				ostringstream s;
-				s << "Don't know what to do with the following global option(s) :" <<endl ;
-				for (auto i : initialOptions)
-					s << "  "<<i<<" ";
-				s << endl;
-				throw s.str();
+	void UserInterface::buildOperators(vector<string>& initialOptions, vector<vector<string>>& operatorSpecs) {
+		// the initial options may have been parsed already, in which case only the marker remains
+		parseGenericOptions(initialOptions);
+		initialOptions.erase(initialOptions.begin());
+		if(initialOptions.size()>0){
+			ostringstream s;
+			s << "Don't know what to do with the following global option(s) :" <<endl ;
+			for (auto i : initialOptions)
+				s << "  "<<i<<" ";
+			s << endl;
+			throw s.str();
+		}
+
+		bool useOperatorCache = true;
+		for (auto opParams: operatorSpecs) {
+			string opName = opParams[0];
+			std::transform(opName.begin(), opName.end(), opName.begin(), ::tolower);
+			if(opName=="testbench" || opName=="wrapper")
+				useOperatorCache = false;
+		}
+
+		for (auto opParams: operatorSpecs) {
+			string opName = opParams[0];  // operator Name
+			// remove the generic options
+			parseGenericOptions(opParams);
+
+			// build the Target for this operator
+			Target* target;
+			// make this option case-insensitive, too
+			std::transform(targetFPGA.begin(), targetFPGA.end(), targetFPGA.begin(), ::tolower);
+
+				// This could also be a factory but it is less critical
+			if (targetFPGA=="zynq7000")  target=new Zynq7000();
+			//					else if(targetFPGA=="virtex4") target=new Virtex4();
+			//				else if (targetFPGA=="virtex5") target=new Virtex5();
+			else if (targetFPGA=="kintex7") target=new Kintex7();
+			else if (targetFPGA=="virtexultrascaleplus") target=new VirtexUltrascalePlus();
+			else if (targetFPGA=="virtex6") target=new Virtex6();
+			//					else if (targetFPGA=="spartan3") target=new Spartan3();
+			//					else if (targetFPGA=="stratixii" || targetFPGA=="stratix2") target=new StratixII();
+			//					else if (targetFPGA=="stratixiii" || targetFPGA=="stratix3") target=new StratixIII();
+			//				else if (targetFPGA=="stratixiv" || targetFPGA=="stratix4") target=new StratixIV();
+			else if (targetFPGA=="stratixv" || targetFPGA=="stratix5") target=new StratixV();
+			//					else if (targetFPGA=="cycloneii" || targetFPGA=="cyclone2") target=new CycloneII();
+			//					else if (targetFPGA=="cycloneiii" || targetFPGA=="cyclone3") target=new CycloneIII();
+			//					else if (targetFPGA=="cycloneiv" || targetFPGA=="cyclone4") target=new CycloneIV();
+			//				else if (targetFPGA=="cyclonev" || targetFPGA=="cyclone5") target=new CycloneV();
+			else {
+				throw("ERROR: unknown target: " + targetFPGA);
+			}
+			target->setClockEnable(clockEnable);
+			target->setFrequency(1e6*targetFrequencyMHz);
+			target->setUseHardMultipliers(useHardMult);
+			target->setUnusedHardMultThreshold(unusedHardMultThreshold);
+			target->setPlainVHDL(plainVHDL);
+			target->setGenerateFigures(generateFigures);
+			target->setUseCompressorArrays(compressorArrays);
+			target->setUseTableCompression(compressTables);
+			target->setUseTargetOptimizations(useTargetOptimizations);
+			target->setCompressionMethod(compression);
+			target->setILPSolver(ilpSolver);
+			target->setILPTimeout(ilpTimeout);
+			target->setTilingMethod(tiling);
+			target->setCacheDir(cacheDir);
+
+			// Now build the operator
+			OperatorFactoryPtr fp = getFactoryByName(opName);
+			if (fp==NULL){
+				throw( "Can't find the operator factory for " + opName) ;
+			}
+			// Look the operator up in the cache. TestBench and Wrapper need the real operator (for emulate() or its signals),
+			// generateFigures produces files that are not cached, and reportRegisters final report lines that are not cached either.
+			string cacheKey;
+			if(cacheDir!="" && !generateFigures && !reportRegisters && useOperatorCache) {
+				vector<string> options;
+				options.push_back(join("name=", entityName));
+				options.push_back(join("clockEnable=", clockEnable));
+				options.push_back(join("useHardMult=", useHardMult));
+				options.push_back(join("hardMultThreshold=", unusedHardMultThreshold));
+				options.push_back(join("plainVHDL=", plainVHDL));
+				options.push_back(join("useTargetOptimizations=", useTargetOptimizations));
+				options.push_back(join("compression=", compression));
+				options.push_back(join("compressorArrays=", compressorArrays));
+				options.push_back(join("compressTables=", compressTables));
+				options.push_back(join("tiling=", tiling));
+				options.push_back(join("ilpSolver=", ilpSolver));
+				options.push_back(join("ilpTimeout=", ilpTimeout));
+				cacheKey = OperatorCache::keyDescription(opParams, options, target);
+				OperatorPtr cached = OperatorCache::lookup(cacheDir, cacheKey, target);
+				if(cached!=nullptr) {
+					if(verbose>=INFO)
+						cerr << "> Operator cache: " << opName << " found in " << cacheDir << " as " << cached->getName() << endl;
+					entityName="";
+					UserInterface::globalOpList.push_back(cached);
+					continue;
+				}
 			}
 
-			for (auto opParams: operatorSpecs) {
-				string opName = opParams[0];  // operator Name
-				// remove the generic options
-				parseGenericOptions(opParams);
-
-				// build the Target for this operator
-				Target* target;
-				// make this option case-insensitive, too
-				std::transform(targetFPGA.begin(), targetFPGA.end(), targetFPGA.begin(), ::tolower);
-
-					// This could also be a factory but it is less critical
-				if (targetFPGA=="zynq7000")  target=new Zynq7000();
-				//					else if(targetFPGA=="virtex4") target=new Virtex4();
-				//				else if (targetFPGA=="virtex5") target=new Virtex5();
-				else if (targetFPGA=="kintex7") target=new Kintex7();
-				else if (targetFPGA=="virtexultrascaleplus") target=new VirtexUltrascalePlus();
-				else if (targetFPGA=="virtex6") target=new Virtex6();
-				//					else if (targetFPGA=="spartan3") target=new Spartan3();
-				//					else if (targetFPGA=="stratixii" || targetFPGA=="stratix2") target=new StratixII();
-				//					else if (targetFPGA=="stratixiii" || targetFPGA=="stratix3") target=new StratixIII();
-				//				else if (targetFPGA=="stratixiv" || targetFPGA=="stratix4") target=new StratixIV();
-				else if (targetFPGA=="stratixv" || targetFPGA=="stratix5") target=new StratixV();
-				//					else if (targetFPGA=="cycloneii" || targetFPGA=="cyclone2") target=new CycloneII();
-				//					else if (targetFPGA=="cycloneiii" || targetFPGA=="cyclone3") target=new CycloneIII();
-				//					else if (targetFPGA=="cycloneiv" || targetFPGA=="cyclone4") target=new CycloneIV();
-				//				else if (targetFPGA=="cyclonev" || targetFPGA=="cyclone5") target=new CycloneV();
-				else {
-					throw("ERROR: unknown target: " + targetFPGA);
+			// Call the constructor at last (through the factory)
+			OperatorPtr op;
+			size_t globalOpListSize = UserInterface::globalOpList.size(); // the constructor may add shared operators to globalOpList
+			bool userNamed = (entityName!="");
+			{
+				lock_guard<mutex> lock(constructionMutex);
+				op = fp->parseArguments(nullptr, target, opParams);
+			}
+			if(op!=NULL)	{// Some factories don't actually create an operator
+				if(entityName!="") {
+					op->changeName(entityName);
+					entityName="";
+				}
+				UserInterface::globalOpList.push_back(op);
+				// Schedule it
+				op->schedule();
+				op->applySchedule();
+				// Shared operators already in globalOpList would be missing from the entry: only cache the first operator of a command line
+				if(cacheKey!="" && globalOpListSize==0) {
+					vector<OperatorPtr> built(UserInterface::globalOpList.begin()+globalOpListSize, UserInterface::globalOpList.end());
+					OperatorCache::store(cacheDir, cacheKey, built, userNamed);
+				}
+			}
+		}
+	}
+
+
+	void UserInterface::batch(vector<string> initialOptions) {
+		ifstream file(batchFileName.c_str());
+		if(!file.is_open())
+			throw("Can't open the batch file " + batchFileName);
+		vector<string> lines;
+		string line;
+		while(getline(file, line)) {
+			if(line.find_first_not_of(" \t") != string::npos && line[line.find_first_not_of(" \t")] != '#')
+				lines.push_back(line);
+		}
+		file.close();
+
+		vector<string> outputFiles(lines.size());
+		vector<string> errors(lines.size());
+		atomic<size_t> nextLine(0);
+		// Each job works in the generation context of its thread, which it resets for each line
+		auto job = [&]() {
+			size_t i;
+			while((i = nextLine++) < lines.size()) {
+				try {
+					initializeGenericOptions();
+					vector<string> options = initialOptions;
+					parseGenericOptions(options);
+					outputFileName = join("flopoco_", (int)i+1, ".vhdl"); // can be overridden on the line
+					vector<string> args;
+					istringstream words(lines[i]);
+					string word;
+					while(words >> word)
+						args.push_back(word);
+					vector<string> lineOptions;
+					vector<vector<string>> operatorSpecs;
+					splitCommandLine(args, lineOptions, operatorSpecs);
+					buildOperators(lineOptions, operatorSpecs);
+					outputVHDL();
+					outputFiles[i] = outputFileName;
+				}
+				catch(std::string &s) {
+					errors[i] = s;
 				}
-				target->setClockEnable(clockEnable);
-				target->setFrequency(1e6*targetFrequencyMHz);
-				target->setUseHardMultipliers(useHardMult);
-				target->setUnusedHardMultThreshold(unusedHardMultThreshold);
-				target->setPlainVHDL(plainVHDL);
-				target->setGenerateFigures(generateFigures);
-				target->setUseTargetOptimizations(useTargetOptimizations);
-				target->setCompressionMethod(compression);
-				target->setILPSolver(ilpSolver);
-				target->setILPTimeout(ilpTimeout);
-				target->setTilingMethod(tiling);
-
-				// Now build the operator
-				OperatorFactoryPtr fp = getFactoryByName(opName);
-				if (fp==NULL){
-					throw( "Can't find the operator factory for " + opName) ;
+				catch(std::exception &e) {
+					errors[i] = e.what();
 				}
-				// Call the constructor at last (through the factory)
-				OperatorPtr op = fp->parseArguments(nullptr, target, opParams);
-				if(op!=NULL)	{// Some factories don't actually create an operator
-					if(entityName!="") {
-						op->changeName(entityName);
-						entityName="";
-					}
-					UserInterface::globalOpList.push_back(op);
-					// Schedule it
-					op->schedule();
-					op->applySchedule();
+				catch(char const *e) {
+					errors[i] = e;
+				}
+				catch(...) {
+					errors[i] = "unknown exception";
 				}
 			}
-		}catch(std::string &s){
-			std::cerr<<"Error : "<<s<<"\n";
-			//factory->Usage(std::cerr);
-			exit(EXIT_FAILURE);
-		}catch(std::exception &s){
-			std::cerr<<"Exception : "<<s.what()<<"\n";
-			//factory->Usage(std::cerr);
-			exit(EXIT_FAILURE);
+		};
+
+		// the main thread only waits: its own generation context is the one of the batch
+		// With several jobs, the Sollya computations are not forked into workers (see sollyaWorkers())
+		addGenerationThreads(jobs);
+		vector<thread> pool;
+		for(int t=0; t<jobs; t++)
+			pool.push_back(thread(job));
+		for(auto& t: pool)
+			t.join();
+		addGenerationThreads(-jobs);
+
+		int failures=0;
+		for(size_t i=0; i<lines.size(); i++) {
+			if(errors[i] == "")
+				cerr << "Batch line " << i+1 << " (" << lines[i] << "): output to " << outputFiles[i] << endl;
+			else {
+				cerr << "Batch line " << i+1 << " (" << lines[i] << ") failed: " << errors[i] << endl;
+				failures++;
+			}
 		}
+		if(failures > 0)
+			throw(join("", failures) + " line(s) of the batch failed");
 	}
 
 	void UserInterface::drawDotDiagram(vector<OperatorPtr> & oplist) {
@@ -778,12 +979,19 @@ namespace flopoco
 		s << "  " << COLOR_BOLD << "useTargetOptimizations" << COLOR_NORMAL << "=<0|1>: use target specific optimizations (e.g., using primitives) " << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL<<endl;
 		s << "  " << COLOR_BOLD << "ilpSolver" << COLOR_NORMAL << "=<string>:           override ILP solver for operators optimized by ILP, has to match a solver name known by the ScaLP library" << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL<<endl;
 		s << "  " << COLOR_BOLD << "ilpTimeout" << COLOR_NORMAL << "=<int>:             sets the timeout in seconds for the ILP solver for operators optimized by ILP (default=3600)" << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL<<endl;
-		s << "  " << COLOR_BOLD << "compression" << COLOR_NORMAL << "=<heuristicMaxEff,heuristicPA,heuristicFirstFit,optimal,optimalMinStages>:        compression method (default=heuristicMaxEff)" << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL<<endl;
+		s << "  " << COLOR_BOLD << "compression" << COLOR_NORMAL << "=<heuristicMaxEff,heuristicPA,heuristicFirstFit,heuristicTimingDriven,optimal,optimalMinStages>:        compression method (default=heuristicMaxEff)" << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL<<endl;
 		s << "  " << COLOR_BOLD << "tiling" << COLOR_NORMAL << "=<heuristicBasicTiling,optimal,heuristicGreedyTiling,heuristicXGreedyTiling,heuristicBeamSearchTiling>:        tiling method (default=heuristicBasicTiling)" << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL<<endl;
         s << "  " << COLOR_BOLD << "hardMultThreshold" << COLOR_NORMAL << "=<float>: unused hard mult threshold (O..1, default 0.7) " << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL<<endl;
 		s << "  " << COLOR_BOLD << "generateFigures" << COLOR_NORMAL << "=<0|1>:generate SVG graphics (default off) " << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL << endl;
+		s << "  " << COLOR_BOLD << "compressorArrays" << COLOR_NORMAL << "=<0|1>:       generate the same compressors of a bitheap stage as one array instance, for smaller VHDL (default off) " << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL << endl;
+		s << "  " << COLOR_BOLD << "compressTables" << COLOR_NORMAL << "=<0|1>:         decompose the logic tables into smaller tables when it saves LUTs (default on) " << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL << endl;
 		s << "  " << COLOR_BOLD << "verbose" << COLOR_NORMAL << "=<int>:        verbosity level (0-4, default=1)" << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL<<endl;
 		s << "  " << COLOR_BOLD << "dependencyGraph" << COLOR_NORMAL << "=<no|compact|full>: generate data dependence drawing of the Operator (default no) " << COLOR_RED_NORMAL << COLOR_NORMAL<<endl;
+		s << "  " << COLOR_BOLD << "profileSchedule" << COLOR_NORMAL << "=<0|1>:    report the number of signals visited by each call to the scheduler (default 0) " << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL<<endl;
+		s << "  " << COLOR_BOLD << "reportRegisters" << COLOR_NORMAL << "=<0|1>:    report the bits registered in the compressor trees of the bitheaps (default 0) " << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL<<endl;
+		s << "  " << COLOR_BOLD << "batch" << COLOR_NORMAL << "=<string>:               batch mode: each line of this file is a command line (options and operators), output to its own file (default flopoco_<line>.vhdl)" << COLOR_NORMAL<<endl;
+		s << "  " << COLOR_BOLD << "jobs" << COLOR_NORMAL << "=<int>:                   number of lines of the batch built in parallel (default 1; above 1, the Sollya computations of each line are sequential)" << COLOR_NORMAL<<endl;
+		s << "  " << COLOR_BOLD << "cacheDir" << COLOR_NORMAL << "=<string>:            directory of a persistent cache of the generated operators, multiplier tilings and function approximations, shared by successive runs (default none) " << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL<<endl;
 		s << "Sticky options apply to the rest of the command line, unless changed again" <<endl;
 		s <<endl;
 		s <<  COLOR_BOLD << "List of operators with command-line interface"<< COLOR_NORMAL << " (a few more are hidden inside FloPoCo)" <<endl;
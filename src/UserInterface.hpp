@@ -49,11 +49,26 @@ namespace flopoco
 		/**  main initialization function */
 		static	void initialize();
 
+		/** reset the generation context of the calling thread: generic options to their default values, empty globalOpList */
+		static void initializeGenericOptions();
+
 		static void registerFactories();
 		
 		/** parse all the operators passed on the command-line */
 		static void buildAll(int argc, char* argv[]);
 
+		/** split a command line into the initial generic options and the operator specifications */
+		static void splitCommandLine(vector<string> args, vector<string>& initialOptions, vector<vector<string>>& operatorSpecs);
+
+		/** build the operators of a command line, already split by splitCommandLine(), and add them to globalOpList.
+				Errors are thrown as strings. */
+		static void buildOperators(vector<string>& initialOptions, vector<vector<string>>& operatorSpecs);
+
+		/** Batch mode: each line of batchFileName is a command line, built into its own VHDL file.
+				The lines are independent generations, built by a pool of jobs threads.
+				\param initialOptions the generic options of the flopoco command line, applied before those of each line */
+		static void batch(vector<string> initialOptions);
+
 		/** starts the dot diagram plotter on the operators */
 		static void drawDotDiagram(vector<OperatorPtr> &oplist);
 
@@ -119,10 +134,10 @@ namespace flopoco
 		static void popGlobalOpList();
 
 		/** generates the code for operators in globalOpList, and all their subcomponents */
-		static void outputVHDLToFile(ofstream& file);
+		static void outputVHDLToFile(ostream& file);
 
 		/** generates the code for operators in oplist, and all their subcomponents */
-		static void outputVHDLToFile(vector<OperatorPtr> &oplist, ofstream& file, set<string> &alreadyOutput);
+		static void outputVHDLToFile(vector<OperatorPtr> &oplist, ostream& file, set<string> &alreadyOutput);
 
 	private:
 		/** register a factory */
@@ -140,30 +155,39 @@ namespace flopoco
 		static void buildAutocomplete();
 
 	public:
-		static vector<OperatorPtr>  globalOpList;  /**< Level-0 operators. Each of these can have sub-operators */
-		static vector<vector<OperatorPtr>>  globalOpListStack;  /**< a stack on which to save globalOpList when you don't want to mess with it */
-		static int    verbose;
-		static int pipelineActive_;
+		// The generation context: these are thread_local, so that independent operators can be generated in parallel threads (see batch())
+		static thread_local vector<OperatorPtr>  globalOpList;  /**< Level-0 operators. Each of these can have sub-operators */
+		static thread_local vector<vector<OperatorPtr>>  globalOpListStack;  /**< a stack on which to save globalOpList when you don't want to mess with it */
+		static thread_local int    verbose;
+		static thread_local int pipelineActive_;
+		static thread_local bool   profileSchedule; /**< if true, Operator::schedule() reports the number of signals visited by each call */
+		static thread_local bool   reportRegisters; /**< if true, the compression strategies report the bits registered in the compressor trees */
+		static thread_local string cacheDir;      /**< if not empty, the directory of the OperatorCache, the TilingCache and the ApproximationCache */
 	private:
-		static string outputFileName;
-		static string entityName;
-		static string targetFPGA;
-		static double targetFrequencyMHz;
-		static bool   pipeline;
-		static bool   clockEnable;
-		static bool   useHardMult;
-		static bool   plainVHDL;
-		static bool   generateFigures;
-		static double unusedHardMultThreshold;
-        static bool   useTargetOptimizations;
-		static string compression;
-		static string tiling;
-		static string ilpSolver;
-		static int    ilpTimeout;
-		static int    resourceEstimation;
-		static bool   floorplanning;
-		static bool   reDebug;
-		static bool   flpDebug;
+		static thread_local string outputFileName;
+		static thread_local string entityName;
+		static thread_local string targetFPGA;
+		static thread_local double targetFrequencyMHz;
+		static thread_local bool   pipeline;
+		static thread_local bool   clockEnable;
+		static thread_local bool   useHardMult;
+		static thread_local bool   plainVHDL;
+		static thread_local bool   generateFigures;
+		static thread_local bool   compressorArrays; /**< if true, group the compressors of the bitheaps into arrays in the VHDL */
+		static thread_local bool   compressTables;   /**< if true, decompose the logic tables into smaller tables when it saves LUTs */
+		static thread_local double unusedHardMultThreshold;
+		static thread_local bool   useTargetOptimizations;
+		static thread_local string compression;
+		static thread_local string tiling;
+		static thread_local string ilpSolver;
+		static thread_local int    ilpTimeout;
+		static thread_local int    resourceEstimation;
+		static thread_local bool   floorplanning;
+		static thread_local bool   reDebug;
+		static thread_local bool   flpDebug;
+		static thread_local string batchFileName; /**< if not empty, run in batch mode on the command lines of this file */
+		static thread_local int    jobs;          /**< the number of threads of the batch mode */
+		// End of the generation context: the following are shared by all the threads
 		static vector<pair<string,OperatorFactoryPtr>> factoryList; // used to be a map, but I don't want them listed in alphabetical order
 		static const vector<pair<string,string>> categories;
 
@@ -171,7 +195,7 @@ namespace flopoco
 		static const vector<string> special_targets;
 		static const vector<option_t> options;
 
-		static string depGraphDrawing;
+		static thread_local string depGraphDrawing;
 	};
 
 	/** This is the abstract class that each operator factory will inherit.
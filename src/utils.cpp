@@ -31,17 +31,26 @@ using namespace std;
 
 namespace flopoco{
 	/** Initialization of FloPoCoRandomState state */
-	gmp_randstate_t FloPoCoRandomState::m_state;
+	thread_local gmp_randstate_t FloPoCoRandomState::m_state;
 	
-	bool FloPoCoRandomState::isInit_ = false;
+	thread_local bool FloPoCoRandomState::isInit_ = false;
 	
 	void FloPoCoRandomState::init(int n, bool force) {
 		// if isInit_ is set, we do not initialize the random state again
 			if (isInit_ && !force) return;
+			if (isInit_) gmp_randclear(m_state);
 			gmp_randinit_mt(m_state);
 			gmp_randseed_ui(m_state,n);
 			isInit_ = true;
 	};
+
+	void FloPoCoRandomState::initStream(int n, int stream) {
+			if (isInit_) gmp_randclear(m_state);
+			gmp_randinit_mt(m_state);
+			mpz_class seed = (mpz_class(n) << 32) + stream;
+			gmp_randseed(m_state, seed.get_mpz_t());
+			isInit_ = true;
+	};
 	
 	//gmp_randstate_t* FloPoCoRandomState::getState() { return m_state;};
 
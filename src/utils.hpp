@@ -188,13 +188,14 @@ namespace flopoco{
 			 * 	the first call to init, and then will trigger a quick return of init
 			 * 	without a new complete initialization of the random state
 			 **/
-			static bool isInit_;
+			static thread_local bool isInit_;
 
 		public:
 			/**
-			 * public value to store currend gmp random state
+			 * public value to store currend gmp random state.
+			 * Each thread owns its own state, so that test cases may be generated concurrently
 			 */
-			static gmp_randstate_t m_state;
+			static thread_local gmp_randstate_t m_state;
 
 
 			/**
@@ -204,6 +205,15 @@ namespace flopoco{
 			 * @param force  if set will not consider the isInit_ flag
 			 */
 			static void init(int n, bool force = true);
+
+			/**
+			 * static public function to initialize the random generator of the calling
+			 * thread on one of several independent streams derived from n.
+			 * A given (n, stream) pair always produces the same sequence, whichever thread uses it.
+			 * @param n the integer used to generate the seed
+			 * @param stream the index of the stream
+			 */
+			static void initStream(int n, int stream);
 	};
 
 	/** Returns under the form of a string of given size, the unsigned binary representation of an integer.
@@ -0,0 +1,156 @@
+/*
+  Micro-benchmark of the compressor tree search of MaxEfficiencyCompressionStrategy.
+
+  Runs the search on the bit counts of a 128-column bit heap (or the first argument)
+  shaped like the partial products of a square multiplier, a number of times (20 by default, or the second argument).
+  It times the current search, and the exhaustive rescan it replaced, and checks that both place the same compressors.
+
+  Usage: MaxEfficiencyCompressionBench [columns] [repetitions]
+
+  This file is part of the FloPoCo project
+*/
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+
+#include "Operator.hpp"
+#include "Targets/Kintex7.hpp"
+#include "BitHeap/BitHeap.hpp"
+#include "BitHeap/MaxEfficiencyCompressionStrategy.hpp"
+
+using namespace std;
+using namespace flopoco;
+
+static double elapsedMs(chrono::steady_clock::time_point start) {
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+
+class BenchmarkedStrategy : public MaxEfficiencyCompressionStrategy {
+public:
+	BenchmarkedStrategy(BitHeap* bitheap) : MaxEfficiencyCompressionStrategy(bitheap) {
+		orderCompressorsByCompressionEfficiency();
+	}
+
+	void reset(vector<int> heights) {
+		bitAmount.assign(1, heights);
+		solution = BitHeapSolution();
+		solution.setSolutionStatus(BitheapSolutionStatus::HEURISTIC_PARTIAL);
+	}
+
+	void runCurrent() {
+		maxEfficiencyAlgorithm();
+	}
+
+	/* The search before the efficiencies were cached: every compressor against every column, for each placement */
+	void runExhaustive() {
+		unsigned int s = 0;
+		while(!checkAlgorithmReachedAdder(2, s)) {
+			while(bitAmount.size() <= s + 1) {
+				bitAmount.resize(bitAmount.size() + 1);
+				bitAmount[bitAmount.size() - 1].resize(bitAmount[bitAmount.size() - 2].size(), 0);
+			}
+			bool found = true;
+			while(found) {
+				found = false;
+				double achievedEfficiencyBest = -1.0;
+				BasicCompressor* compressor = nullptr;
+				unsigned int column = 0;
+				for(unsigned int e = 0; e < possibleCompressors.size(); e++) {
+					BasicCompressor* currentCompressor = possibleCompressors[e];
+					vector<bool> used(bitAmount[s].size(), false);
+					unsigned int columnsAlreadyChecked = 0;
+					while(columnsAlreadyChecked < bitAmount[s].size() && !((found == true) && currentCompressor->getEfficiency() - achievedEfficiencyBest < 0.0001)) {
+						unsigned int currentMaxColumn = 0;
+						int currentSize = 0;
+						for(unsigned int c = 0; c < bitAmount[s].size(); c++) {
+							if(!used[c] && bitAmount[s][c] > currentSize) {
+								currentMaxColumn = c;
+								currentSize = bitAmount[s][c];
+							}
+						}
+						used[currentMaxColumn] = true;
+						double achievedEfficiencyCurrent = getCompressionEfficiency(s, currentMaxColumn, currentCompressor);
+						float lowerBound = (s < lowerBounds.size() ? lowerBounds[s] : 0.0);
+						if(achievedEfficiencyCurrent > (achievedEfficiencyBest + 0.0001) && achievedEfficiencyCurrent > (lowerBound - 0.0001)) {
+							achievedEfficiencyBest = achievedEfficiencyCurrent;
+							compressor = currentCompressor;
+							found = true;
+							column = currentMaxColumn;
+						}
+						columnsAlreadyChecked++;
+					}
+				}
+				if(found)
+					placeCompressor(s, column, compressor);
+			}
+			for(unsigned int c = 0; c < bitAmount[s].size(); c++) {
+				if(bitAmount[s][c] > 0) {
+					bitAmount[s + 1][c] += bitAmount[s][c];
+					bitAmount[s][c] = 0;
+				}
+				solution.setEmptyInputsByRemainingBits(s, bitAmount[s]);
+			}
+			s++;
+		}
+	}
+
+	/* The compressors of the solution, stage by stage and column by column */
+	string describeSolution() {
+		ostringstream o;
+		for(unsigned int s = 0; s < bitAmount.size(); s++) {
+			o << "stage " << s << ":";
+			for(unsigned int c = 0; c < bitAmount[s].size(); c++) {
+				for(auto p: solution.getCompressorsAtPosition(s, c))
+					o << " " << c << p.first->getStringOfIO();
+			}
+			o << endl;
+		}
+		return o.str();
+	}
+};
+
+
+int main(int argc, char* argv[]) {
+	int columns = (argc > 1 ? atoi(argv[1]) : 128);
+	int repetitions = (argc > 2 ? atoi(argv[2]) : 20);
+
+	Target* target = new Kintex7();
+	Operator* op = new Operator(nullptr, target);
+	op->setName("SyntheticOperator");
+	BitHeap* bitheap = new BitHeap(op, columns);
+	BenchmarkedStrategy strategy(bitheap);
+
+	// the column heights of the partial products of a (columns/2)x(columns/2) multiplier
+	vector<int> heights(columns);
+	for(int c = 0; c < columns; c++)
+		heights[c] = std::min(c + 1, columns - c);
+
+	string current, exhaustive;
+
+	auto start = chrono::steady_clock::now();
+	for(int i = 0; i < repetitions; i++) {
+		strategy.reset(heights);
+		strategy.runCurrent();
+	}
+	double currentMs = elapsedMs(start) / repetitions;
+	current = strategy.describeSolution();
+
+	start = chrono::steady_clock::now();
+	for(int i = 0; i < repetitions; i++) {
+		strategy.reset(heights);
+		strategy.runExhaustive();
+	}
+	double exhaustiveMs = elapsedMs(start) / repetitions;
+	exhaustive = strategy.describeSolution();
+
+	cout << "maxEfficiency search on " << columns << " columns: " << currentMs << " ms (exhaustive rescan: " << exhaustiveMs << " ms)" << endl;
+
+	if(current != exhaustive) {
+		cerr << "Error: the compressor trees differ" << endl << "current:" << endl << current << "exhaustive:" << endl << exhaustive;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,68 @@
+/*
+  Micro-benchmark of the name lookups of Operator.
+
+  Builds a synthetic operator with many sub-components and signals (10000 by default,
+  or the first argument), then times their creation and their lookup by name.
+
+  Usage: SubComponentLookupBench [n]
+
+  This file is part of the FloPoCo project
+*/
+
+#include <chrono>
+#include <iostream>
+#include <cstdlib>
+
+#include "Operator.hpp"
+#include "Targets/Kintex7.hpp"
+#include "utils.hpp"
+
+using namespace std;
+using namespace flopoco;
+
+static double elapsedMs(chrono::steady_clock::time_point start) {
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+	int n = (argc > 1 ? atoi(argv[1]) : 10000);
+
+	Target* target = new Kintex7();
+	Operator* op = new Operator(nullptr, target);
+	op->setName("SyntheticOperator");
+
+	auto start = chrono::steady_clock::now();
+	for(int i=0; i<n; i++) {
+		Operator* subop = new Operator(op, target);
+		subop->setName(join("SubComponent_", i));
+		op->addSubComponent(subop);
+	}
+	cout << "addSubComponent: " << n << " sub-components in " << elapsedMs(start) << " ms" << endl;
+
+	start = chrono::steady_clock::now();
+	for(int i=0; i<n; i++) {
+		op->declare(join("S_", i), 8);
+	}
+	cout << "declare:         " << n << " signals in " << elapsedMs(start) << " ms" << endl;
+
+	start = chrono::steady_clock::now();
+	int found = 0;
+	for(int i=0; i<n; i++) {
+		if(op->getSubComponent(join("SubComponent_", n-1-i)) != nullptr)
+			found++;
+	}
+	cout << "getSubComponent: " << n << " lookups in " << elapsedMs(start) << " ms" << endl;
+
+	start = chrono::steady_clock::now();
+	for(int i=0; i<n; i++) {
+		if(op->getSignalByName(join("S_", n-1-i) + "(0)") != nullptr)
+			found++;
+	}
+	cout << "getSignalByName: " << n << " lookups in " << elapsedMs(start) << " ms" << endl;
+
+	if(found != 2*n) {
+		cerr << "Error: " << 2*n-found << " names not found" << endl;
+		return 1;
+	}
+	return 0;
+}
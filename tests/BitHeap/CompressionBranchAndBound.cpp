@@ -0,0 +1,197 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE CompressionBranchAndBoundTest
+
+/*
+  Tests of the exact solver of OptimalCompressionStrategy without ScaLP (CompressionBranchAndBound):
+  its area must be the one of an exhaustive enumeration of the compressor trees
+
+  This file is part of the FloPoCo project
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <map>
+#include <random>
+#include <limits>
+
+#include "BitHeap/CompressionBranchAndBound.hpp"
+
+using namespace std;
+using namespace flopoco;
+
+// The compressors of CompressionStrategy::generatePossibleCompressors(), and the flipflop of OptimalCompressionStrategy::addFlipFlop()
+static vector<BasicCompressor*> compressors()
+{
+	vector<vector<int> > heights = {{6}, {4, 1}, {5}, {3, 1}, {4}, {3, 2}, {3}, {1}};
+	vector<float> areas = {3.0, 2.0, 2.0, 2.0, 2.0, 2.0, 1.0, 0.5};
+	vector<BasicCompressor*> r;
+	for(unsigned int i = 0; i < heights.size(); i++)
+		r.push_back(new BasicCompressor(nullptr, nullptr, heights[i], areas[i], "combinatorial", true));
+	return r;
+}
+
+
+// Bit vectors and the minimal area to obtain them
+typedef map<vector<int>, double> Outcomes;
+
+// Removes the outcomes that have at least the bits and the area of another one: fewer bits are never harder to compress
+static void removeDominated(Outcomes &outcomes)
+{
+	Outcomes r;
+	for(auto &a : outcomes) {
+		bool dominated = false;
+		for(auto &b : outcomes) {
+			if(&a == &b || b.second > a.second)
+				continue;
+			bool noMore = true;
+			for(unsigned int i = 0; i < a.first.size() && noMore; i++)
+				noMore = (b.first[i] <= a.first[i]);
+			// of two equal outcomes, the first one is kept
+			dominated = noMore && (b.second < a.second || b.first != a.first);
+			if(dominated)
+				break;
+		}
+		if(!dominated)
+			r.insert(a);
+	}
+	outcomes = r;
+}
+
+
+// Every set of compressors that cover the bits of a stage, including those placed in a column only to cover higher columns:
+// returns the bits output to the next stage and the minimal area to obtain them
+static Outcomes stageOutcomes(const vector<int> &bits, const vector<BasicCompressor*> &comps)
+{
+	unsigned int columns = bits.size();
+	// the bits not yet covered, then the bits output
+	Outcomes states;
+	vector<int> initial = bits;
+	initial.resize(2 * columns, 0);
+	states[initial] = 0.0;
+	for(unsigned int c = 0; c < columns; c++) {
+		Outcomes todo = states, next, done = states;
+		while(!todo.empty()) {
+			auto state = *todo.begin();
+			todo.erase(todo.begin());
+			if(state.first[c] == 0) {
+				auto it = next.find(state.first);
+				if(it == next.end() || it->second > state.second)
+					next[state.first] = state.second;
+			}
+			for(auto bc : comps) {
+				// a compressor that covers no bit is useless
+				bool covers = false;
+				vector<int> s = state.first;
+				for(unsigned int j = 0; j < bc->getHeights() && c + j < columns; j++) {
+					covers = covers || ((int)bc->getHeightsAtColumn(j) > 0 && s[c + j] > 0);
+					s[c + j] = std::max(0, s[c + j] - (int)bc->getHeightsAtColumn(j));
+				}
+				if(!covers)
+					continue;
+				for(unsigned int j = 0; j < bc->getOutHeights() && c + j < columns; j++)
+					s[columns + c + j] += bc->getOutHeightsAtColumn(j);
+				double area = state.second + bc->area;
+				auto it = done.find(s);
+				if(it != done.end() && it->second <= area)
+					continue;
+				done[s] = area;
+				todo[s] = area;
+			}
+		}
+		removeDominated(next);
+		states = next;
+	}
+	Outcomes r;
+	for(auto &state : states) {
+		vector<int> outputs(state.first.begin() + columns, state.first.end());
+		auto it = r.find(outputs);
+		if(it == r.end() || it->second > state.second)
+			r[outputs] = state.second;
+	}
+	removeDominated(r);
+	return r;
+}
+
+
+// The minimal area of a compressor tree, stage by stage, as solved by CompressionBranchAndBound::solve()
+static double exhaustiveArea(const vector<vector<int> > &bitAmount, unsigned int lastStage, bool exactStages, const vector<BasicCompressor*> &comps)
+{
+	unsigned int columns = bitAmount[0].size();
+	unsigned int lastArrival = 0;
+	for(unsigned int s = 0; s < bitAmount.size(); s++)
+		for(unsigned int c = 0; c < columns; c++)
+			if(bitAmount[s][c] > 0)
+				lastArrival = s;
+
+	double best = numeric_limits<double>::infinity();
+	Outcomes stage;
+	stage[bitAmount[0]] = 0.0;
+	for(unsigned int s = 0; s <= lastStage && !stage.empty(); s++) {
+		Outcomes next;
+		for(auto &bits : stage) {
+			bool canBeFinal = (lastArrival <= s);
+			for(unsigned int c = 0; c < columns; c++)
+				canBeFinal = canBeFinal && bits.first[c] <= 2;
+			if(canBeFinal && (!exactStages || s == lastStage)) {
+				best = std::min(best, bits.second);
+				continue;
+			}
+			if(s == lastStage)
+				continue;
+			for(auto &outcome : stageOutcomes(bits.first, comps)) {
+				vector<int> b = outcome.first;
+				for(unsigned int c = 0; c < columns; c++)
+					b[c] += (s + 1 < bitAmount.size() ? bitAmount[s + 1][c] : 0);
+				double area = bits.second + outcome.second;
+				auto it = next.find(b);
+				if(it == next.end() || it->second > area)
+					next[b] = area;
+			}
+		}
+		removeDominated(next);
+		stage = next;
+	}
+	return best;
+}
+
+
+static void checkArea(const vector<vector<int> > &bitAmount, unsigned int lastStage, bool exactStages)
+{
+	vector<BasicCompressor*> comps = compressors();
+	CompressionBranchAndBound solver(bitAmount, comps, comps.back());
+	bool found = solver.solve(lastStage, exactStages, 0);
+	BOOST_REQUIRE(solver.isComplete());
+	double expected = exhaustiveArea(bitAmount, lastStage, exactStages, comps);
+	BOOST_CHECK_EQUAL(found, expected != numeric_limits<double>::infinity());
+	if(found)
+		BOOST_CHECK_CLOSE(solver.getArea(), expected, 1e-6);
+	for(auto bc : comps)
+		delete bc;
+}
+
+
+// The bit heap of a small multiplier, with room for the carries
+BOOST_AUTO_TEST_CASE(TEST_Multiplier)
+{
+	vector<vector<int> > bitAmount = {{1, 2, 3, 4, 3, 2, 1, 0, 0}};
+	for(unsigned int stages = 1; stages <= 3; stages++) {
+		checkArea(bitAmount, stages, false);
+		checkArea(bitAmount, stages, true);
+	}
+}
+
+
+// Random bit heaps, with bits arriving in the first two stages
+BOOST_AUTO_TEST_CASE(TEST_Random)
+{
+	mt19937 g(1);
+	for(int i = 0; i < 40; i++) {
+		unsigned int columns = 2 + g() % 3;
+		vector<vector<int> > bitAmount(2, vector<int>(columns + 3, 0));
+		for(unsigned int c = 0; c < columns; c++) {
+			bitAmount[0][c] = g() % 8;
+			bitAmount[1][c] = (i % 2 == 0 ? 0 : g() % 3);
+		}
+		unsigned int stages = 1 + g() % 3;
+		checkArea(bitAmount, stages, i % 4 >= 2);
+	}
+}
@@ -0,0 +1,55 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE TilingCacheTest
+
+/*
+  Tests of the cache of the multiplier tilings (TilingCache): a tiling must only be replayed for the options it was computed with
+
+  This file is part of the FloPoCo project
+*/
+
+#include <boost/test/unit_test.hpp>
+
+#include "IntMult/IntMultiplier.hpp"
+#include "IntMult/TilingCache.hpp"
+#include "IntMult/BaseMultiplierCollection.hpp"
+#include "Targets/Kintex7.hpp"
+
+using namespace std;
+using namespace flopoco;
+
+// The key of a 3x3 multiplier tiled by the greedy heuristic, as IntMultiplier computes it
+static string tilingKey(Target* target, MultiplierTileCollection& tiles, bool use2xk)
+{
+	vector<string> options = IntMultiplier::tilingOptions(target, 0.0, 0, false, use2xk, false, true, false, false, 0);
+	return TilingCache::keyDescription(3, 3, 6, false, "heuristicGreedyTiling", options, tiles, target);
+}
+
+
+// A 3x3 multiplier has no 2xk tile (they start at 4 bits): the tile lists are the same, but not the keys
+BOOST_AUTO_TEST_CASE(TEST_Use2xkNotShared)
+{
+	Target* target = new Kintex7();
+	BaseMultiplierCollection bmc(target);
+	MultiplierTileCollection without2xk(target, &bmc, 3, 3, false, false, false, true, false, false);
+	MultiplierTileCollection with2xk(target, &bmc, 3, 3, false, true, false, true, false, false);
+	BOOST_REQUIRE_EQUAL(without2xk.MultTileCollection.size(), with2xk.MultTileCollection.size());
+
+	string keyWithout = tilingKey(target, without2xk, false);
+	string keyWith = tilingKey(target, with2xk, true);
+	BOOST_CHECK(keyWithout != keyWith);
+
+	// a tiling stored with use2xk is not replayed without it
+	BaseMultiplierCategory* lut = nullptr;
+	for(auto t: with2xk.MultTileCollection)
+		if(t->getType() == "BaseMultiplierLUT_3x3")
+			lut = t;
+	BOOST_REQUIRE(lut != nullptr);
+	list<TilingStrategy::mult_tile_t> tiling;
+	tiling.push_back(make_pair(lut->parametrize(3, 3, false, false), make_pair(0, 0)));
+	TilingCache::store(keyWith, with2xk, target, tiling);
+
+	list<TilingStrategy::mult_tile_t> found;
+	BOOST_CHECK(!TilingCache::lookup(keyWithout, without2xk, target, found));
+	BOOST_CHECK(TilingCache::lookup(keyWith, with2xk, target, found));
+	BOOST_CHECK_EQUAL(found.size(), 1);
+}
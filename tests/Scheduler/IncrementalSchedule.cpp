@@ -0,0 +1,82 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE IncrementalScheduleTest
+
+/*
+  Tests of the incremental scheduler of Operator (Operator::schedule())
+
+  This file is part of the FloPoCo project
+*/
+
+#include <boost/test/unit_test.hpp>
+
+#include "Operator.hpp"
+#include "Targets/Kintex7.hpp"
+
+using namespace std;
+using namespace flopoco;
+
+// A subcomponent with one internal signal between its input and its output
+class PassThrough : public Operator {
+public:
+	PassThrough(OperatorPtr parentOp, Target* target) : Operator(parentOp, target) {
+		setName("PassThrough");
+		addInput("X", 8);
+		addOutput("Y", 8);
+		vhdl << tab << declare("T", 8) << " <= not X;" << endl;
+		vhdl << tab << "Y <= T;" << endl;
+	}
+};
+
+
+// The input port of the subcomponent is connected to a signal of the parent that the scheduler has already scheduled:
+// it has no other predecessor, so only the new edge can release it.
+BOOST_AUTO_TEST_CASE(TEST_SubcomponentAfterScheduledDriver)
+{
+	Target* target = new Kintex7();
+	Operator* op = new Operator(nullptr, target);
+	op->setName("Parent");
+	op->addInput("X", 8);
+	op->vhdl << tab << op->declare("A", 8) << " <= X;" << endl;
+	op->schedule();
+	BOOST_REQUIRE(op->getSignalByName("A")->hasBeenScheduled());
+
+	op->inPortMap("X", "A");
+	op->outPortMap("Y", "B");
+	Operator* subop = new PassThrough(op, target);
+	op->vhdl << op->instance(subop, "inst", false);
+	op->addOutput("R", 8);
+	op->vhdl << tab << "R <= B;" << endl;
+	op->schedule();
+
+	BOOST_CHECK(subop->getSignalByName("X")->hasBeenScheduled());
+	BOOST_CHECK(subop->getSignalByName("T")->hasBeenScheduled());
+	BOOST_CHECK(subop->getSignalByName("Y")->hasBeenScheduled());
+	BOOST_CHECK(op->getSignalByName("B")->hasBeenScheduled());
+	BOOST_CHECK(op->getSignalByName("R")->hasBeenScheduled());
+}
+
+
+// A signal marked as scheduled outside schedule() (as the bit heap does) releases its successors at the next call.
+BOOST_AUTO_TEST_CASE(TEST_ScheduledOutsideScheduler)
+{
+	Target* target = new Kintex7();
+	Operator* op = new Operator(nullptr, target);
+	op->setName("ScheduledOutside");
+	// E and G wait for each other, so the scheduler cannot schedule them; F only waits for E
+	op->vhdl << tab << op->declare("E", 8) << " <= G;" << endl;
+	op->vhdl << tab << op->declare("G", 8) << " <= E;" << endl;
+	op->vhdl << tab << op->declare("F", 8) << " <= E;" << endl;
+	op->schedule();
+
+	Signal* e = op->getSignalByName("E");
+	Signal* f = op->getSignalByName("F");
+	BOOST_REQUIRE(!e->hasBeenScheduled());
+	BOOST_REQUIRE(!f->hasBeenScheduled());
+
+	e->setCycle(0);
+	e->setCriticalPath(0.0);
+	e->setHasBeenScheduled(true);
+	op->schedule();
+	BOOST_CHECK(f->hasBeenScheduled());
+	BOOST_CHECK(op->getSignalByName("G")->hasBeenScheduled());
+}
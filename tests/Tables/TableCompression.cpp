@@ -0,0 +1,131 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE TableCompressionTest
+
+/*
+  Tests of the decomposition of logic tables (TableCompression): each one must rebuild the table exactly
+
+  This file is part of the FloPoCo project
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <random>
+
+#include "TableCompression.hpp"
+#include "Targets/Kintex7.hpp"
+
+using namespace std;
+using namespace flopoco;
+
+// A table rebuilt as Table::emitTable() does, from its tabulated columns, the copies and the constants
+static vector<uint64_t> rebuildColumns(const vector<uint64_t> &v, int w)
+{
+	vector<int> columns = TableCompression::sharedColumns(v, w);
+	vector<uint64_t> r(v.size(), 0);
+	for(size_t i=0; i<v.size(); i++) {
+		for(int j=0; j<w; j++) {
+			BOOST_REQUIRE(columns[j] < 0 || columns[j] <= j);
+			uint64_t bit = (columns[j] == -2 ? 1 : columns[j] == -1 ? 0 : (v[i] >> columns[j]) & 1);
+			r[i] |= bit << j;
+		}
+	}
+	return r;
+}
+
+
+// Checks that the decomposition of T rebuilds it exactly, and returns its kind
+static TableCompression::Kind checkDecomposition(const vector<uint64_t> &t, int wIn, int wOut)
+{
+	Kintex7 target;
+	TableCompression c(&target, t, wIn, wOut);
+	BOOST_CHECK(c.cost <= c.plainCost);
+	if(c.kind == TableCompression::plain) {
+		BOOST_CHECK(rebuildColumns(t, wOut) == t);
+		return c.kind;
+	}
+
+	BOOST_REQUIRE_EQUAL(c.high.size(), t.size() >> c.s);
+	BOOST_REQUIRE_EQUAL(c.low.size(), t.size());
+	BOOST_CHECK_EQUAL(c.wHigh, wOut - c.highLSB);
+	vector<uint64_t> high = rebuildColumns(c.high, c.wHigh);
+	vector<uint64_t> low = rebuildColumns(c.low, c.wLow);
+	uint64_t mask = (wOut == 64 ? ~uint64_t(0) : (uint64_t(1) << wOut) - 1);
+	for(size_t i=0; i<t.size(); i++) {
+		BOOST_REQUIRE(c.wHigh == 64 || (high[i >> c.s] >> c.wHigh) == 0);
+		BOOST_REQUIRE(c.wLow == 64 || (low[i] >> c.wLow) == 0);
+		uint64_t r;
+		if(c.kind == TableCompression::split)
+			r = (high[i >> c.s] << c.highLSB) | low[i];
+		else
+			r = ((high[i >> c.s] << c.highLSB) + low[i]) & mask;
+		BOOST_REQUIRE_EQUAL(r, t[i]);
+	}
+	return c.kind;
+}
+
+
+// The 4 high output bits only depend on the 4 input MSBs
+BOOST_AUTO_TEST_CASE(TEST_Split)
+{
+	mt19937_64 g(1);
+	int wIn=8, wOut=12;
+	vector<uint64_t> t(1 << wIn);
+	for(size_t i=0; i<t.size(); i++)
+		t[i] = ((((i >> 4) * 13) & 0xF) << 8) | (g() & 0xFF);
+	BOOST_CHECK_EQUAL(checkDecomposition(t, wIn, wOut), TableCompression::split);
+}
+
+
+// A smooth monotonic function, as the TIV of a multipartite table
+BOOST_AUTO_TEST_CASE(TEST_Differential)
+{
+	int wIn=10, wOut=12;
+	vector<uint64_t> t(1 << wIn);
+	for(size_t i=0; i<t.size(); i++)
+		t[i] = (uint64_t)floor((pow(2.0, i / double(1 << wIn)) - 1) * (1 << wOut));
+	BOOST_CHECK_EQUAL(checkDecomposition(t, wIn, wOut), TableCompression::differential);
+}
+
+
+// Bit 0 is constant 1, bit 5 copies bit 1, bits 6 and 7 are constant 0
+BOOST_AUTO_TEST_CASE(TEST_ConstantAndCopiedColumns)
+{
+	mt19937_64 g(1);
+	int wIn=6, wOut=8;
+	vector<uint64_t> t(1 << wIn);
+	for(size_t i=0; i<t.size(); i++) {
+		uint64_t r = g() & 0xF;
+		t[i] = 1 | (r << 1) | ((r & 1) << 5);
+	}
+	vector<int> columns = TableCompression::sharedColumns(t, wOut);
+	vector<int> expected = {-2, 1, 2, 3, 4, 1, -1, -1};
+	BOOST_CHECK(columns == expected);
+	BOOST_CHECK(rebuildColumns(t, wOut) == t);
+	checkDecomposition(t, wIn, wOut);
+}
+
+
+// Various tables, whatever their decomposition
+BOOST_AUTO_TEST_CASE(TEST_Exactness)
+{
+	mt19937_64 g(2);
+	for(int wIn=2; wIn<=12; wIn+=2) {
+		int wOut = wIn+2;
+		vector<uint64_t> exp2(1 << wIn), random(1 << wIn), sine(1 << wIn), kcm(1 << wIn);
+		for(size_t i=0; i<exp2.size(); i++) {
+			double x = i / double(1 << wIn);
+			exp2[i] = (uint64_t)floor((pow(2.0, x) - 1) * (1 << wOut));
+			random[i] = g() & ((uint64_t(1) << wOut) - 1);
+			sine[i] = (uint64_t)floor(sin(x) * (1 << wOut));
+			kcm[i] = i * 37;
+		}
+		checkDecomposition(exp2, wIn, wOut);
+		checkDecomposition(random, wIn, wOut);
+		checkDecomposition(sine, wIn, wOut);
+		checkDecomposition(kcm, wIn, wIn+6);
+	}
+	vector<uint64_t> wide(16);
+	for(size_t i=0; i<wide.size(); i++)
+		wide[i] = ~uint64_t(0) - i;
+	checkDecomposition(wide, 4, 64);
+}
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""Converts a FloPoCo test.input file between the text and hex formats.
+
+The text format (TestBench format=text) has two lines per test: the inputs as
+binary strings, then for each output the number of possible values followed by
+these values in binary.
+The hex format (TestBench format=hex) starts with a header of '#' lines that
+gives the IO order and widths, followed by one line per test with the same
+fields in hexadecimal.
+
+Usage:
+  convert_test_input.py tohex  test.input test.hex  [--inputs X:34,Y:34 --outputs R:34]
+  convert_test_input.py totext test.hex   test.input
+The names in tohex are only used for the header, the widths are deduced from the file.
+"""
+
+import argparse
+import sys
+
+
+def parse_io(spec):
+    """'X:34,Y:34' -> [('X', 34), ('Y', 34)]"""
+    if not spec:
+        return None
+    result = []
+    for field in spec.split(","):
+        name, width = field.split(":")
+        result.append((name, int(width)))
+    return result
+
+
+def parse_outputs(fields, n_outputs=None):
+    """Splits the fields of an output line into a list of lists of values"""
+    groups = []
+    i = 0
+    while i < len(fields) and (n_outputs is None or len(groups) < n_outputs):
+        count = int(fields[i])
+        groups.append(fields[i+1:i+1+count])
+        i += 1 + count
+    return groups
+
+
+def hex_digits(width):
+    return (width + 3) // 4
+
+
+def to_hex(src, dst, inputs, outputs):
+    header_written = False
+    while True:
+        in_line = src.readline()
+        out_line = src.readline()
+        if not in_line:
+            break
+        in_fields = in_line.split()
+        out_groups = parse_outputs(out_line.split())
+        if not header_written:
+            if inputs is None:
+                inputs = [("in%d" % i, len(f)) for i, f in enumerate(in_fields)]
+            if outputs is None:
+                outputs = [("out%d" % i, len(g[0]) if g else 0) for i, g in enumerate(out_groups)]
+            dst.write("# FloPoCo test vectors, hex format: one line per test, with the inputs, "
+                      "then for each output the number of possible values followed by these values\n")
+            dst.write("# inputs:" + "".join(" %s:%d" % io for io in inputs) + "\n")
+            dst.write("# outputs:" + "".join(" %s:%d" % io for io in outputs) + "\n")
+            header_written = True
+        line = []
+        for (name, width), f in zip(inputs, in_fields):
+            line.append("%0*x" % (hex_digits(width), int(f, 2)))
+        for (name, width), g in zip(outputs, out_groups):
+            line.append(str(len(g)))
+            line.extend("%0*x" % (hex_digits(width), int(v, 2)) for v in g)
+        dst.write(" ".join(line) + " \n")
+
+
+def to_text(src, dst):
+    inputs = outputs = None
+    for line in src:
+        if line.startswith("#"):
+            if line.startswith("# inputs:"):
+                inputs = parse_io(",".join(line[len("# inputs:"):].split()))
+            elif line.startswith("# outputs:"):
+                outputs = parse_io(",".join(line[len("# outputs:"):].split()))
+            continue
+        if inputs is None or outputs is None:
+            sys.exit("Error: no IO description found in the header of the hex file")
+        fields = line.split()
+        in_fields = fields[:len(inputs)]
+        out_groups = parse_outputs(fields[len(inputs):], len(outputs))
+        dst.write("".join("{:0{w}b} ".format(int(f, 16), w=width)
+                          for (name, width), f in zip(inputs, in_fields)) + "\n")
+        out = ""
+        for (name, width), g in zip(outputs, out_groups):
+            out += "%d " % len(g)
+            out += "".join("{:0{w}b} ".format(int(v, 16), w=width) for v in g)
+        dst.write(out + "\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Converts a FloPoCo test.input file between the text and hex formats")
+    parser.add_argument("direction", choices=["tohex", "totext"])
+    parser.add_argument("src")
+    parser.add_argument("dst")
+    parser.add_argument("--inputs", help="names and widths of the inputs, e.g. X:34,Y:34 (tohex only)")
+    parser.add_argument("--outputs", help="names and widths of the outputs, e.g. R:34 (tohex only)")
+    args = parser.parse_args()
+    with open(args.src) as src, open(args.dst, "w") as dst:
+        if args.direction == "tohex":
+            to_hex(src, dst, parse_io(args.inputs), parse_io(args.outputs))
+        else:
+            to_text(src, dst)
+
+
+if __name__ == "__main__":
+    main()